@@ -0,0 +1,711 @@
+// Offline analysis of the self-healing timeline in pcap/pcapng captures.
+//
+// GOOSE frames are decoded by the library (observer GooseSubscriber fed with
+// GooseReceiver_handleMessage), the HTTP /validate and /bookKeeping exchanges of
+// the IEDs with the gateway are taken from the TCP segments. Both are correlated
+// with the stNum transitions of the acting IED (IPP by default):
+//
+//   trigger     stNum transition of another publisher (e.g. RDSO)
+//   action      next stNum transition of the acting IED
+//   validation  POST /validate after the action and its response
+//   correction  stNum transition of the acting IED after an invalid response
+//
+// Every event is written as one CSV line (times in seconds, the columns of
+// Captures/IPP_NAT/data.csv plus the event identification) and added to the
+// latency histograms. Several captures (e.g. the interface and the loopback
+// capture of one host) are merged by timestamp. The input is read in a single
+// pass and the memory use does not depend on the capture size.
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "goose_receiver.h"
+#include "goose_subscriber.h"
+#include "pcap_reader.h"
+#include "latency_metrics.h"
+
+#define MAX_CAPTURES 16
+#define MAX_CONNECTIONS 64
+#define MAX_PUBLISHERS 64
+#define GOCB_REF_SIZE 130
+
+#define DEFAULT_ACTOR "IPP/LLN0$GO$gcbAnalogValues"
+
+// An event without a new action is closed after this capture time
+#define EVENT_TIMEOUT_NS (30 * 1000000000ULL)
+
+// A trigger older than this is not related to the next action
+#define TRIGGER_WINDOW_NS (5 * 1000000000ULL)
+
+#define PCAP_LINKTYPE_LINUX_SLL 113
+
+#define ETHERTYPE_IPV4 0x0800
+#define ETHERTYPE_IPV6 0x86dd
+#define ETHERTYPE_VLAN 0x8100
+#define IP_PROTOCOL_TCP 6
+
+typedef enum
+{
+    REQUEST_NONE,
+    REQUEST_VALIDATE,
+    REQUEST_BOOKKEEPING
+} RequestKind;
+
+// TCP connection with an outstanding request, the client side is stored
+typedef struct
+{
+    bool used;
+    uint8_t client[18]; // address (16) and port (2)
+    uint8_t server[18];
+    RequestKind request;
+    uint64_t requestTime;
+    bool awaitingValidity; // validate response seen, body not yet
+    uint64_t lastSeen;
+} HttpConnection;
+
+// Last stNum per GOOSE control block
+typedef struct
+{
+    char gocbRef[GOCB_REF_SIZE];
+    uint32_t stNum;
+} PublisherState;
+
+typedef struct
+{
+    bool active;
+    uint64_t triggerTime; // 0 = no trigger seen
+    char trigger[GOCB_REF_SIZE];
+    uint32_t triggerStNum;
+    uint64_t actionTime;
+    uint32_t actionStNum;
+    uint64_t validateRequest;
+    uint64_t validateResponse;
+    int isValid; // -1 = unknown
+    uint64_t correctionTime;
+    uint64_t bookKeeping; // duration of the first bookkeeping exchange of the event
+} HealingEvent;
+
+typedef struct
+{
+    const char *actor;
+    FILE *csv;
+
+    GooseReceiver receiver;
+    uint64_t packetTime; // capture time of the frame given to the receiver
+
+    PublisherState publishers[MAX_PUBLISHERS];
+    int publisherCount;
+
+    HttpConnection connections[MAX_CONNECTIONS];
+
+    uint64_t pendingTriggerTime;
+    char pendingTrigger[GOCB_REF_SIZE];
+    uint32_t pendingTriggerStNum;
+
+    HealingEvent event;
+
+    Metrics metrics;
+    int stageReaction, stageActionToValidation, stageValidation, stageProjectedDowntime;
+    int stageCorrectiveAction, stageTotalDowntime, stageBookKeeping;
+
+    uint64_t packets;
+    uint64_t gooseFrames;
+    uint64_t transitions;
+    uint64_t exchanges;
+    uint64_t events;
+} Analyser;
+
+static uint16_t get16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static double seconds(uint64_t ns)
+{
+    return ns / 1e9;
+}
+
+static void write_time(FILE *file, uint64_t start, uint64_t end)
+{
+    if (start && end >= start)
+        fprintf(file, ",%.9f", seconds(end - start));
+    else
+        fputs(",", file);
+}
+
+static void finish_event(Analyser *self)
+{
+    HealingEvent *event = &self->event;
+
+    if (event->active == false)
+        return;
+
+    event->active = false;
+    self->events++;
+
+    if (event->triggerTime)
+        metrics_record(self->metrics, self->stageReaction, event->actionTime - event->triggerTime);
+
+    if (event->validateRequest)
+        metrics_record(self->metrics, self->stageActionToValidation, event->validateRequest - event->actionTime);
+
+    if (event->validateResponse)
+    {
+        metrics_record(self->metrics, self->stageValidation, event->validateResponse - event->validateRequest);
+        metrics_record(self->metrics, self->stageProjectedDowntime, event->validateResponse - event->actionTime);
+    }
+
+    if (event->correctionTime)
+    {
+        metrics_record(self->metrics, self->stageCorrectiveAction, event->correctionTime - event->validateResponse);
+        metrics_record(self->metrics, self->stageTotalDowntime, event->correctionTime - event->actionTime);
+    }
+
+    FILE *csv = self->csv;
+
+    fprintf(csv, "%.9f,%s,", seconds(event->actionTime), event->triggerTime ? event->trigger : "");
+
+    if (event->triggerTime)
+        fprintf(csv, "%u", event->triggerStNum);
+
+    fprintf(csv, ",%u,%s", event->actionStNum, event->isValid < 0 ? "" : (event->isValid ? "true" : "false"));
+
+    write_time(csv, event->triggerTime, event->actionTime);
+
+    if (event->bookKeeping)
+        fprintf(csv, ",%.9f", seconds(event->bookKeeping));
+    else
+        fputs(",", csv);
+
+    write_time(csv, event->validateRequest, event->validateResponse);
+    write_time(csv, event->actionTime, event->validateRequest);
+
+    // A valid action needs no correction, 0 as in data.csv
+    if (event->isValid == 1)
+        fputs(",0", csv);
+    else
+        write_time(csv, event->validateResponse, event->correctionTime);
+
+    write_time(csv, event->actionTime, event->validateResponse);
+
+    if (event->isValid == 1)
+        fputs(",0", csv);
+    else
+        write_time(csv, event->actionTime, event->correctionTime);
+
+    fputc('\n', csv);
+}
+
+static void on_transition(Analyser *self, const char *gocbRef, uint32_t stNum, uint64_t time)
+{
+    HealingEvent *event = &self->event;
+
+    self->transitions++;
+
+    if (strcmp(gocbRef, self->actor) != 0)
+    {
+        // the latest state change of another IED triggers the next action
+        self->pendingTriggerTime = time;
+        strcpy(self->pendingTrigger, gocbRef);
+        self->pendingTriggerStNum = stNum;
+        return;
+    }
+
+    // state change after an invalid validation response is the correction
+    if (event->active && event->isValid == 0 && event->correctionTime == 0)
+    {
+        event->correctionTime = time;
+        finish_event(self);
+        return;
+    }
+
+    finish_event(self);
+
+    memset(event, 0, sizeof(HealingEvent));
+    event->active = true;
+    event->actionTime = time;
+    event->actionStNum = stNum;
+    event->isValid = -1;
+
+    if (self->pendingTriggerTime && time - self->pendingTriggerTime <= TRIGGER_WINDOW_NS)
+    {
+        event->triggerTime = self->pendingTriggerTime;
+        strcpy(event->trigger, self->pendingTrigger);
+        event->triggerStNum = self->pendingTriggerStNum;
+    }
+
+    self->pendingTriggerTime = 0;
+}
+
+static void goose_listener(GooseSubscriber subscriber, void *parameter)
+{
+    Analyser *self = (Analyser *)parameter;
+    const char *gocbRef = GooseSubscriber_getGoCbRef(subscriber);
+    uint32_t stNum = GooseSubscriber_getStNum(subscriber);
+
+    self->gooseFrames++;
+
+    for (int i = 0; i < self->publisherCount; i++)
+    {
+        PublisherState *publisher = &self->publishers[i];
+
+        if (strcmp(publisher->gocbRef, gocbRef) == 0)
+        {
+            if (publisher->stNum != stNum)
+            {
+                publisher->stNum = stNum;
+                on_transition(self, gocbRef, stNum, self->packetTime);
+            }
+
+            return;
+        }
+    }
+
+    // The first frame of a publisher shows its state, not a state change
+    if (self->publisherCount < MAX_PUBLISHERS)
+    {
+        PublisherState *publisher = &self->publishers[self->publisherCount++];
+
+        strncpy(publisher->gocbRef, gocbRef, GOCB_REF_SIZE - 1);
+        publisher->stNum = stNum;
+    }
+}
+
+// Connection of the client and server endpoints, oldest entry is reused
+static HttpConnection *find_connection(Analyser *self, const uint8_t *client, const uint8_t *server, bool create,
+                                       uint64_t time)
+{
+    HttpConnection *oldest = &self->connections[0];
+
+    for (int i = 0; i < MAX_CONNECTIONS; i++)
+    {
+        HttpConnection *connection = &self->connections[i];
+
+        if (connection->used && memcmp(connection->client, client, 18) == 0 &&
+            memcmp(connection->server, server, 18) == 0)
+        {
+            connection->lastSeen = time;
+            return connection;
+        }
+
+        if (connection->used == false || connection->lastSeen < oldest->lastSeen)
+            oldest = connection;
+    }
+
+    if (create == false)
+        return NULL;
+
+    memset(oldest, 0, sizeof(HttpConnection));
+    oldest->used = true;
+    memcpy(oldest->client, client, 18);
+    memcpy(oldest->server, server, 18);
+    oldest->lastSeen = time;
+
+    return oldest;
+}
+
+// -1 = not in this segment
+static int find_validity(const uint8_t *payload, int length)
+{
+    static const char key[] = "\"isValid\"";
+
+    for (int i = 0; i + (int)sizeof(key) - 1 <= length; i++)
+    {
+        if (memcmp(payload + i, key, sizeof(key) - 1) != 0)
+            continue;
+
+        int pos = i + sizeof(key) - 1;
+
+        while (pos < length && (payload[pos] == ' ' || payload[pos] == ':'))
+            pos++;
+
+        if (pos + 4 <= length && memcmp(payload + pos, "true", 4) == 0)
+            return 1;
+
+        if (pos + 5 <= length && memcmp(payload + pos, "false", 5) == 0)
+            return 0;
+
+        return -1;
+    }
+
+    return -1;
+}
+
+static void on_validate_response(Analyser *self, uint64_t requestTime, uint64_t time)
+{
+    HealingEvent *event = &self->event;
+
+    if (event->active && event->validateRequest == requestTime && event->validateResponse == 0)
+        event->validateResponse = time;
+}
+
+static void on_validity(Analyser *self, int isValid)
+{
+    HealingEvent *event = &self->event;
+
+    if (event->active && event->validateResponse && event->isValid < 0)
+        event->isValid = isValid;
+}
+
+static void handle_tcp(Analyser *self, const uint8_t *source, const uint8_t *destination, const uint8_t *segment,
+                       int length, uint64_t time)
+{
+    if (length < 20)
+        return;
+
+    int headerLength = (segment[12] >> 4) * 4;
+
+    if (headerLength < 20 || headerLength > length)
+        return;
+
+    const uint8_t *payload = segment + headerLength;
+    int payloadLength = length - headerLength;
+
+    if (payloadLength == 0)
+        return;
+
+    uint8_t sourceEndpoint[18], destinationEndpoint[18];
+
+    memcpy(sourceEndpoint, source, 16);
+    memcpy(sourceEndpoint + 16, segment, 2);
+    memcpy(destinationEndpoint, destination, 16);
+    memcpy(destinationEndpoint + 16, segment + 2, 2);
+
+    if (payloadLength > 5 && memcmp(payload, "POST ", 5) == 0)
+    {
+        RequestKind kind = REQUEST_NONE;
+
+        if (payloadLength >= 15 && memcmp(payload + 5, "/validate ", 10) == 0)
+            kind = REQUEST_VALIDATE;
+        else if (payloadLength >= 18 && memcmp(payload + 5, "/bookKeeping ", 13) == 0)
+            kind = REQUEST_BOOKKEEPING;
+
+        if (kind == REQUEST_NONE)
+            return;
+
+        HttpConnection *connection = find_connection(self, sourceEndpoint, destinationEndpoint, true, time);
+
+        connection->request = kind;
+        connection->requestTime = time;
+        connection->awaitingValidity = false;
+
+        HealingEvent *event = &self->event;
+
+        if (kind == REQUEST_VALIDATE && event->active && event->validateRequest == 0)
+            event->validateRequest = time;
+
+        return;
+    }
+
+    // responses travel from the server to the client
+    HttpConnection *connection = find_connection(self, destinationEndpoint, sourceEndpoint, false, time);
+
+    if (connection == NULL)
+        return;
+
+    if (payloadLength > 7 && memcmp(payload, "HTTP/1.", 7) == 0 && connection->request != REQUEST_NONE)
+    {
+        uint64_t duration = time - connection->requestTime;
+
+        self->exchanges++;
+
+        if (connection->request == REQUEST_BOOKKEEPING)
+        {
+            HealingEvent *event = &self->event;
+
+            metrics_record(self->metrics, self->stageBookKeeping, duration);
+
+            // the first bookkeeping after the action (the IEDs send it after the validation)
+            if (event->active && event->bookKeeping == 0 && connection->requestTime >= event->actionTime)
+                event->bookKeeping = duration;
+        }
+        else
+        {
+            on_validate_response(self, connection->requestTime, time);
+            connection->awaitingValidity = true;
+        }
+
+        connection->request = REQUEST_NONE;
+    }
+
+    // the response body can follow in a later segment
+    if (connection->awaitingValidity)
+    {
+        int isValid = find_validity(payload, payloadLength);
+
+        if (isValid >= 0)
+        {
+            on_validity(self, isValid);
+            connection->awaitingValidity = false;
+        }
+    }
+}
+
+static void handle_ip(Analyser *self, const uint8_t *packet, int length, uint16_t etherType, uint64_t time)
+{
+    // addresses are stored as 16 bytes, IPv4 zero padded
+    uint8_t source[16] = {0}, destination[16] = {0};
+
+    if (etherType == ETHERTYPE_IPV4)
+    {
+        if (length < 20 || (packet[0] >> 4) != 4 || packet[9] != IP_PROTOCOL_TCP)
+            return;
+
+        int headerLength = (packet[0] & 0x0f) * 4;
+        int totalLength = get16(packet + 2);
+
+        // fragments are not reassembled
+        if ((get16(packet + 6) & 0x3fff) != 0)
+            return;
+
+        if (totalLength < headerLength || totalLength > length)
+            totalLength = length;
+
+        if (headerLength < 20 || headerLength > totalLength)
+            return;
+
+        memcpy(source, packet + 12, 4);
+        memcpy(destination, packet + 16, 4);
+
+        handle_tcp(self, source, destination, packet + headerLength, totalLength - headerLength, time);
+    }
+    else if (etherType == ETHERTYPE_IPV6)
+    {
+        // extension headers are not followed
+        if (length < 40 || (packet[0] >> 4) != 6 || packet[6] != IP_PROTOCOL_TCP)
+            return;
+
+        int payloadLength = get16(packet + 4);
+
+        if (40 + payloadLength > length)
+            payloadLength = length - 40;
+
+        memcpy(source, packet + 8, 16);
+        memcpy(destination, packet + 24, 16);
+
+        handle_tcp(self, source, destination, packet + 40, payloadLength, time);
+    }
+}
+
+static void handle_packet(Analyser *self, const PcapPacket *packet)
+{
+    const uint8_t *data = packet->data;
+    int length = (int)packet->length;
+    int pos;
+    uint16_t etherType;
+
+    self->packets++;
+
+    if (packet->linkType == PCAP_LINKTYPE_ETHERNET)
+    {
+        if (length < 14)
+            return;
+
+        pos = 12;
+        etherType = get16(data + pos);
+
+        if (etherType == ETHERTYPE_VLAN && length >= 18)
+        {
+            pos = 16;
+            etherType = get16(data + pos);
+        }
+
+        pos += 2;
+    }
+    else if (packet->linkType == PCAP_LINKTYPE_LINUX_SLL)
+    {
+        if (length < 16)
+            return;
+
+        etherType = get16(data + 14);
+        pos = 16;
+    }
+    else
+        return;
+
+    if (etherType == ETHERTYPE_IPV4 || etherType == ETHERTYPE_IPV6)
+        handle_ip(self, data + pos, length - pos, etherType, packet->timestampNs);
+    else if (packet->linkType == PCAP_LINKTYPE_ETHERNET)
+    {
+        // GOOSE and everything else the library knows about, the receiver ignores the rest
+        self->packetTime = packet->timestampNs;
+        GooseReceiver_handleMessage(self->receiver, (uint8_t *)data, length);
+    }
+
+    if (self->event.active && packet->timestampNs > self->event.actionTime + EVENT_TIMEOUT_NS)
+        finish_event(self);
+}
+
+static void print_stage(Metrics metrics, int stage)
+{
+    MetricsSummary summary;
+
+    if (metrics_get_summary(metrics, stage, &summary) == false || summary.count == 0)
+        return;
+
+    fprintf(stderr, "%-20s %6llu  p50 %10.3f ms  p99 %10.3f ms  p99.9 %10.3f ms  max %10.3f ms\n",
+            metrics_get_stage_name(metrics, stage), (unsigned long long)summary.count, summary.p50 / 1e6,
+            summary.p99 / 1e6, summary.p999 / 1e6, summary.max / 1e6);
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [options] capture.pcap[ng]...\n"
+            "  -a <gocbRef>  GOOSE control block of the acting IED (default %s)\n"
+            "  -o <file>     write the CSV to a file instead of stdout\n"
+            "  -j <target>   write the histograms as JSON (file:<path> or udp:<address>:<port>)\n"
+            "Several captures (e.g. interface and loopback of one host) are merged by time.\n",
+            name, DEFAULT_ACTOR);
+}
+
+int main(int argc, char **argv)
+{
+    static Analyser analyser;
+    const char *csvPath = NULL;
+    const char *jsonTarget = NULL;
+    int opt;
+
+    analyser.actor = DEFAULT_ACTOR;
+
+    while ((opt = getopt(argc, argv, "a:o:j:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'a':
+            analyser.actor = optarg;
+            break;
+        case 'o':
+            csvPath = optarg;
+            break;
+        case 'j':
+            jsonTarget = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    int captureCount = argc - optind;
+
+    if (captureCount < 1 || captureCount > MAX_CAPTURES)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    PcapReader readers[MAX_CAPTURES];
+    PcapPacket packets[MAX_CAPTURES];
+    bool pending[MAX_CAPTURES];
+
+    for (int i = 0; i < captureCount; i++)
+    {
+        readers[i] = pcap_reader_open(argv[optind + i]);
+
+        if (readers[i] == NULL)
+        {
+            fprintf(stderr, "Cannot read capture %s\n", argv[optind + i]);
+
+            while (i-- > 0)
+                pcap_reader_close(readers[i]);
+
+            return EXIT_FAILURE;
+        }
+
+        pending[i] = pcap_reader_next(readers[i], &packets[i]);
+    }
+
+    analyser.csv = csvPath ? fopen(csvPath, "w") : stdout;
+
+    if (analyser.csv == NULL)
+    {
+        fprintf(stderr, "Cannot write %s\n", csvPath);
+        return EXIT_FAILURE;
+    }
+
+    analyser.metrics = metrics_create();
+    analyser.stageReaction = metrics_add_stage(analyser.metrics, "reaction");
+    analyser.stageActionToValidation = metrics_add_stage(analyser.metrics, "actionToValidation");
+    analyser.stageValidation = metrics_add_stage(analyser.metrics, "validation");
+    analyser.stageProjectedDowntime = metrics_add_stage(analyser.metrics, "projectedDowntime");
+    analyser.stageCorrectiveAction = metrics_add_stage(analyser.metrics, "correctiveAction");
+    analyser.stageTotalDowntime = metrics_add_stage(analyser.metrics, "totalDowntime");
+    analyser.stageBookKeeping = metrics_add_stage(analyser.metrics, "bookKeeping");
+
+    // Observer: all GOOSE messages are decoded, whatever their control block
+    analyser.receiver = GooseReceiver_create();
+
+    GooseSubscriber observer = GooseSubscriber_create("", NULL);
+    GooseSubscriber_setObserver(observer);
+    GooseSubscriber_setListener(observer, goose_listener, &analyser);
+    GooseReceiver_addSubscriber(analyser.receiver, observer);
+
+    fprintf(analyser.csv, "eventTime,trigger,triggerStNum,actionStNum,isValid,reactionTime,bookKeepingTime,"
+                          "validationTime,actionToValidationTime,correctiveActionTime,projectedDowntime,totalDowntime\n");
+
+    // Merge: always the oldest pending packet of all captures
+    while (true)
+    {
+        int next = -1;
+
+        for (int i = 0; i < captureCount; i++)
+        {
+            if (pending[i] && (next < 0 || packets[i].timestampNs < packets[next].timestampNs))
+                next = i;
+        }
+
+        if (next < 0)
+            break;
+
+        handle_packet(&analyser, &packets[next]);
+
+        pending[next] = pcap_reader_next(readers[next], &packets[next]);
+    }
+
+    finish_event(&analyser);
+
+    int result = EXIT_SUCCESS;
+
+    for (int i = 0; i < captureCount; i++)
+    {
+        const char *error = pcap_reader_error(readers[i]);
+
+        if (error)
+        {
+            fprintf(stderr, "%s: %s at byte %llu\n", argv[optind + i], error,
+                    (unsigned long long)pcap_reader_position(readers[i]));
+            result = EXIT_FAILURE;
+        }
+
+        pcap_reader_close(readers[i]);
+    }
+
+    fprintf(stderr, "%llu packets, %llu GOOSE frames, %llu state changes, %llu HTTP exchanges, %llu events\n",
+            (unsigned long long)analyser.packets, (unsigned long long)analyser.gooseFrames,
+            (unsigned long long)analyser.transitions, (unsigned long long)analyser.exchanges,
+            (unsigned long long)analyser.events);
+
+    for (int i = 0; i < metrics_get_stage_count(analyser.metrics); i++)
+        print_stage(analyser.metrics, i);
+
+    // The exporter writes a final snapshot when it is stopped
+    if (jsonTarget)
+    {
+        if (metrics_start_exporter(analyser.metrics, jsonTarget, 3600 * 1000))
+            metrics_stop_exporter(analyser.metrics);
+        else
+            fprintf(stderr, "Cannot export to %s\n", jsonTarget);
+    }
+
+    if (csvPath)
+        fclose(analyser.csv);
+
+    GooseReceiver_destroy(analyser.receiver);
+    metrics_destroy(analyser.metrics);
+
+    return result;
+}
@@ -0,0 +1,794 @@
+// Replays the GOOSE frames of pcap/pcapng captures as load for GOOSE receivers.
+//
+// The frames go into a GooseReceiver of this process (GooseReceiver_handleMessage),
+// out of a network interface (e.g. one end of a veth pair) or into a TAP device,
+// where they are received by the IEDs like frames from the wire.
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <linux/if_tun.h>
+
+#include "goose_receiver.h"
+#include "goose_subscriber.h"
+#include "hal_ethernet.h"
+#include "hal_thread.h"
+#include "hal_time.h"
+#include "pcap_reader.h"
+#include "latency_metrics.h"
+
+#define ETHERTYPE_GOOSE 0x88b8
+#define ETHERTYPE_VLAN 0x8100
+
+#define MAX_CAPTURED_PUBLISHERS 64
+#define MAX_COPIES 1024
+#define MAX_FRAME_SIZE 1518
+#define GOCB_REF_SIZE 130
+
+#define SEND_RING_FRAMES 256
+
+typedef enum
+{
+    OUTPUT_IN_PROCESS,
+    OUTPUT_INTERFACE,
+    OUTPUT_TAP
+} OutputMode;
+
+typedef struct
+{
+    OutputMode output;
+    const char *device; // interface or TAP name
+    double speed;       // 1 = original timing, 0 = maximum rate
+    int loops;          // 0 = until SIGINT
+    int copies;         // synthetic publishers per captured publisher
+    int appId;          // APPID of the first copy, -1 = APPID of the capture
+    bool setDstMac;
+    uint8_t dstMac[6];
+    bool setSrcMac;
+    uint8_t srcMac[6];
+    bool renumber; // continuous stNum/sqNum per synthetic publisher
+    bool retime;   // t = replay time of the state change
+} ReplayOptions;
+
+// State of one synthetic publisher
+typedef struct
+{
+    uint32_t stNum;
+    uint32_t sqNum;
+    uint8_t t[8];
+    GooseSubscriber subscriber; // in-process output only
+} PublisherCopy;
+
+// Publisher found in the capture, identified by source MAC, APPID and control block
+typedef struct
+{
+    uint8_t srcMac[6];
+    uint16_t appId;
+    char gocbRef[GOCB_REF_SIZE];
+    bool hasStNum;
+    uint32_t lastStNum;
+    PublisherCopy *copies;
+} CapturedPublisher;
+
+// Positions of the fields of a captured GOOSE frame
+typedef struct
+{
+    int etherTypePos;
+    uint16_t appId;
+    int pduStart; // first element of the goosePdu
+    int pduEnd;
+    char gocbRef[GOCB_REF_SIZE];
+    bool hasStNum;
+    uint32_t stNum;
+} GooseFrameInfo;
+
+typedef struct
+{
+    ReplayOptions options;
+
+    CapturedPublisher publishers[MAX_CAPTURED_PUBLISHERS];
+    int publisherCount;
+
+    GooseReceiver receiver;
+    EthernetSocket socket;
+    int tapFd;
+
+    Metrics metrics;
+    int stageSend, stageLateness;
+
+    uint64_t frames;
+    uint64_t bytes;
+    uint64_t sendErrors;
+    uint64_t skipped; // not GOOSE or not decodable
+    uint64_t callbacks;
+} Replay;
+
+static volatile bool running = true;
+
+static void sigint_handler(int signalId)
+{
+    running = false;
+}
+
+static int ber_decode_tl(const uint8_t *buffer, int pos, int end, uint8_t *tag, int *length)
+{
+    if (pos + 2 > end)
+        return -1;
+
+    *tag = buffer[pos++];
+
+    int first = buffer[pos++];
+
+    if (first < 0x80)
+        *length = first;
+    else
+    {
+        int bytes = first & 0x7f;
+
+        if (bytes == 0 || bytes > 2 || pos + bytes > end)
+            return -1;
+
+        *length = 0;
+
+        for (int i = 0; i < bytes; i++)
+            *length = (*length << 8) | buffer[pos++];
+    }
+
+    if (pos + *length > end)
+        return -1;
+
+    return pos;
+}
+
+static int ber_encode_length(uint8_t *buffer, int length)
+{
+    if (length < 0x80)
+    {
+        buffer[0] = (uint8_t)length;
+        return 1;
+    }
+
+    if (length < 0x100)
+    {
+        buffer[0] = 0x81;
+        buffer[1] = (uint8_t)length;
+        return 2;
+    }
+
+    buffer[0] = 0x82;
+    buffer[1] = (uint8_t)(length >> 8);
+    buffer[2] = (uint8_t)length;
+    return 3;
+}
+
+// Minimal unsigned INTEGER, a leading zero byte keeps the sign bit clear
+static int ber_encode_uint32(uint8_t *buffer, uint8_t tag, uint32_t value)
+{
+    uint8_t bytes[5];
+    int size = 0;
+
+    do
+    {
+        bytes[4 - size++] = (uint8_t)value;
+        value >>= 8;
+    } while (value);
+
+    if (bytes[5 - size] & 0x80)
+        bytes[4 - size++] = 0;
+
+    buffer[0] = tag;
+    buffer[1] = (uint8_t)size;
+    memcpy(buffer + 2, bytes + 5 - size, size);
+
+    return 2 + size;
+}
+
+// IEC 61850 UtcTime, as GoosePublisher_setTimestampNs
+static void encode_utc_time(uint8_t *buffer, uint64_t timestampNs)
+{
+    uint32_t seconds = (uint32_t)(timestampNs / 1000000000ULL);
+    uint32_t fraction = (uint32_t)(((timestampNs % 1000000000ULL) << 24) / 1000000000ULL);
+
+    buffer[0] = (uint8_t)(seconds >> 24);
+    buffer[1] = (uint8_t)(seconds >> 16);
+    buffer[2] = (uint8_t)(seconds >> 8);
+    buffer[3] = (uint8_t)seconds;
+    buffer[4] = (uint8_t)(fraction >> 16);
+    buffer[5] = (uint8_t)(fraction >> 8);
+    buffer[6] = (uint8_t)fraction;
+    buffer[7] = 0x0a;
+}
+
+static bool parse_goose_frame(const uint8_t *frame, int length, GooseFrameInfo *info)
+{
+    int pos = 12;
+
+    if (length < 14)
+        return false;
+
+    if (((frame[12] << 8) | frame[13]) == ETHERTYPE_VLAN)
+        pos = 16;
+
+    // EtherType, APPID, length, reserved 1 and 2
+    if (pos + 10 > length || ((frame[pos] << 8) | frame[pos + 1]) != ETHERTYPE_GOOSE)
+        return false;
+
+    info->etherTypePos = pos;
+    info->appId = (uint16_t)((frame[pos + 2] << 8) | frame[pos + 3]);
+
+    int end = pos + 2 + ((frame[pos + 4] << 8) | frame[pos + 5]);
+
+    if (end > length)
+        end = length;
+
+    uint8_t tag;
+    int pduLength;
+
+    pos = ber_decode_tl(frame, pos + 10, end, &tag, &pduLength);
+
+    if (pos < 0 || tag != 0x61)
+        return false;
+
+    info->pduStart = pos;
+    info->pduEnd = pos + pduLength;
+    info->gocbRef[0] = 0;
+    info->hasStNum = false;
+
+    while (pos < info->pduEnd)
+    {
+        int elementLength;
+        int valuePos = ber_decode_tl(frame, pos, info->pduEnd, &tag, &elementLength);
+
+        if (valuePos < 0)
+            return false;
+
+        if (tag == 0x80 && elementLength < GOCB_REF_SIZE)
+        {
+            memcpy(info->gocbRef, frame + valuePos, elementLength);
+            info->gocbRef[elementLength] = 0;
+        }
+        else if (tag == 0x85 && elementLength <= 5)
+        {
+            info->stNum = 0;
+
+            for (int i = 0; i < elementLength; i++)
+                info->stNum = (info->stNum << 8) | frame[valuePos + i];
+
+            info->hasStNum = true;
+        }
+
+        pos = valuePos + elementLength;
+    }
+
+    return (info->gocbRef[0] != 0);
+}
+
+// Copy of the captured frame with the fields of the synthetic publisher
+static int build_frame(const ReplayOptions *options, const uint8_t *frame, const GooseFrameInfo *info,
+                       int copyIndex, const PublisherCopy *copy, uint8_t *out)
+{
+    uint8_t content[MAX_FRAME_SIZE];
+    int contentLength = 0;
+    int pos = info->pduStart;
+
+    while (pos < info->pduEnd)
+    {
+        uint8_t tag;
+        int elementLength;
+        int valuePos = ber_decode_tl(frame, pos, info->pduEnd, &tag, &elementLength);
+
+        // parse_goose_frame has checked the elements already
+        int next = valuePos + elementLength;
+
+        if (contentLength + (next - pos) + 7 > MAX_FRAME_SIZE)
+            return -1;
+
+        if (tag == 0x84 && elementLength == 8 && options->retime)
+        {
+            content[contentLength++] = 0x84;
+            content[contentLength++] = 8;
+            memcpy(content + contentLength, copy->t, 8);
+            contentLength += 8;
+        }
+        else if (tag == 0x85 && options->renumber)
+            contentLength += ber_encode_uint32(content + contentLength, 0x85, copy->stNum);
+        else if (tag == 0x86 && options->renumber)
+            contentLength += ber_encode_uint32(content + contentLength, 0x86, copy->sqNum);
+        else
+        {
+            memcpy(content + contentLength, frame + pos, next - pos);
+            contentLength += next - pos;
+        }
+
+        pos = next;
+    }
+
+    // Ethernet header and VLAN tag
+    pos = info->etherTypePos;
+    memcpy(out, frame, pos + 2);
+
+    if (options->setDstMac)
+        memcpy(out, options->dstMac, 6);
+
+    if (options->setSrcMac)
+    {
+        uint16_t suffix = (uint16_t)(((options->srcMac[4] << 8) | options->srcMac[5]) + copyIndex);
+
+        memcpy(out + 6, options->srcMac, 4);
+        out[10] = (uint8_t)(suffix >> 8);
+        out[11] = (uint8_t)suffix;
+    }
+
+    uint16_t appId = (uint16_t)(((options->appId >= 0) ? options->appId : info->appId) + copyIndex);
+
+    out[pos + 2] = (uint8_t)(appId >> 8);
+    out[pos + 3] = (uint8_t)appId;
+    memcpy(out + pos + 6, frame + pos + 6, 4); // reserved 1 and 2
+
+    int lengthPos = pos + 4;
+    pos += 10;
+
+    if (pos + 4 + contentLength > MAX_FRAME_SIZE)
+        return -1;
+
+    out[pos++] = 0x61;
+    pos += ber_encode_length(out + pos, contentLength);
+    memcpy(out + pos, content, contentLength);
+    pos += contentLength;
+
+    // the GOOSE length counts from APPID to the end of the PDU
+    int gooseLength = pos - lengthPos + 2;
+
+    out[lengthPos] = (uint8_t)(gooseLength >> 8);
+    out[lengthPos + 1] = (uint8_t)gooseLength;
+
+    return pos;
+}
+
+static CapturedPublisher *find_publisher(Replay *self, const uint8_t *frame, const GooseFrameInfo *info)
+{
+    for (int i = 0; i < self->publisherCount; i++)
+    {
+        CapturedPublisher *publisher = &self->publishers[i];
+
+        if (publisher->appId == info->appId && memcmp(publisher->srcMac, frame + 6, 6) == 0 &&
+            strcmp(publisher->gocbRef, info->gocbRef) == 0)
+            return publisher;
+    }
+
+    if (self->publisherCount == MAX_CAPTURED_PUBLISHERS)
+        return NULL;
+
+    PublisherCopy *copies = (PublisherCopy *)calloc(self->options.copies, sizeof(PublisherCopy));
+
+    if (copies == NULL)
+        return NULL;
+
+    CapturedPublisher *publisher = &self->publishers[self->publisherCount++];
+
+    memcpy(publisher->srcMac, frame + 6, 6);
+    publisher->appId = info->appId;
+    strcpy(publisher->gocbRef, info->gocbRef);
+    publisher->hasStNum = false;
+    publisher->copies = copies;
+
+    return publisher;
+}
+
+static void goose_listener(GooseSubscriber subscriber, void *parameter)
+{
+    Replay *self = (Replay *)parameter;
+
+    self->callbacks++;
+}
+
+// Subscriber for a synthetic publisher, the in-process receiver ignores frames without one
+static void add_subscriber(Replay *self, PublisherCopy *copy, const GooseFrameInfo *info, int copyIndex)
+{
+    if (self->receiver == NULL || copy->subscriber)
+        return;
+
+    copy->subscriber = GooseSubscriber_create((char *)info->gocbRef, NULL);
+
+    if (copy->subscriber == NULL)
+        return;
+
+    uint16_t appId = (uint16_t)(((self->options.appId >= 0) ? self->options.appId : info->appId) + copyIndex);
+
+    GooseSubscriber_setAppId(copy->subscriber, appId);
+    GooseSubscriber_setListener(copy->subscriber, goose_listener, self);
+    GooseReceiver_addSubscriber(self->receiver, copy->subscriber);
+}
+
+static void send_frame(Replay *self, uint8_t *frame, int length)
+{
+    uint64_t start = metrics_now();
+
+    switch (self->options.output)
+    {
+    case OUTPUT_IN_PROCESS:
+        GooseReceiver_handleMessage(self->receiver, frame, length);
+        break;
+
+    case OUTPUT_INTERFACE:
+        Ethernet_sendPacket(self->socket, frame, length);
+        break;
+
+    case OUTPUT_TAP:
+        if (write(self->tapFd, frame, length) != length)
+            self->sendErrors++;
+        break;
+    }
+
+    metrics_span_end(self->metrics, self->stageSend, start);
+
+    self->frames++;
+    self->bytes += length;
+}
+
+static void replay_frame(Replay *self, const uint8_t *frame, int length)
+{
+    GooseFrameInfo info;
+
+    if (parse_goose_frame(frame, length, &info) == false)
+    {
+        self->skipped++;
+        return;
+    }
+
+    CapturedPublisher *publisher = find_publisher(self, frame, &info);
+
+    if (publisher == NULL)
+    {
+        self->skipped++;
+        return;
+    }
+
+    // a new stNum in the capture is a state change of every copy
+    bool newEvent = (publisher->hasStNum == false) || (info.hasStNum && info.stNum != publisher->lastStNum);
+
+    publisher->hasStNum = info.hasStNum;
+    publisher->lastStNum = info.stNum;
+
+    uint64_t now = self->options.retime ? Hal_getTimeInNs() : 0;
+
+    for (int i = 0; i < self->options.copies && running; i++)
+    {
+        PublisherCopy *copy = &publisher->copies[i];
+        uint8_t out[MAX_FRAME_SIZE];
+
+        if (newEvent)
+        {
+            if (++copy->stNum == 0)
+                copy->stNum = 1;
+
+            copy->sqNum = 0;
+
+            if (self->options.retime)
+                encode_utc_time(copy->t, now);
+        }
+        else if (++copy->sqNum == 0)
+            copy->sqNum = 1;
+
+        int outLength = build_frame(&self->options, frame, &info, i, copy, out);
+
+        if (outLength < 0)
+        {
+            self->skipped++;
+            continue;
+        }
+
+        add_subscriber(self, copy, &info, i);
+        send_frame(self, out, outLength);
+    }
+}
+
+// One pass over the capture, returns false on a read error
+static bool replay_capture(Replay *self, const char *path)
+{
+    PcapReader reader = pcap_reader_open(path);
+
+    if (reader == NULL)
+    {
+        fprintf(stderr, "Cannot read capture %s\n", path);
+        return false;
+    }
+
+    PcapPacket packet;
+    bool first = true;
+    uint64_t captureStart = 0;
+    uint64_t replayStart = Hal_getMonotonicTimeInNs();
+
+    while (running && pcap_reader_next(reader, &packet))
+    {
+        if (packet.linkType != PCAP_LINKTYPE_ETHERNET || packet.length > MAX_FRAME_SIZE)
+        {
+            self->skipped++;
+            continue;
+        }
+
+        // Original gaps divided by the speed factor, absolute deadlines do not drift
+        if (self->options.speed > 0 && packet.timestampNs != 0)
+        {
+            if (first)
+            {
+                captureStart = packet.timestampNs;
+                first = false;
+            }
+
+            uint64_t offset = (packet.timestampNs > captureStart) ? packet.timestampNs - captureStart : 0;
+            uint64_t deadline = replayStart + (uint64_t)(offset / self->options.speed);
+
+            Thread_sleepUntil(deadline);
+
+            uint64_t now = Hal_getMonotonicTimeInNs();
+
+            metrics_record(self->metrics, self->stageLateness, (now > deadline) ? now - deadline : 0);
+        }
+
+        replay_frame(self, packet.data, (int)packet.length);
+    }
+
+    const char *error = pcap_reader_error(reader);
+
+    if (error)
+        fprintf(stderr, "%s: %s at byte %llu\n", path, error, (unsigned long long)pcap_reader_position(reader));
+
+    pcap_reader_close(reader);
+
+    return (error == NULL);
+}
+
+static int tap_open(const char *name)
+{
+    int fd = open("/dev/net/tun", O_RDWR);
+
+    if (fd < 0)
+        return -1;
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    strncpy(ifr.ifr_name, name, IFNAMSIZ - 1);
+
+    if (ioctl(fd, TUNSETIFF, &ifr) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    // Bring the interface up, the receivers bind to it
+    int controlSocket = socket(AF_INET, SOCK_DGRAM, 0);
+
+    if (controlSocket >= 0)
+    {
+        if (ioctl(controlSocket, SIOCGIFFLAGS, &ifr) == 0)
+        {
+            ifr.ifr_flags |= IFF_UP;
+            ioctl(controlSocket, SIOCSIFFLAGS, &ifr);
+        }
+
+        close(controlSocket);
+    }
+
+    return fd;
+}
+
+static bool parse_mac(const char *text, uint8_t *mac)
+{
+    unsigned int bytes[6];
+
+    if (sscanf(text, "%x:%x:%x:%x:%x:%x", &bytes[0], &bytes[1], &bytes[2], &bytes[3], &bytes[4], &bytes[5]) != 6)
+        return false;
+
+    for (int i = 0; i < 6; i++)
+    {
+        if (bytes[i] > 0xff)
+            return false;
+
+        mac[i] = (uint8_t)bytes[i];
+    }
+
+    return true;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [options] capture.pcap[ng]\n"
+            "  -i <interface>  send on a network interface (e.g. one end of a veth pair)\n"
+            "  -T <tap>        write into a TAP device, the frames are received on it\n"
+            "                  (create it with 'ip tuntap add mode tap <tap>' to start the receivers first)\n"
+            "                  (default: in-process GooseReceiver_handleMessage)\n"
+            "  -x <factor>     speed factor of the capture timing (default 1)\n"
+            "  -m              maximum rate, ignore the capture timing\n"
+            "  -l <loops>      number of passes over the capture (default 1, 0 = until Ctrl+C)\n"
+            "  -n <count>      synthetic publishers per captured publisher (default 1)\n"
+            "  -a <appid>      APPID of the first synthetic publisher, the next ones count up\n"
+            "  -d <mac>        destination MAC address\n"
+            "  -s <mac>        source MAC address, the last two bytes count up\n"
+            "  -k              keep the captured stNum/sqNum\n"
+            "  -t              set t to the replay time of each state change\n",
+            name);
+}
+
+static bool parse_options(int argc, char **argv, ReplayOptions *options)
+{
+    int opt;
+
+    memset(options, 0, sizeof(ReplayOptions));
+    options->speed = 1.0;
+    options->loops = 1;
+    options->copies = 1;
+    options->appId = -1;
+    options->renumber = true;
+
+    while ((opt = getopt(argc, argv, "i:T:x:ml:n:a:d:s:kt")) != -1)
+    {
+        switch (opt)
+        {
+        case 'i':
+            options->output = OUTPUT_INTERFACE;
+            options->device = optarg;
+            break;
+        case 'T':
+            options->output = OUTPUT_TAP;
+            options->device = optarg;
+            break;
+        case 'x':
+            options->speed = atof(optarg);
+            if (options->speed <= 0)
+                return false;
+            break;
+        case 'm':
+            options->speed = 0;
+            break;
+        case 'l':
+            options->loops = atoi(optarg);
+            break;
+        case 'n':
+            options->copies = atoi(optarg);
+            if (options->copies < 1 || options->copies > MAX_COPIES)
+                return false;
+            break;
+        case 'a':
+            options->appId = (int)strtol(optarg, NULL, 0);
+            if (options->appId < 0 || options->appId > 0xffff)
+                return false;
+            break;
+        case 'd':
+            options->setDstMac = parse_mac(optarg, options->dstMac);
+            if (options->setDstMac == false)
+                return false;
+            break;
+        case 's':
+            options->setSrcMac = parse_mac(optarg, options->srcMac);
+            if (options->setSrcMac == false)
+                return false;
+            break;
+        case 'k':
+            options->renumber = false;
+            break;
+        case 't':
+            options->retime = true;
+            break;
+        default:
+            return false;
+        }
+    }
+
+    return (optind == argc - 1);
+}
+
+static void print_stage(Metrics metrics, int stage)
+{
+    MetricsSummary summary;
+
+    if (metrics_get_summary(metrics, stage, &summary) == false || summary.count == 0)
+        return;
+
+    printf("%-14s p50 %.3f us, p99 %.3f us, p99.9 %.3f us, max %.3f us\n", metrics_get_stage_name(metrics, stage),
+           summary.p50 / 1e3, summary.p99 / 1e3, summary.p999 / 1e3, summary.max / 1e3);
+}
+
+int main(int argc, char **argv)
+{
+    static Replay replay;
+
+    if (parse_options(argc, argv, &replay.options) == false)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const char *path = argv[optind];
+
+    signal(SIGINT, sigint_handler);
+
+    replay.tapFd = -1;
+    replay.metrics = metrics_create();
+
+    if (replay.metrics == NULL)
+        return EXIT_FAILURE;
+
+    replay.stageSend = metrics_add_stage(replay.metrics,
+                                         replay.options.output == OUTPUT_IN_PROCESS ? "handleMessage" : "send");
+    replay.stageLateness = metrics_add_stage(replay.metrics, "lateness");
+
+    switch (replay.options.output)
+    {
+    case OUTPUT_IN_PROCESS:
+        replay.receiver = GooseReceiver_create();
+        break;
+
+    case OUTPUT_INTERFACE:
+        // the frames carry their own destination address
+        replay.socket = Ethernet_createSocket(replay.options.device, replay.options.dstMac);
+
+        if (replay.socket)
+            Ethernet_setupSendRing(replay.socket, SEND_RING_FRAMES);
+        break;
+
+    case OUTPUT_TAP:
+        replay.tapFd = tap_open(replay.options.device);
+        break;
+    }
+
+    if (replay.receiver == NULL && replay.socket == NULL && replay.tapFd < 0)
+    {
+        fprintf(stderr, "Cannot open output %s\n", replay.options.device ? replay.options.device : "receiver");
+        metrics_destroy(replay.metrics);
+        return EXIT_FAILURE;
+    }
+
+    uint64_t start = Hal_getMonotonicTimeInNs();
+    int loop = 0;
+
+    while (running && (replay.options.loops == 0 || loop < replay.options.loops))
+    {
+        if (replay_capture(&replay, path) == false)
+            break;
+
+        loop++;
+    }
+
+    double seconds = (Hal_getMonotonicTimeInNs() - start) / 1e9;
+
+    printf("%llu frames (%d passes, %d captured publishers x %d) in %.3f s: %.0f frames/s, %.1f Mbit/s\n",
+           (unsigned long long)replay.frames, loop, replay.publisherCount, replay.options.copies, seconds,
+           replay.frames / seconds, replay.bytes * 8 / seconds / 1e6);
+
+    if (replay.skipped || replay.sendErrors)
+        printf("%llu frames skipped, %llu send errors\n", (unsigned long long)replay.skipped,
+               (unsigned long long)replay.sendErrors);
+
+    if (replay.receiver)
+        printf("%llu listener callbacks\n", (unsigned long long)replay.callbacks);
+
+    print_stage(replay.metrics, replay.stageSend);
+    print_stage(replay.metrics, replay.stageLateness);
+
+    // the receiver destroys the subscribers
+    if (replay.receiver)
+        GooseReceiver_destroy(replay.receiver);
+
+    if (replay.socket)
+        Ethernet_destroySocket(replay.socket);
+
+    if (replay.tapFd >= 0)
+        close(replay.tapFd);
+
+    for (int i = 0; i < replay.publisherCount; i++)
+        free(replay.publishers[i].copies);
+
+    metrics_destroy(replay.metrics);
+
+    return EXIT_SUCCESS;
+}
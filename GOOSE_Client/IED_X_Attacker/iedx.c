@@ -21,6 +21,8 @@ static int rdso_status;
 static uint32_t stNum;
 static uint32_t sqNum = 0;
 static bool statusBool;
+static LinkedList dataSetValues; // Data set bound to the publisher's frame template
+static MmsValue *statusValue;    // The only member of dataSetValues
 
 char gocbRef[100] = "X/LLN0$GO$gcbAnalogValues";
 char datSet[100] = "X/LLN0$AnalogValues";
@@ -49,9 +51,9 @@ void formatUtcTime(char *buffer, size_t buffer_size, uint64_t epoch_ms)
 void publish(GoosePublisher publisher)
 {
     char published_timestamp_str[1024];
-    LinkedList dataSetValues = LinkedList_create();
     statusBool = (rdso_status == 1); // True for CLOSED, False for OPEN
-    LinkedList_add(dataSetValues, MmsValue_newBoolean(statusBool));
+    MmsValue_setBoolean(statusValue, statusBool);
+    GoosePublisher_updateFrameValues(publisher);
 
     // Generate the current timestamp and set it for the publisher
     uint64_t currentTime = Hal_getTimeInMs();
@@ -59,15 +61,13 @@ void publish(GoosePublisher publisher)
 
     formatUtcTime(published_timestamp_str, sizeof(published_timestamp_str), currentTime);
 
-    if (GoosePublisher_publish(publisher, dataSetValues) == -1)
+    if (GoosePublisher_publishFrame(publisher) == -1)
     {
         log_error("Error sending GOOSE message");
     }
 
     printf("******ATTACK GOOSE DATA******\nt: %s\nstNum: %u\nallData: %s\n",
            published_timestamp_str, stNum, rdso_status == 1 ? "TRUE" : "FALSE");
-
-    LinkedList_destroyDeep(dataSetValues, (LinkedListValueDeleteFunction)MmsValue_delete);
 }
 
 int main(int argc, char **argv)
@@ -101,6 +101,15 @@ int main(int argc, char **argv)
     GoosePublisher_setStNum(publisher, stNum);
     GoosePublisher_setSqNum(publisher, sqNum);
 
+    dataSetValues = LinkedList_create();
+    statusValue = MmsValue_newBoolean(rdso_status == 1);
+    LinkedList_add(dataSetValues, statusValue);
+
+    if (GoosePublisher_prepareFrameTemplate(publisher, dataSetValues) == false)
+    {
+        log_error("Failed to prepare GOOSE frame template");
+    }
+
     int count = 0;
     while (count < 100)
     {
@@ -109,6 +118,7 @@ int main(int argc, char **argv)
         Thread_sleep(6000); // Sleep for 6 seconds
     }
     GoosePublisher_destroy(publisher);
+    LinkedList_destroyDeep(dataSetValues, (LinkedListValueDeleteFunction)MmsValue_delete);
 
     log_info("Application terminated gracefully");
     return 0;
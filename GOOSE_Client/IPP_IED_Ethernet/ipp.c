@@ -7,37 +7,52 @@
 #include <unistd.h>
 #include <sys/time.h>
 #include <time.h>
-#include <curl/curl.h>
 #include <pthread.h>
 #include <json-c/json.h> // Include json-c header
 
 #include "goose_receiver.h"
 #include "goose_subscriber.h"
 #include "goose_publisher.h"
+#include "goose_retransmission_scheduler.h"
 #include "hal_thread.h"
 #include "mms_value.h"
 #include "linked_list.h"
 #include "logging.h" // Custom logging library
 #include "hal_time.h"
+#include "http_client.h"
+#include "bookkeeping_worker.h"
+#include "latency_metrics.h"
+#include "utc_time_format.h"
+
+#define GATEWAY_URL "http://192.168.2.100:3001"
+
+#define METRICS_TARGET "file:ipp_metrics.jsonl" // Default exporter target, argv[2] overrides it
+#define METRICS_EXPORT_INTERVAL 10000             // ms between two snapshots
+
+#define GOOSE_MIN_TIME 2    // First retransmission after a state change in ms
+#define GOOSE_MAX_TIME 1000 // Retransmission interval in the stable state in ms
+
+#define PUBLISHER_RT_PRIORITY 80 // SCHED_FIFO priority of the retransmission thread, 0 = normal scheduling
+#define PUBLISHER_CPU -1         // CPU the retransmission thread is bound to, -1 = any
+
+// Messages passed to gooseListener. Retransmissions are needed: after an invalid action subscribed_stNum
+// is reverted and the next retransmission of the same state triggers the action again.
+#define SUBSCRIBER_FRAME_CLASSES (GOOSE_FRAME_NEW_EVENT | GOOSE_FRAME_RETRANSMISSION)
 
 volatile int running = 1;
 volatile int ipp_status = 0; // Global variable for the IPP status
-volatile int update = 0;     // Global variable to trigger status update
 static uint32_t stNum = 0;
-static uint32_t sqNum = 0;
 static char subscribed_timestamp_str[64]; // Global variable for the timestamp string of the subscribed message
 static char api_timestamp_str[64];
 static char api_subscribed_data[1024];
 static char published_timestamp_str[64]; // Global variable for the timestamp string of the published message
+static UtcTimeFormatter publishedTimeFormat, subscribedTimeFormat; // publish path and receive thread
 static uint32_t subscribed_stNum = 0;
 static char subscribed_data[1024] = "FALSE";
 static GoosePublisher global_publisher;
 static uint32_t previous_subscribed_stNum = 0; // The stnum before the status update to be validated. subscribed stnum is reverted to this if the action is invalid
 static char subscribed_goID[100];              // Global variable for the timestamp string of the published message
-static struct timespec action_val_start, action_val_end;
-static double timeForBookKeeping = 0.0, timeForValidation = 0.0, timeFromActionToValidation = 0.0, timeForCorrectiveAction = 0.0, projectedDowntime = 0.0, totalActualDowntime = 0.0;
-static bool isCorrection = false;
-static bool isValid;
+static uint64_t action_val_start; // Monotonic time the subscribed state change was received
 
 char gocbRef[100] = "IPP/LLN0$GO$gcbAnalogValues";
 char datSet[100] = "IPP/LLN0$AnalogValues";
@@ -45,15 +60,34 @@ char goID[100] = "IPP";
 char goIDListenerRDSO[100] = "RDSO/LLN0$GO$gcbAnalogValues";
 char goIDListenerX[100] = "X/LLN0$GO$gcbAnalogValues";
 
-pthread_mutex_t lock; // Mutex for protecting shared variables
+pthread_mutex_t lock;        // Mutex for protecting shared variables
+pthread_mutex_t submit_lock; // Serialises producers of the bookkeeping queue
 
+static HttpClient gateway;   // Keep-alive connection pool to the fabric gateway
+static BookkeepingWorker bookkeeper; // Single long-lived thread for ledger writes
+static LinkedList dataSetValues;     // Data set bound to the publisher's frame template
+static MmsValue *statusValue;        // The only member of dataSetValues
+static GooseRetransmissionScheduler scheduler; // Repeats the published state on the retransmission curve
+
+// Latency histograms of the GOOSE -> validation -> ledger pipeline
+static Metrics metrics;
+static int stageActionToValidation, stageValidation, stageProjectedDowntime;
+static int stageCorrectiveAction, stageTotalDowntime, stageBookKeeping;
+static int stageWireToCallback, stageEventToWire;
+
+// Validation engine: the GOOSE receive callback hands state changes straight to
+// a persistent worker instead of waiting for the publish loop to notice a flag
 typedef struct
 {
-    char published_timestamp_str[64];
-    uint32_t stNum;
-    bool statusBool;
-    char bookkeeping_status[64];
-} BookkeepingArgs;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t pending;   // state changes signalled but not yet picked up
+    uint64_t coalesced; // state changes superseded before the worker got to them
+    bool running;
+    pthread_t thread;
+} ValidationEngine;
+
+static ValidationEngine validator = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, false};
 
 // Signal handler for graceful termination
 static void sigint_handler(int signalId)
@@ -61,163 +95,114 @@ static void sigint_handler(int signalId)
     running = 0;
 }
 
-void send_data_to_server(double bookKeepingTime, double validationTime, double actionToValidationTime, double correctiveActionTime, double projectedDowntime, double totalDowntime)
+bool metrics_setup(const char *target)
+{
+    metrics = metrics_create();
+    if (metrics == NULL)
+        return false;
+
+    stageActionToValidation = metrics_add_stage(metrics, "actionToValidation");
+    stageValidation = metrics_add_stage(metrics, "validation");
+    stageProjectedDowntime = metrics_add_stage(metrics, "projectedDowntime");
+    stageCorrectiveAction = metrics_add_stage(metrics, "correctiveAction");
+    stageTotalDowntime = metrics_add_stage(metrics, "totalDowntime");
+    stageBookKeeping = metrics_add_stage(metrics, "bookKeeping");
+    stageWireToCallback = metrics_add_stage(metrics, "wireToCallback");
+    stageEventToWire = metrics_add_stage(metrics, "eventToWire");
+
+    if (metrics_start_exporter(metrics, target, METRICS_EXPORT_INTERVAL) == false)
+        log_error("Failed to start metrics exporter for %s", target);
+
+    return true;
+}
+
+void metrics_shutdown(void)
 {
-    CURL *curl;
-    CURLcode res;
+    metrics_stop_exporter(metrics);
 
-    // Initialize a CURL session
-    curl = curl_easy_init();
-    if (curl)
+    for (int i = 0; i < metrics_get_stage_count(metrics); i++)
     {
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-
-        // Create JSON object
-        json_object *jobj = json_object_new_object();
-        json_object_object_add(jobj, "bookKeepingTime", json_object_new_double(bookKeepingTime));
-        json_object_object_add(jobj, "validationTime", json_object_new_double(validationTime));
-        json_object_object_add(jobj, "actionToValidationTime", json_object_new_double(actionToValidationTime));
-        json_object_object_add(jobj, "correctiveActionTime", json_object_new_double(correctiveActionTime));
-        json_object_object_add(jobj, "projectedDowntime", json_object_new_double(projectedDowntime));
-        json_object_object_add(jobj, "totalDowntime", json_object_new_double(totalDowntime));
-
-        // Set CURL options
-        curl_easy_setopt(curl, CURLOPT_URL, "http://192.168.37.1:5000/data");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_object_to_json_string(jobj));
-
-        // Perform the request
-        res = curl_easy_perform(curl);
-        if (res != CURLE_OK)
-        {
-            fprintf(stderr, "curl_easy_perform() failed: %s\n", curl_easy_strerror(res));
-        }
+        MetricsSummary summary;
+        metrics_get_summary(metrics, i, &summary);
 
-        // Cleanup
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
-        json_object_put(jobj);
+        log_info("Latency %s: %llu samples, p50 %.3f ms, p99 %.3f ms, p99.9 %.3f ms, max %.3f ms",
+                 metrics_get_stage_name(metrics, i), (unsigned long long)summary.count,
+                 summary.p50 / 1e6, summary.p99 / 1e6, summary.p999 / 1e6, summary.max / 1e6);
     }
+
+    metrics_destroy(metrics);
 }
 void log_error_with_retry(const char *message, int retry_count)
 {
     fprintf(stderr, "%s Retry count: %d\n", message, retry_count);
 }
 
-void formatUtcTime(char *buffer, size_t buffer_size, uint64_t epoch_ms)
-{
-    time_t rawtime = epoch_ms / 1000;
-    struct tm *ptm = gmtime(&rawtime);
-
-    strftime(buffer, buffer_size, "%b %d, %Y %H:%M:%S", ptm);
-    int milliseconds = epoch_ms % 1000;
-    char ms_buffer[50];
-    sprintf(ms_buffer, ".%03d UTC", milliseconds);
-    strcat(buffer, ms_buffer);
-}
-
-// Function to send a non-blocking POST request with JSON data
+// Function to send a POST request with JSON data over the pooled gateway connection
 void bookkeeping_api(const char *timestamp, uint32_t stNum, const char *allData, const char *status)
 {
-    CURL *curl;
-    CURLcode res;
+    int rc;
     int retry_count = 0;
     int max_retries = 3;
-    struct timespec start, end;
+    char body[512];
+    char statusJson[128], timestampJson[128], allDataJson[128];
 
-    // Record start time
-    clock_gettime(CLOCK_REALTIME, &start);
+    uint64_t start = metrics_now();
 
-    curl_global_init(CURL_GLOBAL_ALL);
-    do
+    if (http_client_json_escape(statusJson, sizeof(statusJson), status) < 0 ||
+        http_client_json_escape(timestampJson, sizeof(timestampJson), timestamp) < 0 ||
+        http_client_json_escape(allDataJson, sizeof(allDataJson), allData) < 0)
     {
-        curl = curl_easy_init();
-        if (curl)
-        {
-            json_object *jobj = json_object_new_object();
-            json_object *jmessageContent = json_object_new_object();
-
-            json_object_object_add(jmessageContent, "t", json_object_new_string(timestamp));
-            json_object_object_add(jmessageContent, "stNum", json_object_new_int(stNum));
-            json_object_object_add(jmessageContent, "allData", json_object_new_string(allData));
-
-            json_object_object_add(jobj, "id", json_object_new_string("IPP"));
-            json_object_object_add(jobj, "status", json_object_new_string(status));
-            json_object_object_add(jobj, "message", jmessageContent);
-
-            const char *json_data = json_object_to_json_string(jobj);
-            curl_easy_setopt(curl, CURLOPT_URL, "http://192.168.2.100:3001/bookKeeping");
-            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_data);
-            curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, 5000L);
-
-            struct curl_slist *headers = NULL;
-            headers = curl_slist_append(headers, "Content-Type: application/json");
-            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-            res = curl_easy_perform(curl);
-            if (res != CURLE_OK)
-            {
-                log_error_with_retry("curl_easy_perform() failed", retry_count);
-                retry_count++;
-                Thread_sleep(2000 * retry_count);
-            }
-            else
-            {
-                retry_count = max_retries;
-            }
-
-            curl_slist_free_all(headers);
-            curl_easy_cleanup(curl);
-            json_object_put(jobj);
-        }
-    } while (res != CURLE_OK && retry_count < max_retries);
+        log_error("Bookkeeping request field too long, request dropped");
+        return;
+    }
 
-    curl_global_cleanup();
-    // Record end time
-    clock_gettime(CLOCK_REALTIME, &end);
+    int length = snprintf(body, sizeof(body),
+                          "{\"id\":\"IPP\",\"status\":\"%s\",\"message\":{\"t\":\"%s\",\"stNum\":%u,\"allData\":\"%s\"}}",
+                          statusJson, timestampJson, stNum, allDataJson);
 
-    // Calculate time difference
-    double time_spent = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
-    printf("Time taken for BookKeeping: %.9f seconds\n", time_spent); // In wireshark will be from when the bookkeeping request was sent to when the response was received
-    if (isValid)
+    if (length < 0 || (size_t)length >= sizeof(body))
     {
-        timeForBookKeeping = time_spent;
-
-        // Send the data
-        send_data_to_server(timeForBookKeeping, timeForValidation, timeFromActionToValidation,
-                            -1.0, projectedDowntime, -1.0);
+        log_error("Bookkeeping request body too long, request dropped");
+        return;
     }
 
-    if (!isValid && isCorrection)
+    do
     {
-        isCorrection = !isCorrection;
-        timeForBookKeeping = time_spent;
+        rc = http_client_post_json(gateway, "/bookKeeping", body, length, NULL, 0, NULL);
+        if (rc == -1)
+        {
+            log_error_with_retry("curl_easy_perform() failed", retry_count);
+            retry_count++;
+            Thread_sleep(2000 * retry_count);
+        }
+    } while (rc == -1 && retry_count < max_retries);
 
-        // Send the data
-        send_data_to_server(timeForBookKeeping, timeForValidation, timeFromActionToValidation,
-                            timeForCorrectiveAction, projectedDowntime, totalActualDowntime);
-    }
+    uint64_t time_spent = metrics_span_end(metrics, stageBookKeeping, start);
+    printf("Time taken for BookKeeping: %.9f seconds\n", time_spent / 1e9); // In wireshark will be from when the bookkeeping request was sent to when the response was received
 }
 
-void *handle_bookkeeping(void *args)
+void handle_bookkeeping(const BookkeepingArgs *args, void *parameter)
 {
-    BookkeepingArgs *bkArgs = (BookkeepingArgs *)args;
-    bookkeeping_api(bkArgs->published_timestamp_str, bkArgs->stNum, bkArgs->statusBool ? "TRUE" : "FALSE", bkArgs->bookkeeping_status);
-    free(bkArgs); // Free the allocated memory for arguments
-    return NULL;
+    bookkeeping_api(args->published_timestamp_str, args->stNum, args->statusBool ? "TRUE" : "FALSE", args->bookkeeping_status);
 }
 
-// Callback function to write response data
-size_t write_callback(void *ptr, size_t size, size_t nmemb, void *stream)
+// Snapshot the published state under the state lock. Validation threads may
+// overlap, so the queue submission itself is serialised on its own lock.
+void submit_bookkeeping(uint32_t bkStNum, bool bkStatusBool, const char *status)
 {
-    size_t total_size = size * nmemb;
-    if (total_size < 1024)
-    {
-        memcpy(stream, ptr, total_size);
-        ((char *)stream)[total_size] = '\0'; // Null-terminate the string
-    }
-    return total_size;
+    BookkeepingArgs args;
+
+    pthread_mutex_lock(&lock);
+    memcpy(args.published_timestamp_str, published_timestamp_str, sizeof(args.published_timestamp_str));
+    pthread_mutex_unlock(&lock);
+
+    args.stNum = bkStNum;
+    args.statusBool = bkStatusBool;
+    strncpy(args.bookkeeping_status, status, sizeof(args.bookkeeping_status));
+
+    pthread_mutex_lock(&submit_lock);
+    bookkeeping_worker_submit(bookkeeper, &args, 100);
+    pthread_mutex_unlock(&submit_lock);
 }
 
 void publish(GoosePublisher publisher);
@@ -225,43 +210,36 @@ void publish(GoosePublisher publisher);
 void *handle_validation(void *arg)
 {
     bool statusBool = (ipp_status == 1);
+    bool isValid;
 
-    struct timespec start, end, correction_start, correction_end;
+    char request_body[160];
+    char goIdJson[128];
+    int request_length = -1;
 
-    json_object *jobj = json_object_new_object();
-    json_object_object_add(jobj, "id", json_object_new_string(subscribed_goID));
-    const char *json_data_id = json_object_to_json_string(jobj);
+    if (http_client_json_escape(goIdJson, sizeof(goIdJson), subscribed_goID) >= 0)
+        request_length = snprintf(request_body, sizeof(request_body), "{\"id\":\"%s\"}", goIdJson);
 
-    CURL *curl;
-    CURLcode res;
+    if (request_length < 0 || (size_t)request_length >= sizeof(request_body))
+    {
+        log_error("Validation request body too long, validation skipped");
+        return NULL;
+    }
+
+    char response_buffer[1024] = {0};
+    int rc;
     int retry_count = 0;
     int max_retries = 3;
 
-    clock_gettime(CLOCK_REALTIME, &action_val_end);
-    // Calculate time difference
-    double action_time = (action_val_end.tv_sec - action_val_start.tv_sec) + (action_val_end.tv_nsec - action_val_start.tv_nsec) / 1e9;
-    printf("Time taken From Action to Right Before Validation: %.9f seconds\n", action_time); // In wireshark will be from when the response to rdso's goose message was published until right before the validation request was sent
-    timeFromActionToValidation = action_time;
+    uint64_t action_time = metrics_span_end(metrics, stageActionToValidation, action_val_start);
+    printf("Time taken From Action to Right Before Validation: %.9f seconds\n", action_time / 1e9); // In wireshark will be from when the response to rdso's goose message was published until right before the validation request was sent
 
-    // Record start time
-    clock_gettime(CLOCK_REALTIME, &start);
-    curl_global_init(CURL_GLOBAL_DEFAULT);
+    uint64_t start = metrics_now();
 
-    curl = curl_easy_init();
-    if (curl)
+    do
     {
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        curl_easy_setopt(curl, CURLOPT_URL, "http://192.168.2.100:3001/validate");
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_data_id);
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-        char response_buffer[1024] = {0};
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, response_buffer);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-
-        res = curl_easy_perform(curl);
-        if (res != CURLE_OK)
+        rc = http_client_post_json(gateway, "/validate", request_body, request_length,
+                                   response_buffer, sizeof(response_buffer), NULL);
+        if (rc == -1)
         {
             log_error_with_retry("curl_easy_perform() failed", retry_count);
             retry_count++;
@@ -270,25 +248,18 @@ void *handle_validation(void *arg)
         else
         {
             printf("API RESPONSE:  %s", response_buffer);
-            retry_count = max_retries;
         }
+    } while (rc == -1 && retry_count < max_retries);
 
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
-
-        // Record end time
-        clock_gettime(CLOCK_REALTIME, &end);
-        clock_gettime(CLOCK_REALTIME, &correction_start);
+    if (rc != -1)
+    {
+        uint64_t time_spent = metrics_span_end(metrics, stageValidation, start);
+        uint64_t correction_start = metrics_now();
 
-        // Calculate time difference
-        double time_spent = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
-        printf("Time taken for Validation: %.9f seconds\n\n", time_spent); // In wireshark will be from when validation request was sent until when the response was received
-        double projected_downtime_after_validation = action_time + time_spent;
-        printf("Projected Downtime: %.9f seconds\n\n", projected_downtime_after_validation); // In wireshark will be from when the response to rdso's goose message was publisjed(aka action was taken by ipp) until when the validation request was sent and then from when the validation request was sent until when the response was received
-        projectedDowntime = projected_downtime_after_validation;
-        timeForValidation = time_spent;
-        totalActualDowntime = -1;
-        timeForCorrectiveAction = -1;
+        printf("Time taken for Validation: %.9f seconds\n\n", time_spent / 1e9); // In wireshark will be from when validation request was sent until when the response was received
+        uint64_t projected_downtime_after_validation = action_time + time_spent;
+        metrics_record(metrics, stageProjectedDowntime, projected_downtime_after_validation);
+        printf("Projected Downtime: %.9f seconds\n\n", projected_downtime_after_validation / 1e9); // In wireshark will be from when the response to rdso's goose message was publisjed(aka action was taken by ipp) until when the validation request was sent and then from when the validation request was sent until when the response was received
 
         json_object *jobj = json_tokener_parse(response_buffer);
         json_object *jisValid = NULL;
@@ -297,29 +268,7 @@ void *handle_validation(void *arg)
         json_object_put(jobj);
 
         // STANDARD BOOKKEEPING BELOW
-        //  Allocate memory for the arguments
-        BookkeepingArgs *args = malloc(sizeof(BookkeepingArgs));
-        if (args == NULL)
-        {
-            perror("Failed to allocate memory for bookkeeping arguments");
-            exit(EXIT_FAILURE);
-        }
-
-        // BOOOKKEEPING PROCESS BELOW
-        //  Copy the values into the struct
-        strncpy(args->published_timestamp_str, published_timestamp_str, sizeof(args->published_timestamp_str));
-        args->stNum = stNum;
-        args->statusBool = statusBool;
-        strncpy(args->bookkeeping_status, isValid ? "Valid" : "Invalid", sizeof(args->bookkeeping_status));
-
-        // Create the thread
-        pthread_t bookkeeping_thread;
-        if (pthread_create(&bookkeeping_thread, NULL, handle_bookkeeping, (void *)args) != 0)
-        {
-            perror("Failed to create bookkeeping thread");
-            free(args); // Free the memory if thread creation fails
-        }
-        pthread_detach(bookkeeping_thread); // Automatically reclaim thread resources when done
+        submit_bookkeeping(stNum, statusBool, isValid ? "Valid" : "Invalid");
 
         // CORRECTIVE ACTION BELOW
         if (!isValid)
@@ -327,81 +276,134 @@ void *handle_validation(void *arg)
             pthread_mutex_lock(&lock);
 
             stNum++;
-            sqNum = 0;
 
             ipp_status = !ipp_status;
             statusBool = (ipp_status == 1);
 
             subscribed_stNum = previous_subscribed_stNum;
 
-            isCorrection = true;
+            publish(global_publisher);
 
             pthread_mutex_unlock(&lock);
 
-            publish(global_publisher);
-            clock_gettime(CLOCK_REALTIME, &correction_end);
-
-            // Calculate time difference
-            double correction_time = (correction_end.tv_sec - correction_start.tv_sec) + (correction_end.tv_nsec - correction_start.tv_nsec) / 1e9;
-            printf("Time taken for Corrective Action: %.9f seconds\n\n", correction_time);  // In Wireshark will map from after validation response was received until a new message was published
-            double actual_downtime = projected_downtime_after_validation + correction_time; // In wireshark will map from when the response was published to when the validation request was sent and then from when the validation request was sent until when the response was received until when a new message was published with the correction
-            printf("Total Actual Downtime: %.9f seconds\n\n", actual_downtime);
-            totalActualDowntime = actual_downtime;
-            timeForCorrectiveAction = correction_time;
+            uint64_t correction_time = metrics_span_end(metrics, stageCorrectiveAction, correction_start);
+            printf("Time taken for Corrective Action: %.9f seconds\n\n", correction_time / 1e9);   // In Wireshark will map from after validation response was received until a new message was published
+            uint64_t actual_downtime = projected_downtime_after_validation + correction_time; // In wireshark will map from when the response was published to when the validation request was sent and then from when the validation request was sent until when the response was received until when a new message was published with the correction
+            metrics_record(metrics, stageTotalDowntime, actual_downtime);
+            printf("Total Actual Downtime: %.9f seconds\n\n", actual_downtime / 1e9);
 
             // CORRECTIVE ACTION BOOKKEEPING BELOW
-
-            // Allocate memory for the arguments
-            BookkeepingArgs *corrective_args = malloc(sizeof(BookkeepingArgs));
-            if (corrective_args == NULL)
-            {
-                perror("Failed to allocate memory for corrective bookkeeping arguments");
-                exit(EXIT_FAILURE);
-            }
-
-            // Copy the values into the struct
-            strncpy(corrective_args->published_timestamp_str, published_timestamp_str, sizeof(corrective_args->published_timestamp_str));
-            corrective_args->stNum = stNum;
-            corrective_args->statusBool = statusBool;
-            strncpy(corrective_args->bookkeeping_status, "Valid", sizeof(corrective_args->bookkeeping_status));
-
-            // Create the thread
-            pthread_t corrective_bookkeeping_thread;
-            if (pthread_create(&corrective_bookkeeping_thread, NULL, handle_bookkeeping, (void *)corrective_args) != 0)
-            {
-                perror("Failed to create corrective bookkeeping thread");
-                free(corrective_args); // Free the memory if thread creation fails
-            }
-            pthread_detach(corrective_bookkeeping_thread); // Automatically reclaim thread resources when done
+            submit_bookkeeping(stNum, statusBool, "Valid");
         }
     }
-    while (res != CURLE_OK && retry_count < max_retries)
-        ;
 
-    curl_global_cleanup();
     return NULL;
 }
 
+void *validation_engine_loop(void *arg)
+{
+    pthread_mutex_lock(&validator.mutex);
+
+    while (1)
+    {
+        while (validator.pending == 0 && validator.running)
+            pthread_cond_wait(&validator.cond, &validator.mutex);
+
+        if (validator.running == false)
+            break;
+
+        // Only the latest subscribed state is kept, older ones are superseded
+        validator.coalesced += validator.pending - 1;
+        validator.pending = 0;
+
+        pthread_mutex_unlock(&validator.mutex);
+
+        // Take the action right away, then validate it
+        pthread_mutex_lock(&lock);
+        publish(global_publisher);
+        pthread_mutex_unlock(&lock);
+
+        handle_validation(NULL);
+
+        pthread_mutex_lock(&validator.mutex);
+    }
+
+    pthread_mutex_unlock(&validator.mutex);
+
+    return NULL;
+}
+
+// Called from the GOOSE receive thread
+void validation_engine_trigger(void)
+{
+    pthread_mutex_lock(&validator.mutex);
+    validator.pending++;
+    pthread_cond_signal(&validator.cond);
+    pthread_mutex_unlock(&validator.mutex);
+}
+
+bool validation_engine_start(GoosePublisher publisher)
+{
+    global_publisher = publisher;
+    validator.running = true;
+
+    if (pthread_create(&validator.thread, NULL, validation_engine_loop, NULL) != 0)
+    {
+        validator.running = false;
+        return false;
+    }
+
+    return true;
+}
+
+void validation_engine_stop(void)
+{
+    pthread_mutex_lock(&validator.mutex);
+    validator.running = false;
+    pthread_cond_signal(&validator.cond);
+    pthread_mutex_unlock(&validator.mutex);
+
+    pthread_join(validator.thread, NULL);
+}
+
 // Listener for GOOSE messages
+
+// Sequence counters of a subscriber, logged at shutdown
+void log_subscriber_counters(const char *name, GooseSubscriber subscriber)
+{
+    GooseSubscriberCounters counters;
+    GooseSubscriber_getCounters(subscriber, &counters);
+
+    log_info("GOOSE %s: %llu new events (%llu missed), %llu retransmissions (%llu missed), "
+             "%llu out of order, %llu duplicates, %llu stNum rollbacks, %llu TTL expiries",
+             name, (unsigned long long)counters.newEvents, (unsigned long long)counters.missedEvents,
+             (unsigned long long)counters.retransmissions, (unsigned long long)counters.missedRetransmissions,
+             (unsigned long long)counters.outOfOrder, (unsigned long long)counters.duplicates,
+             (unsigned long long)counters.stNumRollbacks, (unsigned long long)counters.ttlExpiries);
+}
+
 void gooseListener(GooseSubscriber subscriber, void *parameter)
 {
-    formatUtcTime(subscribed_timestamp_str, sizeof(subscribed_timestamp_str), GooseSubscriber_getTimestamp(subscriber));
+    // From the frame entering the network stack to this callback
+    metrics_record_wall_span(metrics, stageWireToCallback, GooseSubscriber_getReceiveTimestampNs(subscriber), metrics_wall_now());
+
+    utc_time_format(&subscribedTimeFormat, subscribed_timestamp_str, sizeof(subscribed_timestamp_str),
+                    GooseSubscriber_getTimestamp(subscriber) * 1000000ULL);
 
     if (subscribed_stNum < GooseSubscriber_getStNum(subscriber))
     {
         // Record start time
-        clock_gettime(CLOCK_REALTIME, &action_val_start);
+        action_val_start = metrics_now();
+        pthread_mutex_lock(&lock);
         memcpy(subscribed_goID, GooseSubscriber_getGoId(subscriber), 100);
         previous_subscribed_stNum = subscribed_stNum;
         subscribed_stNum = GooseSubscriber_getStNum(subscriber);
-        update = 1;
         memcpy(api_timestamp_str, subscribed_timestamp_str, sizeof(subscribed_timestamp_str));
         stNum++;
-        sqNum = 0;
-        MmsValue *values = GooseSubscriber_getDataSetValues(subscriber);
-        MmsValue_printToBuffer(values, subscribed_data, sizeof(subscribed_data));
-        size_t length = strlen(subscribed_data);
-        if (length == 6)
+        // The data set is a single boolean, read it straight from the received allData
+        bool status = false;
+        GooseSubscriber_getElementBoolean(subscriber, 0, &status);
+        if (status)
         {
             strcpy(subscribed_data, "TRUE");
             ipp_status = 0;
@@ -412,6 +414,9 @@ void gooseListener(GooseSubscriber subscriber, void *parameter)
             ipp_status = 1;
         }
         memcpy(api_subscribed_data, subscribed_data, sizeof(subscribed_data));
+        pthread_mutex_unlock(&lock);
+
+        validation_engine_trigger();
 
         // printf("Previously Subscribed: %u\nCurrently Subscribed: %u\n", previous_subscribed_stNum, subscribed_stNum);
         printf("\n***MESSAGE SUBSCRIBED***\n{\n"
@@ -423,47 +428,73 @@ void gooseListener(GooseSubscriber subscriber, void *parameter)
     }
 }
 
-// GOOSE publisher function
+// Publish a new state. The scheduler sends it right away and then keeps repeating it.
+// Called with lock held.
 void publish(GoosePublisher publisher)
 {
-    LinkedList dataSetValues = LinkedList_create();
+    uint64_t eventTime = metrics_wall_now();
+
+    GooseRetransmissionScheduler_lock(scheduler);
+
     bool statusBool = (ipp_status == 1);
-    LinkedList_add(dataSetValues, MmsValue_newBoolean(statusBool));
+    MmsValue_setBoolean(statusValue, statusBool);
+    GoosePublisher_updateFrameValues(publisher);
 
     GoosePublisher_setStNum(publisher, stNum);
-    GoosePublisher_setSqNum(publisher, sqNum++);
+    GoosePublisher_setSqNum(publisher, 0);
+
+    uint64_t currentTime = Hal_getTimeInNs();
+    GoosePublisher_setTimestampNs(publisher, currentTime);
+
+    utc_time_format(&publishedTimeFormat, published_timestamp_str, sizeof(published_timestamp_str), currentTime);
 
-    uint64_t currentTime = Hal_getTimeInMs();
-    GoosePublisher_setTimestamp(publisher, currentTime);
+    GooseRetransmissionScheduler_unlock(scheduler);
 
-    formatUtcTime(published_timestamp_str, sizeof(published_timestamp_str), currentTime);
+    uint64_t txTimestamp;
 
-    if (GoosePublisher_publish(publisher, dataSetValues) == -1)
+    if (GooseRetransmissionScheduler_triggerEventEx(scheduler, publisher, &txTimestamp) == false)
     {
         log_error("Error sending GOOSE message");
     }
-
-    if (update)
+    else
     {
-        global_publisher = publisher;
-        update = 0;
-        pthread_t update_thread;
-        pthread_create(&update_thread, NULL, handle_validation, NULL);
-        pthread_detach(update_thread); // Automatically reclaim thread resources when done
+        metrics_record_wall_span(metrics, stageEventToWire, eventTime, txTimestamp);
     }
-
-    LinkedList_destroyDeep(dataSetValues, (LinkedListValueDeleteFunction)MmsValue_delete);
 }
 
 int main(int argc, char **argv)
 {
     signal(SIGINT, sigint_handler);
     pthread_mutex_init(&lock, NULL); // Initialize the mutex
+    utc_time_formatter_init(&publishedTimeFormat, 3);
+    utc_time_formatter_init(&subscribedTimeFormat, 3);
+    pthread_mutex_init(&submit_lock, NULL);
 
     char *interface = (argc > 1) ? argv[1] : "ens37";
+    const char *metricsTarget = (argc > 2) ? argv[2] : METRICS_TARGET;
 
     log_info("Using interface %s", interface);
 
+    gateway = http_client_create(GATEWAY_URL, 5000L);
+    if (gateway == NULL)
+    {
+        log_error("Failed to create HTTP client");
+        return EXIT_FAILURE;
+    }
+
+    if (metrics_setup(metricsTarget) == false)
+    {
+        log_error("Failed to create latency metrics");
+        return EXIT_FAILURE;
+    }
+
+    bookkeeper = bookkeeping_worker_start(handle_bookkeeping, NULL);
+    if (bookkeeper == NULL)
+    {
+        log_error("Failed to start bookkeeping worker");
+        return EXIT_FAILURE;
+    }
+
     GooseReceiver receiver = GooseReceiver_create();
     if (receiver == NULL)
     {
@@ -488,7 +519,9 @@ int main(int argc, char **argv)
     {
         GooseSubscriber_setDstMac(subscriberRDSO, dstMac);
         GooseSubscriber_setAppId(subscriberRDSO, 1000);
+        GooseSubscriber_setCompiledDecoding(subscriberRDSO, true);
         GooseSubscriber_setListener(subscriberRDSO, gooseListener, NULL);
+        GooseSubscriber_setListenerClasses(subscriberRDSO, SUBSCRIBER_FRAME_CLASSES);
         GooseReceiver_addSubscriber(receiver, subscriberRDSO);
     }
 
@@ -502,10 +535,14 @@ int main(int argc, char **argv)
     {
         GooseSubscriber_setDstMac(subscriberX, dstMac);
         GooseSubscriber_setAppId(subscriberX, 1000);
+        GooseSubscriber_setCompiledDecoding(subscriberX, true);
         GooseSubscriber_setListener(subscriberX, gooseListener, NULL);
+        GooseSubscriber_setListenerClasses(subscriberX, SUBSCRIBER_FRAME_CLASSES);
         GooseReceiver_addSubscriber(receiver, subscriberX);
     }
 
+    // Kernel receive timestamps for the wireToCallback stage
+    GooseReceiver_enableTimestamping(receiver, false);
     GooseReceiver_start(receiver);
 
     CommParameters gooseCommParameters = {0};
@@ -522,6 +559,12 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 
+    // Kernel transmit timestamps for the eventToWire stage
+    if (GoosePublisher_enableTimestamping(publisher, false) == false)
+    {
+        log_error("No transmit timestamps on %s", interface);
+    }
+
     GoosePublisher_setGoCbRef(publisher, gocbRef);
     GoosePublisher_setConfRev(publisher, 1);
     GoosePublisher_setDataSetRef(publisher, datSet);
@@ -529,21 +572,75 @@ int main(int argc, char **argv)
     GoosePublisher_setGoID(publisher, goID);
     // GoosePublisher_setSimulation(publisher, false);
     // GoosePublisher_setNeedsCommission(publisher, false);
-    GoosePublisher_setStNum(publisher, stNum);
-    GoosePublisher_setSqNum(publisher, sqNum);
+    // Encode the frame once, publish() only patches the changing fields
+    dataSetValues = LinkedList_create();
+    statusValue = MmsValue_newBoolean(ipp_status == 1);
+    LinkedList_add(dataSetValues, statusValue);
+
+    if (GoosePublisher_prepareFrameTemplate(publisher, dataSetValues) == false)
+    {
+        log_error("Failed to prepare GOOSE frame template");
+    }
+
+    scheduler = GooseRetransmissionScheduler_create(1);
+    GooseRetransmissionScheduler_addPublisher(scheduler, publisher, GOOSE_MIN_TIME, GOOSE_MAX_TIME);
+
+    // Real-time retransmissions, the HTTP and validation threads must not delay them
+    if (GooseRetransmissionScheduler_startRealtime(scheduler, PUBLISHER_RT_PRIORITY, PUBLISHER_CPU, true) == false)
+    {
+        log_error("Real-time publishing not available, retransmission jitter is not bounded");
+    }
+
+    // Announce the initial state, from then on only state changes are published
+    pthread_mutex_lock(&lock);
+    publish(publisher);
+    pthread_mutex_unlock(&lock);
+
+    if (validation_engine_start(publisher) == false)
+    {
+        log_error("Failed to start validation engine");
+        GooseRetransmissionScheduler_destroy(scheduler);
+        GoosePublisher_destroy(publisher);
+        LinkedList_destroyDeep(dataSetValues, (LinkedListValueDeleteFunction)MmsValue_delete);
+        GooseReceiver_stop(receiver);
+        GooseReceiver_destroy(receiver);
+        return EXIT_FAILURE;
+    }
 
     while (running)
     {
-        pthread_mutex_lock(&lock);
-        publish(publisher);
-        pthread_mutex_unlock(&lock);
-        Thread_sleep(10);
+        Thread_sleep(100);
     }
 
-    GoosePublisher_destroy(publisher);
     GooseReceiver_stop(receiver);
+    log_subscriber_counters("RDSO", subscriberRDSO);
+    log_subscriber_counters("X", subscriberX);
+    validation_engine_stop();
+    log_info("Validation: %llu state changes superseded before validation",
+             (unsigned long long)validator.coalesced);
+    log_info("Sent %llu GOOSE frames", (unsigned long long)GooseRetransmissionScheduler_getSentFrames(scheduler));
+
+    GooseRetransmissionDeadlineStats deadlineStats;
+    GooseRetransmissionScheduler_getDeadlineStats(scheduler, &deadlineStats);
+    log_info("Publisher: %llu cycles, %llu missed deadlines, max lateness %llu us",
+             (unsigned long long)deadlineStats.cycles, (unsigned long long)deadlineStats.missedDeadlines,
+             (unsigned long long)(deadlineStats.maxLateness / 1000));
+    GooseRetransmissionScheduler_destroy(scheduler);
+    GoosePublisher_destroy(publisher);
+    LinkedList_destroyDeep(dataSetValues, (LinkedListValueDeleteFunction)MmsValue_delete);
     GooseReceiver_destroy(receiver);
+
+    BookkeepingStats stats;
+    bookkeeping_worker_stop(bookkeeper, &stats);
+    log_info("Bookkeeping: %llu submitted, %llu processed, %llu dropped, max queue depth %u",
+             (unsigned long long)stats.submitted, (unsigned long long)stats.processed,
+             (unsigned long long)stats.dropped, stats.highWatermark);
+
+    metrics_shutdown();
+
+    http_client_destroy(gateway);
     pthread_mutex_destroy(&lock);
+    pthread_mutex_destroy(&submit_lock);
     log_info("Application terminated gracefully");
 
     return 0;
@@ -6,25 +6,41 @@
 #include <stdio.h>
 #include <signal.h>
 #include <time.h>
-#include <curl/curl.h>
-#include <json-c/json.h>
 #include <pthread.h>
 
 #include "mms_value.h"
 #include "goose_publisher.h"
+#include "goose_retransmission_scheduler.h"
 #include "goose_receiver.h"
 #include "goose_subscriber.h"
 #include "hal_thread.h"
 #include "logging.h"
 #include "hal_time.h"
+#include "http_client.h"
+#include "bookkeeping_worker.h"
+#include "latency_metrics.h"
+#include "utc_time_format.h"
+
+#define GATEWAY_URL "http://192.168.2.101:3001"
+
+#define METRICS_TARGET "file:rdso_metrics.jsonl" // Default exporter target, argv[2] overrides it
+#define METRICS_EXPORT_INTERVAL 10000              // ms between two snapshots
+
+#define GOOSE_MIN_TIME 2    // First retransmission after a state change in ms
+#define GOOSE_MAX_TIME 1000 // Retransmission interval in the stable state in ms
+
+#define PUBLISHER_RT_PRIORITY 80 // SCHED_FIFO priority of the retransmission thread, 0 = normal scheduling
+#define PUBLISHER_CPU -1         // CPU the retransmission thread is bound to, -1 = any
+
+// Messages passed to gooseListener: state changes, publisher restarts and the first message after a TTL expiry
+#define SUBSCRIBER_FRAME_CLASSES (GOOSE_FRAME_NEW_EVENT | GOOSE_FRAME_ST_NUM_ROLLBACK | GOOSE_FRAME_TTL_EXPIRED)
 
 static volatile int running = 1;
 static int rdso_status = 1;
-static int update = 0;
 static uint32_t stNum = 0;
-static uint32_t sqNum = 0;
 static char published_timestamp_str[64];
 static char subscribed_timestamp_str[64];
+static UtcTimeFormatter publishedTimeFormat, subscribedTimeFormat; // publish path and receive thread
 static uint32_t subscribed_stNum = 0;
 static char subscribed_data[1024] = "FALSE";
 static bool statusBool = true;
@@ -37,6 +53,15 @@ char goIDListenerIPP[100] = "IPP/LLN0$GO$gcbAnalogValues";
 char goIDListenerX[100] = "X/LLN0$GO$gcbAnalogValues";
 
 static pthread_mutex_t lock; // Mutex for thread-safe operations
+static HttpClient gateway;   // Keep-alive connection pool to the fabric gateway
+static BookkeepingWorker bookkeeper; // Single long-lived thread for ledger writes
+static LinkedList dataSetValues;     // Data set bound to the publisher's frame template
+static MmsValue *statusValue;        // The only member of dataSetValues
+static GooseRetransmissionScheduler scheduler; // Repeats the published state on the retransmission curve
+
+// Latency histograms of the publish -> ledger pipeline
+static Metrics metrics;
+static int stagePublish, stageBookKeeping, stageWireToCallback, stageEventToWire;
 
 // Signal handler for graceful termination
 static void sigint_handler(int signalId)
@@ -44,127 +69,156 @@ static void sigint_handler(int signalId)
     running = 0;
 }
 
-void log_error_with_retry(const char *message, int retry_count)
+bool metrics_setup(const char *target)
 {
-    fprintf(stderr, "%s Retry count: %d\n", message, retry_count);
+    metrics = metrics_create();
+    if (metrics == NULL)
+        return false;
+
+    stagePublish = metrics_add_stage(metrics, "publish");
+    stageBookKeeping = metrics_add_stage(metrics, "bookKeeping");
+    stageWireToCallback = metrics_add_stage(metrics, "wireToCallback");
+    stageEventToWire = metrics_add_stage(metrics, "eventToWire");
+
+    if (metrics_start_exporter(metrics, target, METRICS_EXPORT_INTERVAL) == false)
+        log_error("Failed to start metrics exporter for %s", target);
+
+    return true;
 }
 
-void formatUtcTime(char *buffer, size_t buffer_size, uint64_t epoch_ms)
+void metrics_shutdown(void)
 {
-    time_t rawtime = epoch_ms / 1000;
-    struct tm *ptm = gmtime(&rawtime);
-
-    strftime(buffer, buffer_size, "%b %d, %Y %H:%M:%S", ptm);
-    // Add milliseconds manually since strftime doesn't support them
-    int milliseconds = epoch_ms % 1000;
-    char ms_buffer[50];
-    sprintf(ms_buffer, ".%03d UTC", milliseconds);
-    strcat(buffer, ms_buffer);
+    metrics_stop_exporter(metrics);
+
+    for (int i = 0; i < metrics_get_stage_count(metrics); i++)
+    {
+        MetricsSummary summary;
+        metrics_get_summary(metrics, i, &summary);
+
+        log_info("Latency %s: %llu samples, p50 %.3f ms, p99 %.3f ms, p99.9 %.3f ms, max %.3f ms",
+                 metrics_get_stage_name(metrics, i), (unsigned long long)summary.count,
+                 summary.p50 / 1e6, summary.p99 / 1e6, summary.p999 / 1e6, summary.max / 1e6);
+    }
+
+    metrics_destroy(metrics);
 }
 
-// Function to send a non-blocking POST request with JSON data
+void log_error_with_retry(const char *message, int retry_count)
+{
+    fprintf(stderr, "%s Retry count: %d\n", message, retry_count);
+}
+
+// Function to send a POST request with JSON data over the pooled gateway connection
 void bookkeeping_api(const char *timestamp, uint32_t stNum, const char *allData, const char *status)
 {
-    CURL *curl;
-    CURLcode res;
+    int rc;
     int retry_count = 0;
     int max_retries = 3;
-    struct timespec start, end;
+    char body[512];
+    char statusJson[128], timestampJson[128], allDataJson[128];
 
-    // Record start time
-    clock_gettime(CLOCK_REALTIME, &start);
+    uint64_t start = metrics_now();
 
-    curl_global_init(CURL_GLOBAL_ALL);
-    do
+    if (http_client_json_escape(statusJson, sizeof(statusJson), status) < 0 ||
+        http_client_json_escape(timestampJson, sizeof(timestampJson), timestamp) < 0 ||
+        http_client_json_escape(allDataJson, sizeof(allDataJson), allData) < 0)
     {
-        curl = curl_easy_init();
-        if (curl)
-        {
-            json_object *jobj = json_object_new_object();
-            json_object *jmessageContent = json_object_new_object();
-
-            json_object_object_add(jmessageContent, "t", json_object_new_string(timestamp));
-            json_object_object_add(jmessageContent, "stNum", json_object_new_int(stNum));
-            json_object_object_add(jmessageContent, "allData", json_object_new_string(allData));
-
-            json_object_object_add(jobj, "id", json_object_new_string("RDSO"));
-            json_object_object_add(jobj, "status", json_object_new_string(status));
-            json_object_object_add(jobj, "message", jmessageContent);
-
-            const char *json_data = json_object_to_json_string(jobj);
-            curl_easy_setopt(curl, CURLOPT_URL, "http://192.168.2.101:3001/bookKeeping");
-            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_data);
-            curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, 5000L); // Set a short timeout
+        log_error("Bookkeeping request field too long, request dropped");
+        return;
+    }
 
-            struct curl_slist *headers = NULL;
-            headers = curl_slist_append(headers, "Content-Type: application/json");
-            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    int length = snprintf(body, sizeof(body),
+                          "{\"id\":\"RDSO\",\"status\":\"%s\",\"message\":{\"t\":\"%s\",\"stNum\":%u,\"allData\":\"%s\"}}",
+                          statusJson, timestampJson, stNum, allDataJson);
 
-            res = curl_easy_perform(curl);
-            if (res != CURLE_OK)
-            {
-                log_error_with_retry("curl_easy_perform() failed", retry_count);
-                retry_count++;
-                Thread_sleep(2000 * retry_count); // Exponential backoff
-            }
-            else
-            {
-                retry_count = max_retries; // Exit the loop if successful
-            }
+    if (length < 0 || (size_t)length >= sizeof(body))
+    {
+        log_error("Bookkeeping request body too long, request dropped");
+        return;
+    }
 
-            curl_slist_free_all(headers);
-            curl_easy_cleanup(curl);
-            json_object_put(jobj);
+    do
+    {
+        rc = http_client_post_json(gateway, "/bookKeeping", body, length, NULL, 0, NULL);
+        if (rc == -1)
+        {
+            log_error_with_retry("curl_easy_perform() failed", retry_count);
+            retry_count++;
+            Thread_sleep(2000 * retry_count); // Exponential backoff
         }
-    } while (res != CURLE_OK && retry_count < max_retries);
+    } while (rc == -1 && retry_count < max_retries);
 
-    curl_global_cleanup();
-
-    // Record end time
-    clock_gettime(CLOCK_REALTIME, &end);
-
-    // Calculate time difference
-    double time_spent = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
-    printf("Time taken for BookKeeping: %.9f seconds\n", time_spent);
+    uint64_t time_spent = metrics_span_end(metrics, stageBookKeeping, start);
+    printf("Time taken for BookKeeping: %.9f seconds\n", time_spent / 1e9);
 }
 
-void *handle_bookkeeping(void *arg)
+void handle_bookkeeping(const BookkeepingArgs *args, void *parameter)
 {
-    bookkeeping_api(published_timestamp_str, stNum, statusBool ? "TRUE" : "FALSE", bookkeeping_status);
-    return NULL;
+    bookkeeping_api(args->published_timestamp_str, args->stNum, args->statusBool ? "TRUE" : "FALSE", args->bookkeeping_status);
 }
 
-// Publish function
+// Publish a new state. The scheduler sends it right away and then keeps repeating it.
 void publish(GoosePublisher publisher)
 {
-    LinkedList dataSetValues = LinkedList_create();
+    uint64_t eventTime = metrics_wall_now();
+
+    GooseRetransmissionScheduler_lock(scheduler);
+
     statusBool = (rdso_status == 1); // True for CLOSED, False for OPEN
-    LinkedList_add(dataSetValues, MmsValue_newBoolean(statusBool));
+    MmsValue_setBoolean(statusValue, statusBool);
+    GoosePublisher_updateFrameValues(publisher);
+
+    GoosePublisher_setStNum(publisher, stNum);
+    GoosePublisher_setSqNum(publisher, 0);
 
     // Generate the current timestamp and set it for the publisher
-    uint64_t currentTime = Hal_getTimeInMs();
-    GoosePublisher_setTimestamp(publisher, currentTime);
+    uint64_t currentTime = Hal_getTimeInNs();
+    GoosePublisher_setTimestampNs(publisher, currentTime);
 
-    formatUtcTime(published_timestamp_str, sizeof(published_timestamp_str), currentTime);
+    utc_time_format(&publishedTimeFormat, published_timestamp_str, sizeof(published_timestamp_str), currentTime);
 
-    if (update)
-    {
-        update = 0;
-        pthread_t update_thread;
-        pthread_create(&update_thread, NULL, handle_bookkeeping, NULL);
-        pthread_detach(update_thread); // Automatically reclaim thread resources when done
-    }
+    GooseRetransmissionScheduler_unlock(scheduler);
+
+    uint64_t txTimestamp;
 
-    if (GoosePublisher_publish(publisher, dataSetValues) == -1)
+    if (GooseRetransmissionScheduler_triggerEventEx(scheduler, publisher, &txTimestamp) == false)
     {
         log_error("Error sending GOOSE message");
     }
+    else
+    {
+        metrics_record_wall_span(metrics, stageEventToWire, eventTime, txTimestamp);
+    }
 
-    LinkedList_destroyDeep(dataSetValues, (LinkedListValueDeleteFunction)MmsValue_delete);
+    // Snapshot the published state so the worker never reads the globals
+    BookkeepingArgs args;
+    memcpy(args.published_timestamp_str, published_timestamp_str, sizeof(args.published_timestamp_str));
+    args.stNum = stNum;
+    args.statusBool = statusBool;
+    strncpy(args.bookkeeping_status, bookkeeping_status, sizeof(args.bookkeeping_status));
+
+    bookkeeping_worker_submit(bookkeeper, &args, 0);
+}
+
+// Sequence counters of a subscriber, logged at shutdown
+void log_subscriber_counters(const char *name, GooseSubscriber subscriber)
+{
+    GooseSubscriberCounters counters;
+    GooseSubscriber_getCounters(subscriber, &counters);
+
+    log_info("GOOSE %s: %llu new events (%llu missed), %llu retransmissions (%llu missed), "
+             "%llu out of order, %llu duplicates, %llu stNum rollbacks, %llu TTL expiries",
+             name, (unsigned long long)counters.newEvents, (unsigned long long)counters.missedEvents,
+             (unsigned long long)counters.retransmissions, (unsigned long long)counters.missedRetransmissions,
+             (unsigned long long)counters.outOfOrder, (unsigned long long)counters.duplicates,
+             (unsigned long long)counters.stNumRollbacks, (unsigned long long)counters.ttlExpiries);
 }
 
 void gooseListener(GooseSubscriber subscriber, void *parameter)
 {
+    // From the frame entering the network stack to this callback
+    metrics_record_wall_span(metrics, stageWireToCallback, GooseSubscriber_getReceiveTimestampNs(subscriber), metrics_wall_now());
+
     uint8_t src[6], dst[6];
     GooseSubscriber_getSrcMac(subscriber, src);
     GooseSubscriber_getDstMac(subscriber, dst);
@@ -172,18 +226,15 @@ void gooseListener(GooseSubscriber subscriber, void *parameter)
     sprintf(srcStr, "%02x:%02x:%02x:%02x:%02x:%02x", src[0], src[1], src[2], src[3], src[4], src[5]);
     sprintf(dstStr, "%02x:%02x:%02x:%02x:%02x:%02x", dst[0], dst[1], dst[2], dst[3], dst[4], dst[5]);
 
-    formatUtcTime(subscribed_timestamp_str, sizeof(subscribed_timestamp_str), GooseSubscriber_getTimestamp(subscriber));
+    utc_time_format(&subscribedTimeFormat, subscribed_timestamp_str, sizeof(subscribed_timestamp_str),
+                    GooseSubscriber_getTimestamp(subscriber) * 1000000ULL);
 
-    if (subscribed_stNum != GooseSubscriber_getStNum(subscriber))
-    {
-        subscribed_stNum = GooseSubscriber_getStNum(subscriber);
-    }
+    subscribed_stNum = GooseSubscriber_getStNum(subscriber);
 
-    MmsValue *values = GooseSubscriber_getDataSetValues(subscriber);
-    MmsValue_printToBuffer(values, subscribed_data, sizeof(subscribed_data));
-    // Update subscribed_data with a boolean value
-    size_t length = strlen(subscribed_data);
-    if (length == 6)
+    // The data set is a single boolean, read it straight from the received allData
+    bool status = false;
+    GooseSubscriber_getElementBoolean(subscriber, 0, &status);
+    if (status)
     {
         strcpy(subscribed_data, "TRUE");
     }
@@ -206,9 +257,34 @@ int main(int argc, char **argv)
 {
     signal(SIGINT, sigint_handler);
     pthread_mutex_init(&lock, NULL); // Initialize the mutex
+    utc_time_formatter_init(&publishedTimeFormat, 3);
+    utc_time_formatter_init(&subscribedTimeFormat, 3);
     char *interface = (argc > 1) ? argv[1] : "ens37";
+    const char *metricsTarget = (argc > 2) ? argv[2] : METRICS_TARGET;
     log_info("Using interface %s", interface);
 
+    gateway = http_client_create(GATEWAY_URL, 5000L);
+    if (gateway == NULL)
+    {
+        log_error("Failed to create HTTP client for %s", GATEWAY_URL);
+        return EXIT_FAILURE;
+    }
+
+    if (metrics_setup(metricsTarget) == false)
+    {
+        log_error("Failed to create latency metrics");
+        http_client_destroy(gateway);
+        return EXIT_FAILURE;
+    }
+
+    bookkeeper = bookkeeping_worker_start(handle_bookkeeping, NULL);
+    if (bookkeeper == NULL)
+    {
+        log_error("Failed to start bookkeeping worker");
+        http_client_destroy(gateway);
+        return EXIT_FAILURE;
+    }
+
     GooseReceiver receiver = GooseReceiver_create();
     if (receiver == NULL)
     {
@@ -232,7 +308,9 @@ int main(int argc, char **argv)
     {
         GooseSubscriber_setDstMac(subscriberIPP, dstMac);
         GooseSubscriber_setAppId(subscriberIPP, 1000);
+        GooseSubscriber_setCompiledDecoding(subscriberIPP, true);
         GooseSubscriber_setListener(subscriberIPP, gooseListener, NULL);
+        GooseSubscriber_setListenerClasses(subscriberIPP, SUBSCRIBER_FRAME_CLASSES);
         GooseReceiver_addSubscriber(receiver, subscriberIPP);
     }
 
@@ -246,10 +324,14 @@ int main(int argc, char **argv)
     {
         GooseSubscriber_setDstMac(subscriberX, dstMac);
         GooseSubscriber_setAppId(subscriberX, 1000);
+        GooseSubscriber_setCompiledDecoding(subscriberX, true);
         GooseSubscriber_setListener(subscriberX, gooseListener, NULL);
+        GooseSubscriber_setListenerClasses(subscriberX, SUBSCRIBER_FRAME_CLASSES);
         GooseReceiver_addSubscriber(receiver, subscriberX);
     }
 
+    // Kernel receive timestamps for the wireToCallback stage
+    GooseReceiver_enableTimestamping(receiver, false);
     GooseReceiver_start(receiver);
 
     CommParameters gooseCommParameters = {0};
@@ -266,53 +348,93 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 
+    // Kernel transmit timestamps for the eventToWire stage
+    if (GoosePublisher_enableTimestamping(publisher, false) == false)
+    {
+        log_error("No transmit timestamps on %s", interface);
+    }
+
     GoosePublisher_setGoCbRef(publisher, gocbRef);
     GoosePublisher_setConfRev(publisher, 1);
     GoosePublisher_setDataSetRef(publisher, datSet);
     GoosePublisher_setTimeAllowedToLive(publisher, 5000);
     GoosePublisher_setGoID(publisher, goID);
 
+    // Encode the frame once, publish() only patches the changing fields
+    dataSetValues = LinkedList_create();
+    statusValue = MmsValue_newBoolean(statusBool);
+    LinkedList_add(dataSetValues, statusValue);
+
+    if (GoosePublisher_prepareFrameTemplate(publisher, dataSetValues) == false)
+    {
+        log_error("Failed to prepare GOOSE frame template");
+    }
+
+    scheduler = GooseRetransmissionScheduler_create(1);
+    GooseRetransmissionScheduler_addPublisher(scheduler, publisher, GOOSE_MIN_TIME, GOOSE_MAX_TIME);
+
+    // Real-time retransmissions, the HTTP and validation threads must not delay them
+    if (GooseRetransmissionScheduler_startRealtime(scheduler, PUBLISHER_RT_PRIORITY, PUBLISHER_CPU, true) == false)
+    {
+        log_error("Real-time publishing not available, retransmission jitter is not bounded");
+    }
+
     int toggleCounter = 0;
     int count = 0;
+    // Absolute deadlines, the time spent in publish() does not shift the following events
+    uint64_t deadline = Hal_getMonotonicTimeInNs();
     while (count <= 10)
     {
         if (count == 5)
         {
             count++;
-            Thread_sleep(26000); // Sleep for 25 seconds
+            deadline += 26000 * 1000000ULL; // Sleep for 25 seconds
+            Thread_sleepUntil(deadline);
         }
         if (GooseReceiver_isRunning(receiver))
         {
-            pthread_mutex_lock(&lock); // Lock the mutex
+            // Only state changes are published here, the scheduler does the retransmissions
             if (toggleCounter++ % 5 == 0)
             {
-                int old_status = rdso_status;
+                pthread_mutex_lock(&lock); // Lock the mutex
                 rdso_status = !rdso_status;
-                if (old_status != rdso_status)
-                {
-                    stNum++;
-                    sqNum = 0;
-                    update = 1;
-                    count++;
-                }
-            }
-            else
-            {
-                sqNum++;
-            }
-            GoosePublisher_setStNum(publisher, stNum);
-            GoosePublisher_setSqNum(publisher, sqNum);
-
-            pthread_mutex_unlock(&lock); // Unlock the mutex
+                stNum++;
+                count++;
+                pthread_mutex_unlock(&lock); // Unlock the mutex
 
-            publish(publisher);
-            Thread_sleep(1000); // Sleep for 5 seconds
+                uint64_t publishStart = metrics_now();
+                publish(publisher);
+                metrics_span_end(metrics, stagePublish, publishStart);
+            }
+            deadline += 1000 * 1000000ULL; // Sleep for 1 second
+            Thread_sleepUntil(deadline);
         }
     }
 
+    log_info("Sent %llu GOOSE frames", (unsigned long long)GooseRetransmissionScheduler_getSentFrames(scheduler));
+
+    GooseRetransmissionDeadlineStats deadlineStats;
+    GooseRetransmissionScheduler_getDeadlineStats(scheduler, &deadlineStats);
+    log_info("Publisher: %llu cycles, %llu missed deadlines, max lateness %llu us",
+             (unsigned long long)deadlineStats.cycles, (unsigned long long)deadlineStats.missedDeadlines,
+             (unsigned long long)(deadlineStats.maxLateness / 1000));
+    GooseRetransmissionScheduler_destroy(scheduler);
     GoosePublisher_destroy(publisher);
+    LinkedList_destroyDeep(dataSetValues, (LinkedListValueDeleteFunction)MmsValue_delete);
     GooseReceiver_stop(receiver);
+    log_subscriber_counters("IPP", subscriberIPP);
+    log_subscriber_counters("X", subscriberX);
     GooseReceiver_destroy(receiver);
+
+    BookkeepingStats stats;
+    bookkeeping_worker_stop(bookkeeper, &stats);
+    log_info("Bookkeeping: %llu submitted, %llu processed, %llu dropped, max queue depth %u",
+             (unsigned long long)stats.submitted, (unsigned long long)stats.processed,
+             (unsigned long long)stats.dropped, stats.highWatermark);
+
+    metrics_shutdown();
+
+    http_client_destroy(gateway);
     pthread_mutex_destroy(&lock); // Destroy the mutex
     log_info("Application terminated gracefully");
 
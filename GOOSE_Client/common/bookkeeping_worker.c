@@ -0,0 +1,170 @@
+// bookkeeping_worker.c
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "bookkeeping_worker.h"
+
+#define QUEUE_MASK (BOOKKEEPING_QUEUE_SIZE - 1)
+
+struct sBookkeepingWorker
+{
+    BookkeepingArgs ring[BOOKKEEPING_QUEUE_SIZE];
+
+    // head is only written by the worker, tail only by the producer
+    uint32_t head;
+    uint32_t tail;
+
+    sem_t freeSlots;
+    sem_t filledSlots;
+
+    BookkeepingHandler handler;
+    void *handlerParameter;
+
+    pthread_t thread;
+    int stopping;
+
+    uint64_t submitted;
+    uint64_t dropped;
+    uint64_t processed;
+    uint32_t highWatermark;
+};
+
+static void *worker_loop(void *arg)
+{
+    BookkeepingWorker self = (BookkeepingWorker)arg;
+
+    while (1)
+    {
+        while (sem_wait(&self->filledSlots) == -1 && errno == EINTR)
+            ;
+
+        uint32_t head = self->head;
+
+        // An empty ring after a wakeup means stop was requested
+        if (head == __atomic_load_n(&self->tail, __ATOMIC_ACQUIRE))
+        {
+            if (__atomic_load_n(&self->stopping, __ATOMIC_ACQUIRE))
+                break;
+
+            continue;
+        }
+
+        self->handler(&self->ring[head & QUEUE_MASK], self->handlerParameter);
+
+        __atomic_store_n(&self->head, head + 1, __ATOMIC_RELEASE);
+        __atomic_fetch_add(&self->processed, 1, __ATOMIC_RELAXED);
+
+        sem_post(&self->freeSlots);
+    }
+
+    return NULL;
+}
+
+BookkeepingWorker bookkeeping_worker_start(BookkeepingHandler handler, void *parameter)
+{
+    BookkeepingWorker self = (BookkeepingWorker)calloc(1, sizeof(struct sBookkeepingWorker));
+
+    if (self == NULL)
+        return NULL;
+
+    self->handler = handler;
+    self->handlerParameter = parameter;
+
+    sem_init(&self->freeSlots, 0, BOOKKEEPING_QUEUE_SIZE);
+    sem_init(&self->filledSlots, 0, 0);
+
+    if (pthread_create(&self->thread, NULL, worker_loop, self) != 0)
+    {
+        perror("Failed to create bookkeeping worker thread");
+        sem_destroy(&self->freeSlots);
+        sem_destroy(&self->filledSlots);
+        free(self);
+        return NULL;
+    }
+
+    return self;
+}
+
+static bool wait_for_free_slot(BookkeepingWorker self, int timeoutMs)
+{
+    if (sem_trywait(&self->freeSlots) == 0)
+        return true;
+
+    if (timeoutMs <= 0)
+        return false;
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeoutMs / 1000;
+    deadline.tv_nsec += (long)(timeoutMs % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    int rc;
+    while ((rc = sem_timedwait(&self->freeSlots, &deadline)) == -1 && errno == EINTR)
+        ;
+
+    return (rc == 0);
+}
+
+bool bookkeeping_worker_submit(BookkeepingWorker self, const BookkeepingArgs *args, int timeoutMs)
+{
+    __atomic_fetch_add(&self->submitted, 1, __ATOMIC_RELAXED);
+
+    if (wait_for_free_slot(self, timeoutMs) == false)
+    {
+        __atomic_fetch_add(&self->dropped, 1, __ATOMIC_RELAXED);
+        fprintf(stderr, "Bookkeeping queue full, dropped record for stNum %u\n", args->stNum);
+        return false;
+    }
+
+    uint32_t tail = self->tail;
+
+    memcpy(&self->ring[tail & QUEUE_MASK], args, sizeof(BookkeepingArgs));
+
+    __atomic_store_n(&self->tail, tail + 1, __ATOMIC_RELEASE);
+
+    uint32_t depth = tail + 1 - __atomic_load_n(&self->head, __ATOMIC_ACQUIRE);
+    if (depth > self->highWatermark)
+        self->highWatermark = depth;
+
+    sem_post(&self->filledSlots);
+
+    return true;
+}
+
+void bookkeeping_worker_get_stats(BookkeepingWorker self, BookkeepingStats *stats)
+{
+    stats->submitted = __atomic_load_n(&self->submitted, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&self->dropped, __ATOMIC_RELAXED);
+    stats->processed = __atomic_load_n(&self->processed, __ATOMIC_RELAXED);
+    stats->highWatermark = self->highWatermark;
+}
+
+void bookkeeping_worker_stop(BookkeepingWorker self, BookkeepingStats *finalStats)
+{
+    if (self == NULL)
+        return;
+
+    __atomic_store_n(&self->stopping, 1, __ATOMIC_RELEASE);
+    sem_post(&self->filledSlots);
+
+    pthread_join(self->thread, NULL);
+
+    if (finalStats)
+        bookkeeping_worker_get_stats(self, finalStats);
+
+    sem_destroy(&self->freeSlots);
+    sem_destroy(&self->filledSlots);
+    free(self);
+}
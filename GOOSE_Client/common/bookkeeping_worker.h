@@ -0,0 +1,47 @@
+// bookkeeping_worker.h
+#ifndef BOOKKEEPING_WORKER_H
+#define BOOKKEEPING_WORKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Ring capacity in records, must be a power of two
+#define BOOKKEEPING_QUEUE_SIZE 64
+
+// One ledger write. Fixed size so records are copied into the ring by value.
+typedef struct
+{
+    char published_timestamp_str[64];
+    uint32_t stNum;
+    bool statusBool;
+    char bookkeeping_status[24];
+} BookkeepingArgs;
+
+typedef struct
+{
+    uint64_t submitted;
+    uint64_t dropped;
+    uint64_t processed;
+    uint32_t highWatermark; // deepest queue seen
+} BookkeepingStats;
+
+typedef void (*BookkeepingHandler)(const BookkeepingArgs *args, void *parameter);
+
+typedef struct sBookkeepingWorker *BookkeepingWorker;
+
+// Start the long-lived worker thread that runs handler for every submitted record
+BookkeepingWorker bookkeeping_worker_start(BookkeepingHandler handler, void *parameter);
+
+// Copy args into the ring. Single producer: concurrent callers must be
+// serialised by the caller. When the ring is full the call waits up to
+// timeoutMs for space (0 = do not wait) and otherwise drops the record.
+// Returns false if the record was dropped.
+bool bookkeeping_worker_submit(BookkeepingWorker self, const BookkeepingArgs *args, int timeoutMs);
+
+void bookkeeping_worker_get_stats(BookkeepingWorker self, BookkeepingStats *stats);
+
+// Process everything still queued, then join and free the worker.
+// The final counters are stored in finalStats if it is not NULL.
+void bookkeeping_worker_stop(BookkeepingWorker self, BookkeepingStats *finalStats);
+
+#endif // BOOKKEEPING_WORKER_H
@@ -0,0 +1,313 @@
+// http_client.c
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <curl/curl.h>
+
+#include "http_client.h"
+
+typedef struct
+{
+    CURL *curl;
+    bool busy;
+    char url[HTTP_CLIENT_URL_SIZE]; // URL currently set on the handle
+    char *response;
+    size_t responseSize;
+    size_t responseLength;
+} HttpSlot;
+
+struct sHttpClient
+{
+    char baseUrl[HTTP_CLIENT_URL_SIZE];
+    CURLSH *share;
+    pthread_mutex_t shareLocks[CURL_LOCK_DATA_LAST];
+    struct curl_slist *headers;
+
+    HttpSlot slots[HTTP_CLIENT_POOL_SIZE];
+    pthread_mutex_t poolLock;
+    pthread_cond_t poolCond;
+
+    HttpClientTimingHandler timingHandler;
+    void *timingHandlerParameter;
+};
+
+static pthread_once_t globalInitOnce = PTHREAD_ONCE_INIT;
+static CURLcode globalInitResult = CURLE_FAILED_INIT;
+
+// curl_global_init is not thread safe and is expensive, so it is done exactly
+// once for the process and intentionally never undone.
+static void global_init(void)
+{
+    globalInitResult = curl_global_init(CURL_GLOBAL_ALL);
+}
+
+static void share_lock(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr)
+{
+    HttpClient self = (HttpClient)userptr;
+    pthread_mutex_lock(&self->shareLocks[data]);
+}
+
+static void share_unlock(CURL *handle, curl_lock_data data, void *userptr)
+{
+    HttpClient self = (HttpClient)userptr;
+    pthread_mutex_unlock(&self->shareLocks[data]);
+}
+
+static size_t write_callback(void *ptr, size_t size, size_t nmemb, void *userdata)
+{
+    HttpSlot *slot = (HttpSlot *)userdata;
+    size_t total_size = size * nmemb;
+
+    if (slot->response && slot->responseSize > 0)
+    {
+        size_t space = slot->responseSize - 1 - slot->responseLength;
+        size_t copied = (total_size < space) ? total_size : space;
+
+        memcpy(slot->response + slot->responseLength, ptr, copied);
+        slot->responseLength += copied;
+        slot->response[slot->responseLength] = '\0';
+    }
+
+    return total_size;
+}
+
+HttpClient http_client_create(const char *baseUrl, long timeoutMs)
+{
+    pthread_once(&globalInitOnce, global_init);
+
+    if (globalInitResult != CURLE_OK)
+        return NULL;
+
+    HttpClient self = (HttpClient)calloc(1, sizeof(struct sHttpClient));
+
+    if (self == NULL)
+        return NULL;
+
+    strncpy(self->baseUrl, baseUrl, sizeof(self->baseUrl) - 1);
+
+    int i;
+    for (i = 0; i < CURL_LOCK_DATA_LAST; i++)
+        pthread_mutex_init(&self->shareLocks[i], NULL);
+
+    pthread_mutex_init(&self->poolLock, NULL);
+    pthread_cond_init(&self->poolCond, NULL);
+
+    // Connections, DNS and TLS sessions are shared so that any pooled handle
+    // can pick up a socket warmed by another one.
+    self->share = curl_share_init();
+    if (self->share)
+    {
+        curl_share_setopt(self->share, CURLSHOPT_LOCKFUNC, share_lock);
+        curl_share_setopt(self->share, CURLSHOPT_UNLOCKFUNC, share_unlock);
+        curl_share_setopt(self->share, CURLSHOPT_USERDATA, self);
+        curl_share_setopt(self->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(self->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+        curl_share_setopt(self->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+
+    self->headers = curl_slist_append(self->headers, "Content-Type: application/json");
+    self->headers = curl_slist_append(self->headers, "Expect:");
+
+    for (i = 0; i < HTTP_CLIENT_POOL_SIZE; i++)
+    {
+        HttpSlot *slot = &self->slots[i];
+        CURL *curl = curl_easy_init();
+
+        if (curl == NULL)
+        {
+            http_client_destroy(self);
+            return NULL;
+        }
+
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeoutMs);
+        curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, self->headers);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, slot);
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+
+        if (self->share)
+            curl_easy_setopt(curl, CURLOPT_SHARE, self->share);
+
+        slot->curl = curl;
+    }
+
+    return self;
+}
+
+void http_client_destroy(HttpClient self)
+{
+    if (self == NULL)
+        return;
+
+    int i;
+    for (i = 0; i < HTTP_CLIENT_POOL_SIZE; i++)
+    {
+        if (self->slots[i].curl)
+            curl_easy_cleanup(self->slots[i].curl);
+    }
+
+    if (self->share)
+        curl_share_cleanup(self->share);
+
+    curl_slist_free_all(self->headers);
+
+    for (i = 0; i < CURL_LOCK_DATA_LAST; i++)
+        pthread_mutex_destroy(&self->shareLocks[i]);
+
+    pthread_mutex_destroy(&self->poolLock);
+    pthread_cond_destroy(&self->poolCond);
+
+    free(self);
+}
+
+void http_client_set_timing_handler(HttpClient self, HttpClientTimingHandler handler, void *parameter)
+{
+    self->timingHandler = handler;
+    self->timingHandlerParameter = parameter;
+}
+
+static HttpSlot *acquire_slot(HttpClient self)
+{
+    HttpSlot *slot = NULL;
+
+    pthread_mutex_lock(&self->poolLock);
+
+    while (slot == NULL)
+    {
+        int i;
+        for (i = 0; i < HTTP_CLIENT_POOL_SIZE; i++)
+        {
+            if (self->slots[i].busy == false)
+            {
+                slot = &self->slots[i];
+                slot->busy = true;
+                break;
+            }
+        }
+
+        if (slot == NULL)
+            pthread_cond_wait(&self->poolCond, &self->poolLock);
+    }
+
+    pthread_mutex_unlock(&self->poolLock);
+
+    return slot;
+}
+
+static void release_slot(HttpClient self, HttpSlot *slot)
+{
+    pthread_mutex_lock(&self->poolLock);
+    slot->busy = false;
+    slot->response = NULL;
+    pthread_cond_signal(&self->poolCond);
+    pthread_mutex_unlock(&self->poolLock);
+}
+
+int http_client_post_json(HttpClient self, const char *path, const char *body, size_t bodyLength,
+                          char *response, size_t responseSize, HttpClientTiming *timing)
+{
+    HttpSlot *slot = acquire_slot(self);
+    CURL *curl = slot->curl;
+
+    char url[HTTP_CLIENT_URL_SIZE];
+    snprintf(url, sizeof(url), "%s%s", self->baseUrl, path);
+
+    // Only touch the URL when it changes, the rest of the handle stays as configured
+    if (strcmp(url, slot->url) != 0)
+    {
+        memcpy(slot->url, url, sizeof(slot->url));
+        curl_easy_setopt(curl, CURLOPT_URL, slot->url);
+    }
+
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)bodyLength);
+
+    slot->response = response;
+    slot->responseSize = responseSize;
+    slot->responseLength = 0;
+
+    if (response && responseSize > 0)
+        response[0] = '\0';
+
+    CURLcode res = curl_easy_perform(curl);
+
+    HttpClientTiming localTiming;
+    memset(&localTiming, 0, sizeof(localTiming));
+
+    long numConnects = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME, &localTiming.nameLookup);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &localTiming.connect);
+    curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME, &localTiming.preTransfer);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &localTiming.startTransfer);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &localTiming.total);
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &localTiming.responseCode);
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &numConnects);
+    localTiming.connectionReused = (numConnects == 0);
+
+    release_slot(self, slot);
+
+    if (timing)
+        *timing = localTiming;
+
+    if (self->timingHandler)
+        self->timingHandler(path, &localTiming, self->timingHandlerParameter);
+
+    if (res != CURLE_OK)
+    {
+        fprintf(stderr, "POST %s failed: %s\n", path, curl_easy_strerror(res));
+        return -1;
+    }
+
+    return (int)localTiming.responseCode;
+}
+
+int http_client_json_escape(char *buffer, size_t size, const char *value)
+{
+    size_t length = 0;
+
+    for (const unsigned char *c = (const unsigned char *)value; *c; c++)
+    {
+        char escaped[8];
+        size_t count;
+
+        switch (*c)
+        {
+        case '"':  count = (size_t)snprintf(escaped, sizeof(escaped), "\\\""); break;
+        case '\\': count = (size_t)snprintf(escaped, sizeof(escaped), "\\\\"); break;
+        case '/':  count = (size_t)snprintf(escaped, sizeof(escaped), "\\/"); break;
+        case '\b': count = (size_t)snprintf(escaped, sizeof(escaped), "\\b"); break;
+        case '\f': count = (size_t)snprintf(escaped, sizeof(escaped), "\\f"); break;
+        case '\n': count = (size_t)snprintf(escaped, sizeof(escaped), "\\n"); break;
+        case '\r': count = (size_t)snprintf(escaped, sizeof(escaped), "\\r"); break;
+        case '\t': count = (size_t)snprintf(escaped, sizeof(escaped), "\\t"); break;
+        default:
+            if (*c < 0x20)
+                count = (size_t)snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+            else
+            {
+                escaped[0] = (char)*c;
+                count = 1;
+            }
+            break;
+        }
+
+        if (length + count >= size)
+            return -1;
+
+        memcpy(buffer + length, escaped, count);
+        length += count;
+    }
+
+    if (size == 0)
+        return -1;
+
+    buffer[length] = '\0';
+
+    return (int)length;
+}
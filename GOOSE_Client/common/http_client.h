@@ -0,0 +1,50 @@
+// http_client.h
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// Number of easy handles kept warm per client. Bookkeeping and validation can
+// overlap, so one handle is not enough; more than a few is never needed.
+#define HTTP_CLIENT_POOL_SIZE 4
+
+#define HTTP_CLIENT_URL_SIZE 256
+
+typedef struct sHttpClient *HttpClient;
+
+// Per-request timings as reported by libcurl, in seconds from request start
+typedef struct
+{
+    double nameLookup;
+    double connect;
+    double preTransfer;
+    double startTransfer;
+    double total;
+    long responseCode;
+    bool connectionReused;
+} HttpClientTiming;
+
+typedef void (*HttpClientTimingHandler)(const char *path, const HttpClientTiming *timing, void *parameter);
+
+// Create a client for one gateway, e.g. "http://192.168.37.145:3001".
+// curl_global_init is performed once per process on the first call.
+HttpClient http_client_create(const char *baseUrl, long timeoutMs);
+
+void http_client_destroy(HttpClient self);
+
+// Called after every request with the curl timings of that request
+void http_client_set_timing_handler(HttpClient self, HttpClientTimingHandler handler, void *parameter);
+
+// POST a JSON body to baseUrl + path on a pooled keep-alive connection.
+// The response body is copied (NUL terminated, truncated) to response if not NULL.
+// Returns the HTTP status code or -1 on transport failure.
+int http_client_post_json(HttpClient self, const char *path, const char *body, size_t bodyLength,
+                          char *response, size_t responseSize, HttpClientTiming *timing);
+
+// Escape value for use inside a JSON string literal, the same way json-c does
+// (quotes, backslash, slash and control characters). The result is NUL terminated.
+// Returns the escaped length or -1 if it does not fit into buffer.
+int http_client_json_escape(char *buffer, size_t size, const char *value);
+
+#endif // HTTP_CLIENT_H
@@ -0,0 +1,422 @@
+// latency_metrics.c
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "latency_metrics.h"
+
+#define SUB_BUCKET_COUNT (1 << METRICS_SUB_BUCKET_BITS)
+#define SUB_BUCKET_MASK (SUB_BUCKET_COUNT - 1)
+#define BUCKET_COUNT ((METRICS_MAX_VALUE_BITS - METRICS_SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT)
+
+#define SNAPSHOT_SIZE 4096
+
+typedef struct
+{
+    char name[METRICS_STAGE_NAME_SIZE];
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[BUCKET_COUNT];
+} MetricsStage;
+
+struct sMetrics
+{
+    MetricsStage *stages[METRICS_MAX_STAGES];
+    int stageCount;
+
+    // Exporter
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool exporting;
+    int intervalMs;
+    FILE *file;
+    int udpSocket;
+    struct sockaddr_in udpAddress;
+};
+
+static int bucket_index(uint64_t value)
+{
+    if (value < SUB_BUCKET_COUNT)
+        return (int)value;
+
+    int exponent = 63 - __builtin_clzll(value);
+
+    if (exponent >= METRICS_MAX_VALUE_BITS)
+        return BUCKET_COUNT - 1;
+
+    int shift = exponent - METRICS_SUB_BUCKET_BITS;
+
+    return ((shift + 1) << METRICS_SUB_BUCKET_BITS) + (int)((value >> shift) & SUB_BUCKET_MASK);
+}
+
+// Largest value that falls into the bucket
+static uint64_t bucket_upper_bound(int index)
+{
+    if (index < SUB_BUCKET_COUNT)
+        return (uint64_t)index;
+
+    int shift = (index >> METRICS_SUB_BUCKET_BITS) - 1;
+    uint64_t lower = (uint64_t)(SUB_BUCKET_COUNT + (index & SUB_BUCKET_MASK)) << shift;
+
+    return lower + ((uint64_t)1 << shift) - 1;
+}
+
+Metrics metrics_create(void)
+{
+    Metrics self = (Metrics)calloc(1, sizeof(struct sMetrics));
+
+    if (self == NULL)
+        return NULL;
+
+    pthread_mutex_init(&self->mutex, NULL);
+    pthread_cond_init(&self->cond, NULL);
+    self->udpSocket = -1;
+
+    return self;
+}
+
+int metrics_add_stage(Metrics self, const char *name)
+{
+    if (self->stageCount == METRICS_MAX_STAGES)
+        return -1;
+
+    MetricsStage *stage = (MetricsStage *)calloc(1, sizeof(MetricsStage));
+
+    if (stage == NULL)
+        return -1;
+
+    strncpy(stage->name, name, METRICS_STAGE_NAME_SIZE - 1);
+
+    self->stages[self->stageCount] = stage;
+
+    return self->stageCount++;
+}
+
+int metrics_get_stage_count(Metrics self)
+{
+    return self->stageCount;
+}
+
+const char *metrics_get_stage_name(Metrics self, int stage)
+{
+    if (stage < 0 || stage >= self->stageCount)
+        return NULL;
+
+    return self->stages[stage]->name;
+}
+
+uint64_t metrics_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+uint64_t metrics_wall_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+void metrics_record_wall_span(Metrics self, int stage, uint64_t startWallNs, uint64_t wallNs)
+{
+    if (startWallNs == 0 || wallNs < startWallNs)
+        return;
+
+    metrics_record(self, stage, wallNs - startWallNs);
+}
+
+void metrics_record(Metrics self, int stage, uint64_t valueNs)
+{
+    if (stage < 0 || stage >= self->stageCount)
+        return;
+
+    MetricsStage *s = self->stages[stage];
+
+    __atomic_fetch_add(&s->buckets[bucket_index(valueNs)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s->sum, valueNs, __ATOMIC_RELAXED);
+
+    uint64_t max = __atomic_load_n(&s->max, __ATOMIC_RELAXED);
+
+    while (valueNs > max &&
+           !__atomic_compare_exchange_n(&s->max, &max, valueNs, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+
+    // Published last, a reader never sees more samples than bucket entries
+    __atomic_fetch_add(&s->count, 1, __ATOMIC_RELEASE);
+}
+
+uint64_t metrics_span_end(Metrics self, int stage, uint64_t startNs)
+{
+    uint64_t elapsed = metrics_now() - startNs;
+
+    metrics_record(self, stage, elapsed);
+
+    return elapsed;
+}
+
+bool metrics_get_summary(Metrics self, int stage, MetricsSummary *summary)
+{
+    if (stage < 0 || stage >= self->stageCount)
+        return false;
+
+    MetricsStage *s = self->stages[stage];
+
+    memset(summary, 0, sizeof(MetricsSummary));
+
+    uint64_t count = __atomic_load_n(&s->count, __ATOMIC_ACQUIRE);
+
+    if (count == 0)
+        return true;
+
+    uint64_t max = __atomic_load_n(&s->max, __ATOMIC_RELAXED);
+
+    summary->count = count;
+    summary->max = max;
+    summary->mean = (double)__atomic_load_n(&s->sum, __ATOMIC_RELAXED) / count;
+
+    // Ranks of the percentiles, rounded up
+    uint64_t rank50 = (count * 500 + 999) / 1000;
+    uint64_t rank99 = (count * 990 + 999) / 1000;
+    uint64_t rank999 = (count * 999 + 999) / 1000;
+
+    uint64_t cumulative = 0;
+
+    for (int i = 0; i < BUCKET_COUNT && cumulative < rank999; i++)
+    {
+        uint64_t bucket = __atomic_load_n(&s->buckets[i], __ATOMIC_RELAXED);
+
+        if (bucket == 0)
+            continue;
+
+        cumulative += bucket;
+
+        uint64_t value = bucket_upper_bound(i);
+
+        if (value > max)
+            value = max;
+
+        if (summary->p50 == 0 && cumulative >= rank50)
+            summary->p50 = value;
+        if (summary->p99 == 0 && cumulative >= rank99)
+            summary->p99 = value;
+        if (cumulative >= rank999)
+            summary->p999 = value;
+    }
+
+    return true;
+}
+
+static int format_snapshot(Metrics self, char *buffer, size_t size)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    int length = snprintf(buffer, size, "{\"t\":%llu,\"stages\":[",
+                          (unsigned long long)now.tv_sec * 1000ULL + (unsigned long long)(now.tv_nsec / 1000000));
+
+    for (int i = 0; i < self->stageCount && length < (int)size; i++)
+    {
+        MetricsSummary summary;
+        metrics_get_summary(self, i, &summary);
+
+        length += snprintf(buffer + length, size - length,
+                           "%s{\"name\":\"%s\",\"count\":%llu,\"p50_us\":%.3f,\"p99_us\":%.3f,"
+                           "\"p999_us\":%.3f,\"max_us\":%.3f,\"mean_us\":%.3f}",
+                           (i > 0) ? "," : "", self->stages[i]->name, (unsigned long long)summary.count,
+                           summary.p50 / 1e3, summary.p99 / 1e3, summary.p999 / 1e3, summary.max / 1e3,
+                           summary.mean / 1e3);
+    }
+
+    if (length < (int)size)
+        length += snprintf(buffer + length, size - length, "]}\n");
+
+    if (length >= (int)size)
+        return -1; // truncated JSON is useless for the consumer
+
+    return length;
+}
+
+static void export_snapshot(Metrics self)
+{
+    char buffer[SNAPSHOT_SIZE];
+
+    int length = format_snapshot(self, buffer, sizeof(buffer));
+
+    if (length < 0)
+    {
+        fprintf(stderr, "Metrics snapshot too large\n");
+        return;
+    }
+
+    if (self->file)
+    {
+        fputs(buffer, self->file);
+        fflush(self->file);
+    }
+    else if (self->udpSocket != -1)
+    {
+        sendto(self->udpSocket, buffer, length, 0, (struct sockaddr *)&self->udpAddress, sizeof(self->udpAddress));
+    }
+}
+
+static void *exporter_loop(void *arg)
+{
+    Metrics self = (Metrics)arg;
+
+    pthread_mutex_lock(&self->mutex);
+
+    while (self->exporting)
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+
+        deadline.tv_sec += self->intervalMs / 1000;
+        deadline.tv_nsec += (long)(self->intervalMs % 1000) * 1000000L;
+
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        int rc = 0;
+
+        while (self->exporting && rc != ETIMEDOUT)
+            rc = pthread_cond_timedwait(&self->cond, &self->mutex, &deadline);
+
+        // Also runs once after stop was requested, so the final state is exported
+        pthread_mutex_unlock(&self->mutex);
+        export_snapshot(self);
+        pthread_mutex_lock(&self->mutex);
+    }
+
+    pthread_mutex_unlock(&self->mutex);
+
+    return NULL;
+}
+
+static bool open_target(Metrics self, const char *target)
+{
+    if (strncmp(target, "file:", 5) == 0)
+    {
+        self->file = fopen(target + 5, "a");
+
+        return (self->file != NULL);
+    }
+
+    if (strncmp(target, "udp:", 4) == 0)
+    {
+        char host[64];
+        const char *port = strrchr(target + 4, ':');
+
+        if (port == NULL || (size_t)(port - (target + 4)) >= sizeof(host))
+            return false;
+
+        memcpy(host, target + 4, port - (target + 4));
+        host[port - (target + 4)] = 0;
+
+        memset(&self->udpAddress, 0, sizeof(self->udpAddress));
+        self->udpAddress.sin_family = AF_INET;
+        self->udpAddress.sin_port = htons((uint16_t)atoi(port + 1));
+
+        if (inet_pton(AF_INET, host, &self->udpAddress.sin_addr) != 1)
+            return false;
+
+        self->udpSocket = socket(AF_INET, SOCK_DGRAM, 0);
+
+        return (self->udpSocket != -1);
+    }
+
+    return false;
+}
+
+static void close_target(Metrics self)
+{
+    if (self->file)
+    {
+        fclose(self->file);
+        self->file = NULL;
+    }
+
+    if (self->udpSocket != -1)
+    {
+        close(self->udpSocket);
+        self->udpSocket = -1;
+    }
+}
+
+bool metrics_start_exporter(Metrics self, const char *target, int intervalMs)
+{
+    if (self->exporting || intervalMs <= 0)
+        return false;
+
+    if (open_target(self, target) == false)
+    {
+        close_target(self);
+        return false;
+    }
+
+    self->intervalMs = intervalMs;
+    self->exporting = true;
+
+    if (pthread_create(&self->thread, NULL, exporter_loop, self) != 0)
+    {
+        self->exporting = false;
+        close_target(self);
+        return false;
+    }
+
+    return true;
+}
+
+void metrics_stop_exporter(Metrics self)
+{
+    pthread_mutex_lock(&self->mutex);
+
+    if (self->exporting == false)
+    {
+        pthread_mutex_unlock(&self->mutex);
+        return;
+    }
+
+    self->exporting = false;
+    pthread_cond_signal(&self->cond);
+    pthread_mutex_unlock(&self->mutex);
+
+    pthread_join(self->thread, NULL);
+
+    close_target(self);
+}
+
+void metrics_destroy(Metrics self)
+{
+    if (self == NULL)
+        return;
+
+    metrics_stop_exporter(self);
+
+    for (int i = 0; i < self->stageCount; i++)
+        free(self->stages[i]);
+
+    pthread_mutex_destroy(&self->mutex);
+    pthread_cond_destroy(&self->cond);
+
+    free(self);
+}
@@ -0,0 +1,71 @@
+// latency_metrics.h
+#ifndef LATENCY_METRICS_H
+#define LATENCY_METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Maximum number of stages (histograms) per registry
+#define METRICS_MAX_STAGES 16
+
+#define METRICS_STAGE_NAME_SIZE 32
+
+// Log-linear histogram: every power of two is split into 2^METRICS_SUB_BUCKET_BITS
+// buckets, so a percentile is reported within 1/64 (1.6 %) of the recorded value.
+// Values from 2^METRICS_MAX_VALUE_BITS ns (~73 min) on share the last bucket.
+#define METRICS_SUB_BUCKET_BITS 6
+#define METRICS_MAX_VALUE_BITS 42
+
+typedef struct sMetrics *Metrics;
+
+// All values in nanoseconds
+typedef struct
+{
+    uint64_t count;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+    double mean;
+} MetricsSummary;
+
+Metrics metrics_create(void);
+
+// Register a histogram, returns its stage id or -1 when the registry is full.
+// Register all stages before recording starts, this call is not thread safe.
+int metrics_add_stage(Metrics self, const char *name);
+
+int metrics_get_stage_count(Metrics self);
+
+const char *metrics_get_stage_name(Metrics self, int stage);
+
+// CLOCK_MONOTONIC timestamp in ns, the start of a span
+uint64_t metrics_now(void);
+
+// CLOCK_REALTIME timestamp in ns, comparable with kernel packet timestamps
+uint64_t metrics_wall_now(void);
+
+// Record wallNs - startWallNs, both CLOCK_REALTIME. Ignores unknown (0) starts and
+// negative differences (clock steps, unsynchronised NIC clocks).
+void metrics_record_wall_span(Metrics self, int stage, uint64_t startWallNs, uint64_t wallNs);
+
+// Add one sample to a stage. Lock-free, can be called from any thread.
+void metrics_record(Metrics self, int stage, uint64_t valueNs);
+
+// Record the time since startNs (from metrics_now) and return it
+uint64_t metrics_span_end(Metrics self, int stage, uint64_t startNs);
+
+// Percentiles over all samples recorded so far. Returns false for an unknown stage.
+bool metrics_get_summary(Metrics self, int stage, MetricsSummary *summary);
+
+// Write a snapshot of all stages every intervalMs to target, one JSON object per line.
+// target is "file:<path>" (appended) or "udp:<ipv4 address>:<port>".
+bool metrics_start_exporter(Metrics self, const char *target, int intervalMs);
+
+// Write a final snapshot and stop the exporter thread
+void metrics_stop_exporter(Metrics self);
+
+// Stops the exporter if it is still running
+void metrics_destroy(Metrics self);
+
+#endif // LATENCY_METRICS_H
@@ -0,0 +1,446 @@
+// pcap_reader.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pcap_reader.h"
+
+#define PCAP_MAGIC_US 0xa1b2c3d4
+#define PCAP_MAGIC_NS 0xa1b23c4d
+
+#define PCAPNG_SECTION_HEADER 0x0a0d0d0a
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1a2b3c4d
+#define PCAPNG_INTERFACE_DESCRIPTION 1
+#define PCAPNG_SIMPLE_PACKET 3
+#define PCAPNG_ENHANCED_PACKET 6
+
+#define PCAPNG_OPTION_END 0
+#define PCAPNG_OPTION_IF_TSRESOL 9
+
+typedef struct
+{
+    int linkType;
+    uint32_t snapLength;
+    bool binaryResolution; // if_tsresol: 2^-resolution instead of 10^-resolution seconds
+    int resolution;
+} PcapInterface;
+
+struct sPcapReader
+{
+    FILE *file;
+    uint64_t position;
+    bool pcapng;
+    bool swapped; // file byte order differs from the host
+    const char *error;
+
+    // pcap
+    bool nanoseconds;
+    int linkType;
+
+    // pcapng, interfaces of the current section
+    PcapInterface *interfaces;
+    int interfaceCount;
+    int interfaceCapacity;
+
+    uint8_t *block;
+    uint32_t blockCapacity;
+};
+
+static uint16_t get16(PcapReader self, const uint8_t *p)
+{
+    uint16_t value;
+    memcpy(&value, p, 2);
+
+    return self->swapped ? (uint16_t)((value >> 8) | (value << 8)) : value;
+}
+
+static uint32_t get32(PcapReader self, const uint8_t *p)
+{
+    uint32_t value;
+    memcpy(&value, p, 4);
+
+    return self->swapped ? __builtin_bswap32(value) : value;
+}
+
+static bool read_bytes(PcapReader self, void *buffer, size_t size)
+{
+    if (fread(buffer, 1, size, self->file) != size)
+        return false;
+
+    self->position += size;
+
+    return true;
+}
+
+static bool fail(PcapReader self, const char *error)
+{
+    self->error = error;
+
+    return false;
+}
+
+// Make room for size bytes in the block buffer
+static bool reserve(PcapReader self, uint32_t size)
+{
+    if (size <= self->blockCapacity)
+        return true;
+
+    if (size > PCAP_READER_MAX_BLOCK_SIZE)
+        return fail(self, "block too large");
+
+    uint8_t *block = (uint8_t *)realloc(self->block, size);
+
+    if (block == NULL)
+        return fail(self, "out of memory");
+
+    self->block = block;
+    self->blockCapacity = size;
+
+    return true;
+}
+
+static uint64_t ticks_to_ns(const PcapInterface *interface, uint64_t ticks)
+{
+    int resolution = interface->resolution;
+
+    if (interface->binaryResolution)
+    {
+        uint64_t mask = ((uint64_t)1 << resolution) - 1;
+
+        return (ticks >> resolution) * 1000000000ULL + (((ticks & mask) * 1000000000ULL) >> resolution);
+    }
+
+    uint64_t factor = 1;
+
+    if (resolution <= 9)
+    {
+        for (int i = resolution; i < 9; i++)
+            factor *= 10;
+
+        return ticks * factor;
+    }
+
+    for (int i = 9; i < resolution; i++)
+        factor *= 10;
+
+    return ticks / factor;
+}
+
+static bool open_pcap(PcapReader self, uint32_t magic)
+{
+    uint8_t header[20];
+
+    self->swapped = (magic != PCAP_MAGIC_US && magic != PCAP_MAGIC_NS);
+
+    uint32_t hostMagic = self->swapped ? __builtin_bswap32(magic) : magic;
+
+    if (hostMagic != PCAP_MAGIC_US && hostMagic != PCAP_MAGIC_NS)
+        return fail(self, "unknown file format");
+
+    self->nanoseconds = (hostMagic == PCAP_MAGIC_NS);
+
+    // version, thiszone, sigfigs, snaplen, network
+    if (read_bytes(self, header, sizeof(header)) == false)
+        return fail(self, "truncated file header");
+
+    self->linkType = (int)(get32(self, header + 16) & 0xffff);
+
+    return true;
+}
+
+static bool next_pcap(PcapReader self, PcapPacket *packet)
+{
+    uint8_t header[16];
+
+    size_t got = fread(header, 1, sizeof(header), self->file);
+
+    if (got == 0 && feof(self->file))
+        return false;
+
+    if (got != sizeof(header))
+        return fail(self, "truncated record header");
+
+    self->position += sizeof(header);
+
+    uint32_t length = get32(self, header + 8);
+
+    if (reserve(self, length) == false)
+        return false;
+
+    if (read_bytes(self, self->block, length) == false)
+        return fail(self, "truncated packet");
+
+    uint64_t fraction = get32(self, header + 4);
+
+    packet->timestampNs = (uint64_t)get32(self, header) * 1000000000ULL +
+                          (self->nanoseconds ? fraction : fraction * 1000ULL);
+    packet->length = length;
+    packet->originalLength = get32(self, header + 12);
+    packet->interfaceId = 0;
+    packet->linkType = self->linkType;
+    packet->data = self->block;
+
+    return true;
+}
+
+static bool add_interface(PcapReader self, const uint8_t *body, uint32_t bodyLength)
+{
+    if (bodyLength < 8)
+        return fail(self, "truncated interface description");
+
+    if (self->interfaceCount == self->interfaceCapacity)
+    {
+        int capacity = (self->interfaceCapacity > 0) ? self->interfaceCapacity * 2 : 4;
+        PcapInterface *interfaces = (PcapInterface *)realloc(self->interfaces, capacity * sizeof(PcapInterface));
+
+        if (interfaces == NULL)
+            return fail(self, "out of memory");
+
+        self->interfaces = interfaces;
+        self->interfaceCapacity = capacity;
+    }
+
+    PcapInterface *interface = &self->interfaces[self->interfaceCount++];
+
+    interface->linkType = get16(self, body);
+    interface->snapLength = get32(self, body + 4);
+    interface->binaryResolution = false;
+    interface->resolution = 6; // microseconds unless if_tsresol says otherwise
+
+    uint32_t pos = 8;
+
+    while (pos + 4 <= bodyLength)
+    {
+        uint16_t code = get16(self, body + pos);
+        uint16_t length = get16(self, body + pos + 2);
+
+        if (code == PCAPNG_OPTION_END || pos + 4 + length > bodyLength)
+            break;
+
+        if (code == PCAPNG_OPTION_IF_TSRESOL && length == 1)
+        {
+            uint8_t resolution = body[pos + 4];
+
+            interface->binaryResolution = (resolution & 0x80) != 0;
+            interface->resolution = resolution & 0x7f;
+
+            // more digits than a 64 bit counter can hold
+            if (interface->resolution > (interface->binaryResolution ? 63 : 19))
+                return fail(self, "unsupported timestamp resolution");
+        }
+
+        pos += 4 + ((length + 3) & ~3u);
+    }
+
+    return true;
+}
+
+// Read a section header block, type already consumed
+static bool read_section_header(PcapReader self)
+{
+    uint8_t header[8];
+
+    if (read_bytes(self, header, sizeof(header)) == false)
+        return fail(self, "truncated section header");
+
+    uint32_t byteOrderMagic;
+    memcpy(&byteOrderMagic, header + 4, 4);
+
+    if (byteOrderMagic == PCAPNG_BYTE_ORDER_MAGIC)
+        self->swapped = false;
+    else if (byteOrderMagic == __builtin_bswap32(PCAPNG_BYTE_ORDER_MAGIC))
+        self->swapped = true;
+    else
+        return fail(self, "bad byte order magic");
+
+    uint32_t blockLength = get32(self, header);
+
+    if (blockLength < 28 || (blockLength & 3))
+        return fail(self, "bad section header length");
+
+    // version, section length and options are not needed
+    if (reserve(self, blockLength - 12) == false)
+        return false;
+
+    if (read_bytes(self, self->block, blockLength - 12) == false)
+        return fail(self, "truncated section header");
+
+    // interface ids are local to a section
+    self->interfaceCount = 0;
+
+    return true;
+}
+
+static bool next_pcapng(PcapReader self, PcapPacket *packet)
+{
+    while (true)
+    {
+        uint8_t header[8];
+
+        size_t got = fread(header, 1, 4, self->file);
+
+        if (got == 0 && feof(self->file))
+            return false;
+
+        if (got != 4)
+            return fail(self, "truncated block header");
+
+        self->position += 4;
+
+        uint32_t type;
+        memcpy(&type, header, 4);
+
+        if (type == PCAPNG_SECTION_HEADER)
+        {
+            if (read_section_header(self) == false)
+                return false;
+
+            continue;
+        }
+
+        if (read_bytes(self, header + 4, 4) == false)
+            return fail(self, "truncated block header");
+
+        type = get32(self, header);
+        uint32_t blockLength = get32(self, header + 4);
+
+        if (blockLength < 12 || (blockLength & 3))
+            return fail(self, "bad block length");
+
+        // body and trailing length
+        uint32_t bodyLength = blockLength - 12;
+
+        if (reserve(self, bodyLength + 4) == false)
+            return false;
+
+        if (read_bytes(self, self->block, bodyLength + 4) == false)
+            return fail(self, "truncated block");
+
+        const uint8_t *body = self->block;
+
+        if (type == PCAPNG_INTERFACE_DESCRIPTION)
+        {
+            if (add_interface(self, body, bodyLength) == false)
+                return false;
+        }
+        else if (type == PCAPNG_ENHANCED_PACKET)
+        {
+            if (bodyLength < 20)
+                return fail(self, "truncated enhanced packet block");
+
+            uint32_t interfaceId = get32(self, body);
+            uint32_t length = get32(self, body + 12);
+
+            if (interfaceId >= (uint32_t)self->interfaceCount)
+                return fail(self, "packet of an undefined interface");
+
+            if (length > bodyLength - 20)
+                return fail(self, "bad packet length");
+
+            const PcapInterface *interface = &self->interfaces[interfaceId];
+            uint64_t ticks = ((uint64_t)get32(self, body + 4) << 32) | get32(self, body + 8);
+
+            packet->timestampNs = ticks_to_ns(interface, ticks);
+            packet->length = length;
+            packet->originalLength = get32(self, body + 16);
+            packet->interfaceId = (int)interfaceId;
+            packet->linkType = interface->linkType;
+            packet->data = body + 20;
+
+            return true;
+        }
+        else if (type == PCAPNG_SIMPLE_PACKET)
+        {
+            if (bodyLength < 4 || self->interfaceCount == 0)
+                return fail(self, "bad simple packet block");
+
+            const PcapInterface *interface = &self->interfaces[0];
+            uint32_t originalLength = get32(self, body);
+            uint32_t length = originalLength;
+
+            if (interface->snapLength > 0 && length > interface->snapLength)
+                length = interface->snapLength;
+
+            if (length > bodyLength - 4)
+                return fail(self, "bad packet length");
+
+            // simple packet blocks carry no timestamp
+            packet->timestampNs = 0;
+            packet->length = length;
+            packet->originalLength = originalLength;
+            packet->interfaceId = 0;
+            packet->linkType = interface->linkType;
+            packet->data = body + 4;
+
+            return true;
+        }
+
+        // statistics, name resolution, custom blocks ... are skipped
+    }
+}
+
+PcapReader pcap_reader_open(const char *path)
+{
+    PcapReader self = (PcapReader)calloc(1, sizeof(struct sPcapReader));
+
+    if (self == NULL)
+        return NULL;
+
+    self->file = fopen(path, "rb");
+
+    if (self->file == NULL)
+    {
+        free(self);
+        return NULL;
+    }
+
+    uint32_t magic;
+    bool ok;
+
+    if (read_bytes(self, &magic, 4) == false)
+        ok = false;
+    else if (magic == PCAPNG_SECTION_HEADER)
+    {
+        self->pcapng = true;
+        ok = read_section_header(self);
+    }
+    else
+        ok = open_pcap(self, magic);
+
+    if (ok == false)
+    {
+        pcap_reader_close(self);
+        return NULL;
+    }
+
+    return self;
+}
+
+bool pcap_reader_next(PcapReader self, PcapPacket *packet)
+{
+    if (self->error)
+        return false;
+
+    return self->pcapng ? next_pcapng(self, packet) : next_pcap(self, packet);
+}
+
+const char *pcap_reader_error(PcapReader self)
+{
+    return self->error;
+}
+
+uint64_t pcap_reader_position(PcapReader self)
+{
+    return self->position;
+}
+
+void pcap_reader_close(PcapReader self)
+{
+    if (self == NULL)
+        return;
+
+    fclose(self->file);
+    free(self->interfaces);
+    free(self->block);
+    free(self);
+}
@@ -0,0 +1,45 @@
+// pcap_reader.h
+#ifndef PCAP_READER_H
+#define PCAP_READER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Streaming reader for pcap and pcapng files. Only one block is held in
+// memory at a time, so captures of any size are read with bounded memory.
+
+// Largest block that is accepted, larger blocks are reported as format error
+#define PCAP_READER_MAX_BLOCK_SIZE (16 * 1024 * 1024)
+
+// Link type of Ethernet captures
+#define PCAP_LINKTYPE_ETHERNET 1
+
+typedef struct sPcapReader *PcapReader;
+
+typedef struct
+{
+    uint64_t timestampNs;    // capture time in ns since the UNIX epoch
+    uint32_t length;         // captured bytes in data
+    uint32_t originalLength; // size of the frame on the wire
+    int interfaceId;         // pcapng interface, always 0 for pcap
+    int linkType;
+    const uint8_t *data;     // valid until the next call of pcap_reader_next
+} PcapPacket;
+
+// Open a pcap (microsecond or nanosecond, either byte order) or pcapng file.
+// Returns NULL if the file cannot be opened or has an unknown format.
+PcapReader pcap_reader_open(const char *path);
+
+// Read the next packet. Returns false at the end of the file or on a format
+// error, pcap_reader_error tells them apart.
+bool pcap_reader_next(PcapReader self, PcapPacket *packet);
+
+// NULL after a clean end of file, otherwise a description of the error
+const char *pcap_reader_error(PcapReader self);
+
+// Bytes of the file consumed so far
+uint64_t pcap_reader_position(PcapReader self);
+
+void pcap_reader_close(PcapReader self);
+
+#endif // PCAP_READER_H
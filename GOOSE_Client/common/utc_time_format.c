@@ -0,0 +1,83 @@
+// utc_time_format.c
+#define _POSIX_C_SOURCE 200112L
+
+#include <string.h>
+#include <time.h>
+
+#include "utc_time_format.h"
+
+static const uint32_t fraction_divisors[] = {
+    1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1};
+
+void utc_time_formatter_init(UtcTimeFormatter *self, int fractionDigits)
+{
+    if (fractionDigits < 0)
+        fractionDigits = 0;
+    if (fractionDigits > 9)
+        fractionDigits = 9;
+
+    self->second = -1;
+    self->prefixLength = 0;
+    self->fractionDigits = fractionDigits;
+}
+
+static void update_prefix(UtcTimeFormatter *self, int64_t second)
+{
+    // Same minute: the seconds are the last two characters of the prefix
+    if (self->second >= 0 && second / 60 == self->second / 60)
+    {
+        int s = (int)(second % 60);
+
+        self->prefix[self->prefixLength - 2] = (char)('0' + s / 10);
+        self->prefix[self->prefixLength - 1] = (char)('0' + s % 10);
+    }
+    else
+    {
+        time_t rawtime = (time_t)second;
+        struct tm tm;
+
+        gmtime_r(&rawtime, &tm);
+
+        self->prefixLength = (int)strftime(self->prefix, sizeof(self->prefix), "%b %d, %Y %H:%M:%S", &tm);
+    }
+
+    self->second = second;
+}
+
+int utc_time_format(UtcTimeFormatter *self, char *buffer, size_t size, uint64_t epochNs)
+{
+    int64_t second = (int64_t)(epochNs / 1000000000ULL);
+    uint32_t nanoseconds = (uint32_t)(epochNs % 1000000000ULL);
+
+    if (second != self->second)
+        update_prefix(self, second);
+
+    int length = self->prefixLength + (self->fractionDigits > 0 ? 1 + self->fractionDigits : 0) + 4;
+
+    if ((size_t)length >= size)
+        return -1;
+
+    char *pos = buffer;
+
+    memcpy(pos, self->prefix, self->prefixLength);
+    pos += self->prefixLength;
+
+    if (self->fractionDigits > 0)
+    {
+        uint32_t fraction = nanoseconds / fraction_divisors[self->fractionDigits];
+
+        *pos++ = '.';
+
+        for (int i = self->fractionDigits - 1; i >= 0; i--)
+        {
+            pos[i] = (char)('0' + fraction % 10);
+            fraction /= 10;
+        }
+
+        pos += self->fractionDigits;
+    }
+
+    memcpy(pos, " UTC", 5);
+
+    return length;
+}
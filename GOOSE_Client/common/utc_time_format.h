@@ -0,0 +1,29 @@
+// utc_time_format.h
+#ifndef UTC_TIME_FORMAT_H
+#define UTC_TIME_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Longest string written by utc_time_format ("Oct 17, 2026 12:34:56.123456789 UTC")
+#define UTC_TIME_FORMAT_SIZE 40
+
+// Caches the date part of the last formatted time. Not thread safe, use one
+// formatter per thread.
+typedef struct
+{
+    int64_t second;      // epoch second of prefix, -1 = empty
+    char prefix[32];     // "%b %d, %Y %H:%M:%S"
+    int prefixLength;
+    int fractionDigits;
+} UtcTimeFormatter;
+
+// fractionDigits: 3 = milliseconds, 6 = microseconds, 9 = nanoseconds
+void utc_time_formatter_init(UtcTimeFormatter *self, int fractionDigits);
+
+// Write "Oct 17, 2026 12:34:56.123 UTC". gmtime/strftime only run when the minute
+// changes, within a minute only the seconds digits of the cached prefix are
+// replaced. Returns the string length or -1 if buffer is too small.
+int utc_time_format(UtcTimeFormatter *self, char *buffer, size_t size, uint64_t epochNs);
+
+#endif // UTC_TIME_FORMAT_H
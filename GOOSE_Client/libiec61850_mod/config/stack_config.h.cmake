@@ -42,6 +42,14 @@
 /* Optimize stack for threadless operation - don't use semaphores */
 #cmakedefine01 CONFIG_MMS_THREADLESS_STACK
 
+/* Handle client connections with an event loop (epoll) and a fixed number of worker threads
+ * instead of one thread for each connection (Linux only, multi threaded mode only)
+ */
+#cmakedefine01 CONFIG_MMS_SERVER_EVENT_LOOP
+
+/* number of worker threads of the server event loop */
+#cmakedefine CONFIG_MMS_SERVER_EVENT_LOOP_WORKERS @CONFIG_MMS_SERVER_EVENT_LOOP_WORKERS@
+
 /* Maximum MMS PDU SIZE - default is 65000 */
 #cmakedefine CONFIG_MMS_MAXIMUM_PDU_SIZE @CONFIG_MMS_MAXIMUM_PDU_SIZE@
 
@@ -68,12 +76,34 @@
 /* #define CONFIG_ETHERNET_INTERFACE_ID "vboxnet0" */
 /* #define CONFIG_ETHERNET_INTERFACE_ID "en0"  // OS X uses enX in place of ethX as ethernet NIC names. */
 
+/* Maximum number of Ethernet frames the GOOSE/SV receiver threads read with a single system call */
+#define CONFIG_ETHERNET_RECEIVE_BATCH_SIZE 32
+
+/* Maximum number of receive threads of a GOOSE/SV receiver (see GooseReceiver_setWorkers) */
+#define CONFIG_ETHERNET_MAX_RECEIVE_WORKERS 8
+
+/* Set to 1 to use memory mapped PACKET_MMAP rings for the GOOSE/SV sockets (Linux only) */
+#define CONFIG_ETHERNET_USE_PACKET_MMAP 0
+
+/* Size and number of the blocks of the receive ring. The block size has to be a multiple of the page size */
+#define CONFIG_ETHERNET_RX_RING_BLOCK_SIZE 65536
+#define CONFIG_ETHERNET_RX_RING_BLOCK_COUNT 8
+
+/* Time in ms after which a partially filled receive block is handed to the application (latency vs. wakeups) */
+#define CONFIG_ETHERNET_RX_RING_BLOCK_TIMEOUT 2
+
+/* Number of frame slots of the send ring */
+#define CONFIG_ETHERNET_TX_RING_FRAME_COUNT 64
+
 /* Set to 1 to include GOOSE support in the build. Otherwise set to 0 */
 #cmakedefine01 CONFIG_INCLUDE_GOOSE_SUPPORT
 
 /* Set to 1 to include Sampled Values support in the build. Otherwise set to 0 */
 #define CONFIG_IEC61850_SAMPLED_VALUES_SUPPORT 1
 
+/* Set to 1 to use SSSE3/AVX2 (selected at runtime) for the bulk SV channel decoding on x86 */
+#define CONFIG_SV_USE_SIMD 1
+
 /* Set to 1 to compile for edition 1 server - default is 0 to compile for edition 2 */
 #define CONFIG_IEC61850_EDITION_1 0
 
@@ -102,6 +132,9 @@
 /* The number of GOOSE retransmissions after an event */
 #define CONFIG_GOOSE_EVENT_RETRANSMISSION_COUNT 2
 
+/* Maximum number of allData elements (including structure and array members) for compiled GOOSE decoding */
+#define CONFIG_GOOSE_MAX_COMPILED_ELEMENTS 128
+
 /* Define if GOOSE control block elements are writable (1) or read-only (0) */
 #define CONFIG_GOOSE_GOID_WRITABLE 0
 #define CONFIG_GOOSE_DATSET_WRITABLE 0
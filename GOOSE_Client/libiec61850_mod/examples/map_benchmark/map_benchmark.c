@@ -0,0 +1,142 @@
+/*
+ * map_benchmark.c
+ *
+ * Measures the lookup time of the StringMap used by the MMS value cache for
+ * different numbers of item IDs and compares it with a linear list search.
+ *
+ * Usage: map_benchmark [max-items]
+ */
+
+#include "libiec61850_platform_includes.h"
+#include "string_map.h"
+#include "linked_list.h"
+#include "hal_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOOKUPS_PER_RUN 200000
+
+static char**
+createItemIds(int count)
+{
+    char** itemIds = (char**) malloc(count * sizeof(char*));
+
+    int i;
+
+    for (i = 0; i < count; i++) {
+        char buffer[65];
+
+        snprintf(buffer, sizeof(buffer), "GGIO%i$ST$Ind%i$stVal", i / 1000, i % 1000);
+
+        itemIds[i] = strdup(buffer);
+    }
+
+    return itemIds;
+}
+
+static double
+benchmarkMap(char** itemIds, int count, int lookups)
+{
+    Map map = StringMap_create();
+
+    int i;
+
+    for (i = 0; i < count; i++)
+        StringMap_addEntry(map, itemIds[i], itemIds[i]);
+
+    int found = 0;
+
+    nsSinceEpoch start = Hal_getTimeInNs();
+
+    for (i = 0; i < lookups; i++) {
+        if (Map_getEntry(map, itemIds[(i * 7919) % count]) != NULL)
+            found++;
+    }
+
+    nsSinceEpoch duration = Hal_getTimeInNs() - start;
+
+    if (found != lookups)
+        printf("  ERROR: %i of %i lookups failed!\n", lookups - found, lookups);
+
+    Map_deleteStatic(map, false);
+
+    return (double) duration / lookups;
+}
+
+static double
+benchmarkList(char** itemIds, int count, int lookups)
+{
+    LinkedList list = LinkedList_create();
+
+    int i;
+
+    for (i = 0; i < count; i++)
+        LinkedList_add(list, itemIds[i]);
+
+    int found = 0;
+
+    nsSinceEpoch start = Hal_getTimeInNs();
+
+    for (i = 0; i < lookups; i++) {
+        char* itemId = itemIds[(i * 7919) % count];
+
+        LinkedList element = LinkedList_getNext(list);
+
+        while (element) {
+            if (strcmp((char*) element->data, itemId) == 0) {
+                found++;
+                break;
+            }
+
+            element = LinkedList_getNext(element);
+        }
+    }
+
+    nsSinceEpoch duration = Hal_getTimeInNs() - start;
+
+    if (found != lookups)
+        printf("  ERROR: %i of %i lookups failed!\n", lookups - found, lookups);
+
+    LinkedList_destroyStatic(list);
+
+    return (double) duration / lookups;
+}
+
+int
+main(int argc, char** argv)
+{
+    int maxItems = 100000;
+
+    if (argc > 1)
+        maxItems = atoi(argv[1]);
+
+    if (maxItems < 100)
+        maxItems = 100;
+
+    char** itemIds = createItemIds(maxItems);
+
+    printf("%10s %16s %16s\n", "items", "map [ns/lookup]", "list [ns/lookup]");
+
+    int count;
+
+    for (count = 100; count <= maxItems; count *= 10) {
+        double mapTime = benchmarkMap(itemIds, count, LOOKUPS_PER_RUN);
+
+        /* the list search is linear - keep the total run time bounded */
+        int listLookups = (int) ((LOOKUPS_PER_RUN * 100LL) / count);
+
+        double listTime = benchmarkList(itemIds, count, listLookups);
+
+        printf("%10i %16.1f %16.1f\n", count, mapTime, listTime);
+    }
+
+    int i;
+
+    for (i = 0; i < maxItems; i++)
+        free(itemIds[i]);
+
+    free(itemIds);
+
+    return 0;
+}
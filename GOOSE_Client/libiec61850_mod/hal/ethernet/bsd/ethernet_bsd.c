@@ -39,6 +39,8 @@
 #include "lib_memory.h"
 #include "hal_ethernet.h"
 
+#define ETH_FRAME_BUFFER_SIZE 1518
+
 struct sEthernetSocket {
     int bpf;                        /* BPF device handle. */
     uint8_t *bpfBuffer;             /* Pointer to the BPF reception buffer. */
@@ -376,6 +378,41 @@ Ethernet_setProtocolFilter(EthernetSocket self, uint16_t etherType)
         printf("Unable to set ethertype filter!\n");
 }
 
+bool
+Ethernet_setFrameFilter(EthernetSocket ethSocket, uint16_t etherType, const uint16_t* appIds, int appIdCount,
+        const uint8_t* dstAddresses, int dstAddressCount)
+{
+    Ethernet_setProtocolFilter(ethSocket, etherType);
+
+    return false;
+}
+
+int
+Ethernet_joinFanoutGroup(EthernetSocket ethSocket, int groupId, EthernetFanoutMode mode)
+{
+    /* not supported */
+    return -1;
+}
+
+bool
+Ethernet_enableTimestamping(EthernetSocket ethSocket, bool hardware)
+{
+    /* not supported */
+    return false;
+}
+
+uint64_t
+Ethernet_getReceiveTimestamp(EthernetSocket ethSocket, int index)
+{
+    return 0;
+}
+
+uint64_t
+Ethernet_getTransmitTimestamp(EthernetSocket ethSocket)
+{
+    return 0;
+}
+
 int
 Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
 {
@@ -423,6 +460,56 @@ Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
         return 0;
 }
 
+int
+Ethernet_receivePackets(EthernetSocket self, uint8_t** buffers, int bufferSize, int* packetSizes, int maxPackets)
+{
+    int received = 0;
+
+    while (received < maxPackets) {
+        int packetSize = Ethernet_receivePacket(self, buffers[received], bufferSize);
+
+        if (packetSize <= 0)
+            break;
+
+        packetSizes[received++] = packetSize;
+    }
+
+    return received;
+}
+
+bool
+Ethernet_setupReceiveRing(EthernetSocket self, int blockSize, int blockCount, int blockTimeout)
+{
+    return false;
+}
+
+bool
+Ethernet_setupSendRing(EthernetSocket self, int frameCount)
+{
+    return false;
+}
+
+int
+Ethernet_receiveFrames(EthernetSocket self, EthernetFrameHandler handler, void* parameter, int maxFrames)
+{
+    uint8_t buffer[ETH_FRAME_BUFFER_SIZE];
+
+    int received = 0;
+
+    while (received < maxFrames) {
+        int frameSize = Ethernet_receivePacket(self, buffer, ETH_FRAME_BUFFER_SIZE);
+
+        if (frameSize <= 0)
+            break;
+
+        handler(parameter, buffer, frameSize);
+
+        received++;
+    }
+
+    return received;
+}
+
 void
 Ethernet_sendPacket(EthernetSocket self, uint8_t* buffer, int packetSize)
 {
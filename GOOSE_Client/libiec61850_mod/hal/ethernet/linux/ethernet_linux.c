@@ -21,16 +21,25 @@
  *  See COPYING file for the complete license text.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* for recvmmsg */
+#endif
+
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <poll.h>
 #include <linux/filter.h>
 #include <linux/if_packet.h>
 #include <linux/if_ether.h>
 #include <linux/if_arp.h>
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#include <linux/errqueue.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <time.h>
 
 #include <string.h>
 
@@ -41,12 +50,64 @@
 #define DEBUG_SOCKET 0
 #endif
 
+#define ETH_FRAME_BUFFER_SIZE 1518
+
+/* frame slot size for the PACKET_MMAP rings - header + maximum Ethernet frame */
+#define ETH_RING_FRAME_SIZE 2048
+
+/* start of the frame data in a TPACKET_V2 send ring slot */
+#define ETH_TX_RING_DATA_OFFSET (TPACKET_ALIGN(sizeof(struct tpacket2_hdr)))
+
+/* larger sets are not filtered in the kernel - the BPF jump offsets are limited to 255 instructions */
+#define ETH_FILTER_MAX_APPIDS 64
+#define ETH_FILTER_MAX_ADDRESSES 32
+
+#define ETH_FILTER_MAX_LENGTH (5 + 1 + ETH_FILTER_MAX_APPIDS + (4 * ETH_FILTER_MAX_ADDRESSES) + 2)
+
+/* control message buffer for a SCM_TIMESTAMPING message */
+#define ETH_TIMESTAMP_CONTROL_SIZE (CMSG_SPACE(sizeof(struct scm_timestamping)))
+
+/* control message buffer for the error queue - timestamp and extended error */
+#define ETH_ERRQUEUE_CONTROL_SIZE (ETH_TIMESTAMP_CONTROL_SIZE + CMSG_SPACE(sizeof(struct sock_extended_err)) + 64)
+
 struct sEthernetSocket {
     int rawSocket;
     bool isBind;
+    bool hasDestination; /* created with destination address for sending */
     struct sockaddr_ll socketAddress;
+
+    /* message headers for Ethernet_receivePackets - allocated on first use */
+    struct mmsghdr* rxMessages;
+    struct iovec* rxVectors;
+    int rxCapacity;
+
+    /* memory mapped receive (TPACKET_V3) or send (TPACKET_V2) ring */
+    uint8_t* ring;
+    size_t ringSize;
+
+    int rxBlockSize;
+    int rxBlockCount;
+    int rxBlockIndex;
+    struct tpacket3_hdr* rxPacket; /* next packet of the block owned by the application */
+    uint32_t rxPacketsLeft;
+
+    int txFrameCount;
+    int txFrameIndex;
+
+    /* SO_TIMESTAMPING - rxTimestamps and rxControl have rxTimestampCapacity entries */
+    bool timestamping;
+    uint64_t* rxTimestamps;
+    uint8_t* rxControl;
+    int rxTimestampCapacity;
+    uint64_t txTimestamp; /* of the last sent frame */
 };
 
+typedef struct {
+    uint8_t** buffers;
+    int bufferSize;
+    int* packetSizes;
+} CopyFrameContext;
+
 struct sEthernetHandleSet {
     struct pollfd* handles;
     int nhandles;
@@ -197,8 +258,10 @@ Ethernet_createSocket(const char* interfaceId, uint8_t* destAddress)
 
         memset(ethernetSocket->socketAddress.sll_addr, 0, 8);
 
-        if (destAddress != NULL)
+        if (destAddress != NULL) {
             memcpy(ethernetSocket->socketAddress.sll_addr, destAddress, 6);
+            ethernetSocket->hasDestination = true;
+        }
 
         ethernetSocket->isBind = false;
     }
@@ -313,24 +376,729 @@ Ethernet_setProtocolFilter(EthernetSocket ethSocket, uint16_t etherType)
     }
 }
 
+bool
+Ethernet_setFrameFilter(EthernetSocket ethSocket, uint16_t etherType, const uint16_t* appIds, int appIdCount,
+        const uint8_t* dstAddresses, int dstAddressCount)
+{
+    struct sock_filter filter[ETH_FILTER_MAX_LENGTH];
 
-/* non-blocking receive */
-int
-Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
+    if ((appIds == NULL) || (appIdCount > ETH_FILTER_MAX_APPIDS))
+        appIdCount = 0;
+
+    if ((dstAddresses == NULL) || (dstAddressCount > ETH_FILTER_MAX_ADDRESSES))
+        dstAddressCount = 0;
+
+    /* program layout: header | APPID set | destination address set | drop | accept */
+    int appIdStart = 5;
+    int appIdLength = (appIdCount > 0) ? (1 + appIdCount) : 0;
+    int addressStart = appIdStart + appIdLength;
+    int drop = addressStart + (4 * dstAddressCount);
+    int accept = drop + 1;
+
+    int afterAppIds = (dstAddressCount > 0) ? addressStart : accept;
+    int afterEtherType = (appIdCount > 0) ? appIdStart : afterAppIds;
+
+    /* X = 4 when the frame still carries a VLAN tag (the kernel usually strips it before) */
+    filter[0] = (struct sock_filter) BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 12);
+    filter[1] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x8100, 0, 1);
+    filter[2] = (struct sock_filter) BPF_STMT(BPF_LDX | BPF_W | BPF_IMM, 4);
+    filter[3] = (struct sock_filter) BPF_STMT(BPF_LD | BPF_H | BPF_IND, 12);
+    filter[4] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, etherType, afterEtherType - 5, drop - 5);
+
+    int pc = appIdStart;
+    int i;
+
+    if (appIdCount > 0) {
+        filter[pc++] = (struct sock_filter) BPF_STMT(BPF_LD | BPF_H | BPF_IND, 14);
+
+        for (i = 0; i < appIdCount; i++) {
+            int onMismatch = (i == appIdCount - 1) ? (drop - (pc + 1)) : 0;
+
+            filter[pc] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, appIds[i], afterAppIds - (pc + 1), onMismatch);
+            pc++;
+        }
+    }
+
+    for (i = 0; i < dstAddressCount; i++) {
+        const uint8_t* addr = dstAddresses + (i * 6);
+
+        uint32_t low = ((uint32_t) addr[2] << 24) | ((uint32_t) addr[3] << 16) | ((uint32_t) addr[4] << 8) | addr[5];
+        uint32_t high = ((uint32_t) addr[0] << 8) | addr[1];
+
+        filter[pc++] = (struct sock_filter) BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 2);
+        filter[pc] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, low, 0, 2);
+        pc++;
+        filter[pc++] = (struct sock_filter) BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 0);
+        filter[pc] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, high, accept - (pc + 1), 0);
+        pc++;
+    }
+
+    filter[pc++] = (struct sock_filter) BPF_STMT(BPF_RET | BPF_K, 0);
+    filter[pc++] = (struct sock_filter) BPF_STMT(BPF_RET | BPF_K, 0x00040000);
+
+    struct sock_fprog fprog;
+
+    fprog.len = pc;
+    fprog.filter = filter;
+
+    if (setsockopt(ethSocket->rawSocket, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog)) == -1) {
+        if (DEBUG_SOCKET)
+            printf("ETHERNET_LINUX: Applying filter failed\n");
+
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+bindSocket(EthernetSocket self)
 {
     if (self->isBind == false) {
         if (bind(self->rawSocket, (struct sockaddr*) &self->socketAddress, sizeof(self->socketAddress)) == 0)
             self->isBind = true;
-        else
-            return 0;
+    }
+
+    return self->isBind;
+}
+
+#ifndef PACKET_FANOUT_FLAG_UNIQUEID
+#define PACKET_FANOUT_FLAG_UNIQUEID 0x2000
+#endif
+
+static bool
+setFanoutAppIdProgram(EthernetSocket self)
+{
+    /* the program returns the APPID - the kernel selects the socket by APPID modulo group size */
+    struct sock_filter program[] = {
+        BPF_STMT(BPF_LD | BPF_H | BPF_ABS, SKF_LL_OFF + 12),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x8100, 0, 1),
+        BPF_STMT(BPF_LDX | BPF_W | BPF_IMM, 4),
+        BPF_STMT(BPF_LD | BPF_H | BPF_IND, SKF_LL_OFF + 14),
+        BPF_STMT(BPF_RET | BPF_A, 0)
+    };
+
+    struct sock_fprog fprog;
+
+    fprog.len = sizeof(program) / sizeof(struct sock_filter);
+    fprog.filter = program;
+
+    return (setsockopt(self->rawSocket, SOL_PACKET, PACKET_FANOUT_DATA, &fprog, sizeof(fprog)) == 0);
+}
+
+int
+Ethernet_joinFanoutGroup(EthernetSocket ethSocket, int groupId, EthernetFanoutMode mode)
+{
+    int type;
+
+    switch (mode) {
+    case ETHERNET_FANOUT_HASH:
+        type = PACKET_FANOUT_HASH;
+        break;
+    case ETHERNET_FANOUT_CPU:
+        type = PACKET_FANOUT_CPU;
+        break;
+    default:
+        type = PACKET_FANOUT_CBPF;
+        break;
+    }
+
+    /* the interface of a fanout socket cannot be changed anymore */
+    if (bindSocket(ethSocket) == false)
+        return -1;
+
+    uint32_t fanoutArg;
+
+    if (groupId == -1) {
+        /* let the kernel choose an unused group id */
+        fanoutArg = (uint32_t) (type | PACKET_FANOUT_FLAG_UNIQUEID) << 16;
+
+        if (setsockopt(ethSocket->rawSocket, SOL_PACKET, PACKET_FANOUT, &fanoutArg, sizeof(fanoutArg)) == -1) {
+            /* older kernels - use the process id */
+            groupId = getpid() & 0xffff;
+            fanoutArg = ((uint32_t) type << 16) | (uint32_t) groupId;
+
+            if (setsockopt(ethSocket->rawSocket, SOL_PACKET, PACKET_FANOUT, &fanoutArg, sizeof(fanoutArg)) == -1) {
+                if (DEBUG_SOCKET)
+                    printf("ETHERNET_LINUX: Creating fanout group failed\n");
+
+                return -1;
+            }
+        }
+        else {
+            socklen_t argLength = sizeof(fanoutArg);
+
+            if (getsockopt(ethSocket->rawSocket, SOL_PACKET, PACKET_FANOUT, &fanoutArg, &argLength) == -1)
+                return -1;
+
+            groupId = fanoutArg & 0xffff;
+        }
+
+        if ((type == PACKET_FANOUT_CBPF) && (setFanoutAppIdProgram(ethSocket) == false)) {
+            if (DEBUG_SOCKET)
+                printf("ETHERNET_LINUX: Setting fanout program failed\n");
+
+            return -1;
+        }
+    }
+    else {
+        fanoutArg = ((uint32_t) type << 16) | ((uint32_t) groupId & 0xffff);
+
+        if (setsockopt(ethSocket->rawSocket, SOL_PACKET, PACKET_FANOUT, &fanoutArg, sizeof(fanoutArg)) == -1) {
+            if (DEBUG_SOCKET)
+                printf("ETHERNET_LINUX: Joining fanout group %i failed\n", groupId);
+
+            return -1;
+        }
+    }
+
+    return groupId;
+}
+
+/* batch: the timestamp of the n-th frame is stored at index n, otherwise at index 0 */
+static int
+receiveFromRing(EthernetSocket self, EthernetFrameHandler handler, void* parameter, int maxFrames, bool batch)
+{
+    int received = 0;
+
+    while (received < maxFrames) {
+
+        struct tpacket_block_desc* block = (struct tpacket_block_desc*) (self->ring + ((size_t) self->rxBlockIndex * self->rxBlockSize));
+
+        if (self->rxPacket == NULL) {
+            if ((block->hdr.bh1.block_status & TP_STATUS_USER) == 0)
+                break;
+
+            __sync_synchronize();
+
+            self->rxPacket = (struct tpacket3_hdr*) ((uint8_t*) block + block->hdr.bh1.offset_to_first_pkt);
+            self->rxPacketsLeft = block->hdr.bh1.num_pkts;
+        }
+
+        while ((self->rxPacketsLeft > 0) && (received < maxFrames)) {
+            struct tpacket3_hdr* packet = self->rxPacket;
+
+            if (self->timestamping) {
+                int index = batch ? received : 0;
+
+                if (index < self->rxTimestampCapacity)
+                    self->rxTimestamps[index] = ((uint64_t) packet->tp_sec * 1000000000ULL) + packet->tp_nsec;
+            }
+
+            handler(parameter, (uint8_t*) packet + packet->tp_mac, packet->tp_snaplen);
+            received++;
+
+            self->rxPacket = (struct tpacket3_hdr*) ((uint8_t*) packet + packet->tp_next_offset);
+            self->rxPacketsLeft--;
+        }
+
+        if (self->rxPacketsLeft == 0) {
+            /* return the block to the kernel */
+            __sync_synchronize();
+            block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+
+            self->rxPacket = NULL;
+            self->rxBlockIndex = (self->rxBlockIndex + 1) % self->rxBlockCount;
+        }
+    }
+
+    return received;
+}
+
+/* nanoseconds since epoch of a SCM_TIMESTAMPING message - the hardware timestamp when available */
+static uint64_t
+getTimestamp(struct msghdr* message)
+{
+    struct cmsghdr* cmsg;
+
+    for (cmsg = CMSG_FIRSTHDR(message); cmsg != NULL; cmsg = CMSG_NXTHDR(message, cmsg)) {
+        if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_TIMESTAMPING)) {
+            struct scm_timestamping timestamps;
+
+            memcpy(&timestamps, CMSG_DATA(cmsg), sizeof(timestamps));
+
+            struct timespec* timestamp = &(timestamps.ts[2]);
+
+            if ((timestamp->tv_sec == 0) && (timestamp->tv_nsec == 0))
+                timestamp = &(timestamps.ts[0]);
+
+            return ((uint64_t) timestamp->tv_sec * 1000000000ULL) + timestamp->tv_nsec;
+        }
+    }
+
+    return 0;
+}
+
+static bool
+prepareTimestamps(EthernetSocket self, int maxPackets)
+{
+    if (maxPackets <= self->rxTimestampCapacity)
+        return true;
+
+    uint64_t* timestamps = (uint64_t*) GLOBAL_CALLOC(maxPackets, sizeof(uint64_t));
+    uint8_t* control = (uint8_t*) GLOBAL_CALLOC(maxPackets, ETH_TIMESTAMP_CONTROL_SIZE);
+
+    if ((timestamps == NULL) || (control == NULL)) {
+        GLOBAL_FREEMEM(timestamps);
+        GLOBAL_FREEMEM(control);
+        return false;
+    }
+
+    GLOBAL_FREEMEM(self->rxTimestamps);
+    GLOBAL_FREEMEM(self->rxControl);
+
+    self->rxTimestamps = timestamps;
+    self->rxControl = control;
+    self->rxTimestampCapacity = maxPackets;
+
+    return true;
+}
+
+static void
+copyFrame(void* parameter, uint8_t* frame, int frameSize)
+{
+    CopyFrameContext* context = (CopyFrameContext*) parameter;
+
+    if (frameSize > context->bufferSize)
+        frameSize = context->bufferSize;
+
+    memcpy(context->buffers[0], frame, frameSize);
+    context->packetSizes[0] = frameSize;
+
+    context->buffers++;
+    context->packetSizes++;
+}
+
+/* non-blocking receive */
+int
+Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
+{
+    if (self->rxBlockCount > 0) {
+        int packetSize = 0;
+
+        CopyFrameContext context = { &buffer, bufferSize, &packetSize };
+
+        receiveFromRing(self, copyFrame, &context, 1, false);
+
+        return packetSize;
+    }
+
+    if (bindSocket(self) == false)
+        return 0;
+
+    if (self->timestamping) {
+        struct iovec vector = { buffer, bufferSize };
+        struct msghdr message;
+
+        memset(&message, 0, sizeof(message));
+
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = self->rxControl;
+        message.msg_controllen = ETH_TIMESTAMP_CONTROL_SIZE;
+
+        int packetSize = recvmsg(self->rawSocket, &message, MSG_DONTWAIT);
+
+        if (packetSize > 0)
+            self->rxTimestamps[0] = getTimestamp(&message);
+
+        return packetSize;
     }
 
     return recvfrom(self->rawSocket, buffer, bufferSize, MSG_DONTWAIT, 0, 0);
 }
 
+static bool
+prepareReceiveMessages(EthernetSocket self, int maxPackets)
+{
+    if (maxPackets <= self->rxCapacity)
+        return true;
+
+    struct mmsghdr* messages = (struct mmsghdr*) GLOBAL_CALLOC(maxPackets, sizeof(struct mmsghdr));
+    struct iovec* vectors = (struct iovec*) GLOBAL_CALLOC(maxPackets, sizeof(struct iovec));
+
+    if ((messages == NULL) || (vectors == NULL)) {
+        GLOBAL_FREEMEM(messages);
+        GLOBAL_FREEMEM(vectors);
+        return false;
+    }
+
+    GLOBAL_FREEMEM(self->rxMessages);
+    GLOBAL_FREEMEM(self->rxVectors);
+
+    self->rxMessages = messages;
+    self->rxVectors = vectors;
+    self->rxCapacity = maxPackets;
+
+    int i;
+
+    for (i = 0; i < maxPackets; i++) {
+        messages[i].msg_hdr.msg_iov = &(vectors[i]);
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    return true;
+}
+
+/* non-blocking receive of all queued packets with a single system call */
+int
+Ethernet_receivePackets(EthernetSocket self, uint8_t** buffers, int bufferSize, int* packetSizes, int maxPackets)
+{
+    /* without timestamp buffers the frames are received without timestamps */
+    bool timestamps = self->timestamping && prepareTimestamps(self, maxPackets);
+
+    if (self->rxBlockCount > 0) {
+        CopyFrameContext context = { buffers, bufferSize, packetSizes };
+
+        return receiveFromRing(self, copyFrame, &context, maxPackets, true);
+    }
+
+    if (bindSocket(self) == false)
+        return 0;
+
+    if (prepareReceiveMessages(self, maxPackets) == false)
+        return 0;
+
+    int i;
+
+    for (i = 0; i < maxPackets; i++) {
+        self->rxVectors[i].iov_base = buffers[i];
+        self->rxVectors[i].iov_len = bufferSize;
+
+        /* the length is updated by the kernel */
+        if (timestamps) {
+            self->rxMessages[i].msg_hdr.msg_control = self->rxControl + (i * ETH_TIMESTAMP_CONTROL_SIZE);
+            self->rxMessages[i].msg_hdr.msg_controllen = ETH_TIMESTAMP_CONTROL_SIZE;
+        }
+        else {
+            self->rxMessages[i].msg_hdr.msg_control = NULL;
+            self->rxMessages[i].msg_hdr.msg_controllen = 0;
+        }
+    }
+
+    int received = recvmmsg(self->rawSocket, self->rxMessages, maxPackets, MSG_DONTWAIT, NULL);
+
+    if (received < 0)
+        return 0;
+
+    for (i = 0; i < received; i++) {
+        packetSizes[i] = (int) self->rxMessages[i].msg_len;
+
+        if (timestamps)
+            self->rxTimestamps[i] = getTimestamp(&(self->rxMessages[i].msg_hdr));
+    }
+
+    return received;
+}
+
+int
+Ethernet_receiveFrames(EthernetSocket self, EthernetFrameHandler handler, void* parameter, int maxFrames)
+{
+    if (self->rxBlockCount > 0)
+        return receiveFromRing(self, handler, parameter, maxFrames, false);
+
+    uint8_t buffer[ETH_FRAME_BUFFER_SIZE];
+
+    int received = 0;
+
+    while (received < maxFrames) {
+        int frameSize = Ethernet_receivePacket(self, buffer, ETH_FRAME_BUFFER_SIZE);
+
+        if (frameSize <= 0)
+            break;
+
+        handler(parameter, buffer, frameSize);
+
+        received++;
+    }
+
+    return received;
+}
+
+static bool
+mapRing(EthernetSocket self, size_t ringSize)
+{
+    void* ring = mmap(NULL, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED, self->rawSocket, 0);
+
+    if (ring == MAP_FAILED) {
+        if (DEBUG_SOCKET)
+            printf("ETHERNET_LINUX: Failed to map packet ring\n");
+
+        return false;
+    }
+
+    self->ring = (uint8_t*) ring;
+    self->ringSize = ringSize;
+
+    return true;
+}
+
+bool
+Ethernet_setupReceiveRing(EthernetSocket self, int blockSize, int blockCount, int blockTimeout)
+{
+    if (self->ring != NULL)
+        return false;
+
+    if ((blockSize < ETH_RING_FRAME_SIZE) || (blockSize % getpagesize() != 0) || (blockCount < 1))
+        return false;
+
+    int version = TPACKET_V3;
+
+    if (setsockopt(self->rawSocket, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) == -1) {
+        if (DEBUG_SOCKET)
+            printf("ETHERNET_LINUX: TPACKET_V3 not supported\n");
+
+        return false;
+    }
+
+    struct tpacket_req3 req;
+    memset(&req, 0, sizeof(req));
+
+    req.tp_block_size = blockSize;
+    req.tp_block_nr = blockCount;
+    req.tp_frame_size = ETH_RING_FRAME_SIZE;
+    req.tp_frame_nr = (blockSize / ETH_RING_FRAME_SIZE) * blockCount;
+    req.tp_retire_blk_tov = blockTimeout;
+
+    if (setsockopt(self->rawSocket, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) == -1) {
+        if (DEBUG_SOCKET)
+            printf("ETHERNET_LINUX: Failed to create receive ring\n");
+
+        return false;
+    }
+
+    if (mapRing(self, (size_t) blockSize * blockCount) == false) {
+        memset(&req, 0, sizeof(req));
+        setsockopt(self->rawSocket, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req));
+
+        return false;
+    }
+
+    self->rxBlockSize = blockSize;
+    self->rxBlockCount = blockCount;
+    self->rxBlockIndex = 0;
+    self->rxPacket = NULL;
+    self->rxPacketsLeft = 0;
+
+    /* the ring only receives frames after the socket is bound to the interface */
+    bindSocket(self);
+
+    return true;
+}
+
+bool
+Ethernet_setupSendRing(EthernetSocket self, int frameCount)
+{
+    if (self->ring != NULL)
+        return false;
+
+    int framesPerBlock = getpagesize() / ETH_RING_FRAME_SIZE;
+
+    if (framesPerBlock < 1)
+        framesPerBlock = 1;
+
+    int blockCount = (frameCount + framesPerBlock - 1) / framesPerBlock;
+
+    if (blockCount < 1)
+        return false;
+
+    int version = TPACKET_V2;
+
+    if (setsockopt(self->rawSocket, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) == -1)
+        return false;
+
+    /* skip malformed frames instead of stopping the ring */
+    int discard = 1;
+    setsockopt(self->rawSocket, SOL_PACKET, PACKET_LOSS, &discard, sizeof(discard));
+
+    struct tpacket_req req;
+    memset(&req, 0, sizeof(req));
+
+    req.tp_block_size = framesPerBlock * ETH_RING_FRAME_SIZE;
+    req.tp_block_nr = blockCount;
+    req.tp_frame_size = ETH_RING_FRAME_SIZE;
+    req.tp_frame_nr = framesPerBlock * blockCount;
+
+    if (setsockopt(self->rawSocket, SOL_PACKET, PACKET_TX_RING, &req, sizeof(req)) == -1) {
+        if (DEBUG_SOCKET)
+            printf("ETHERNET_LINUX: Failed to create send ring\n");
+
+        return false;
+    }
+
+    if (mapRing(self, (size_t) req.tp_block_size * blockCount) == false) {
+        memset(&req, 0, sizeof(req));
+        setsockopt(self->rawSocket, SOL_PACKET, PACKET_TX_RING, &req, sizeof(req));
+
+        return false;
+    }
+
+    self->txFrameCount = req.tp_frame_nr;
+    self->txFrameIndex = 0;
+
+    return true;
+}
+
+static void
+sendPacketWithRing(EthernetSocket self, uint8_t* buffer, int packetSize)
+{
+    if (packetSize > (int) (ETH_RING_FRAME_SIZE - ETH_TX_RING_DATA_OFFSET))
+        return;
+
+    struct tpacket2_hdr* header = (struct tpacket2_hdr*) (self->ring + ((size_t) self->txFrameIndex * ETH_RING_FRAME_SIZE));
+
+    /* the kernel still owns the slot when a previous flush did not complete - flush again */
+    if (header->tp_status != TP_STATUS_AVAILABLE) {
+        sendto(self->rawSocket, NULL, 0, 0, (struct sockaddr*) &(self->socketAddress), sizeof(self->socketAddress));
+
+        if (header->tp_status != TP_STATUS_AVAILABLE) {
+            if (DEBUG_SOCKET)
+                printf("ETHERNET_LINUX: send ring full - frame dropped\n");
+
+            return;
+        }
+    }
+
+    memcpy((uint8_t*) header + ETH_TX_RING_DATA_OFFSET, buffer, packetSize);
+    header->tp_len = packetSize;
+
+    __sync_synchronize();
+    header->tp_status = TP_STATUS_SEND_REQUEST;
+
+    self->txFrameIndex = (self->txFrameIndex + 1) % self->txFrameCount;
+
+    /* GOOSE/SV frames are latency critical - flush the ring with every frame */
+    sendto(self->rawSocket, NULL, 0, 0, (struct sockaddr*) &(self->socketAddress), sizeof(self->socketAddress));
+}
+
+/* read the transmit timestamps reported by the kernel - the last one belongs to the last sent frame */
+static void
+readTransmitTimestamps(EthernetSocket self)
+{
+    uint8_t control[ETH_ERRQUEUE_CONTROL_SIZE];
+    struct msghdr message;
+
+    while (true) {
+        memset(&message, 0, sizeof(message));
+
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        if (recvmsg(self->rawSocket, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+            break;
+
+        uint64_t timestamp = getTimestamp(&message);
+
+        if (timestamp != 0)
+            self->txTimestamp = timestamp;
+    }
+}
+
+static bool
+enableHardwareTimestamps(EthernetSocket self)
+{
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(struct ifreq));
+
+    ifr.ifr_ifindex = self->socketAddress.sll_ifindex;
+
+    if (ioctl(self->rawSocket, SIOCGIFNAME, &ifr) == -1)
+        return false;
+
+    struct hwtstamp_config config;
+    memset(&config, 0, sizeof(config));
+
+    config.tx_type = HWTSTAMP_TX_ON;
+    config.rx_filter = HWTSTAMP_FILTER_ALL;
+
+    ifr.ifr_data = (void*) &config;
+
+    if (ioctl(self->rawSocket, SIOCSHWTSTAMP, &ifr) == -1) {
+        if (DEBUG_SOCKET)
+            printf("ETHERNET_LINUX: NIC does not support hardware timestamps\n");
+
+        return false;
+    }
+
+    return true;
+}
+
+bool
+Ethernet_enableTimestamping(EthernetSocket ethSocket, bool hardware)
+{
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE |
+            SOF_TIMESTAMPING_OPT_TSONLY;
+
+    if (hardware && enableHardwareTimestamps(ethSocket)) {
+        flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+
+        /* the receive ring uses software timestamps otherwise */
+        int ringFlags = SOF_TIMESTAMPING_RAW_HARDWARE;
+        setsockopt(ethSocket->rawSocket, SOL_PACKET, PACKET_TIMESTAMP, &ringFlags, sizeof(ringFlags));
+    }
+
+    if (setsockopt(ethSocket->rawSocket, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == -1) {
+        if (DEBUG_SOCKET)
+            printf("ETHERNET_LINUX: Failed to enable timestamps\n");
+
+        return false;
+    }
+
+    /* the transmit timestamps share the receive memory - a sending socket must not queue received frames */
+    if (ethSocket->hasDestination) {
+        struct sock_filter dropAll[] = {
+            BPF_STMT(BPF_RET | BPF_K, 0)
+        };
+
+        struct sock_fprog fprog;
+
+        fprog.len = 1;
+        fprog.filter = dropAll;
+
+        setsockopt(ethSocket->rawSocket, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog));
+    }
+
+    if (prepareTimestamps(ethSocket, 1) == false)
+        return false;
+
+    ethSocket->timestamping = true;
+
+    return true;
+}
+
+uint64_t
+Ethernet_getReceiveTimestamp(EthernetSocket ethSocket, int index)
+{
+    if ((index < 0) || (index >= ethSocket->rxTimestampCapacity))
+        return 0;
+
+    return ethSocket->rxTimestamps[index];
+}
+
+uint64_t
+Ethernet_getTransmitTimestamp(EthernetSocket ethSocket)
+{
+    if (ethSocket->timestamping)
+        readTransmitTimestamps(ethSocket);
+
+    return ethSocket->txTimestamp;
+}
+
 void
 Ethernet_sendPacket(EthernetSocket ethSocket, uint8_t* buffer, int packetSize)
 {
+    /* timestamps of older frames must not be reported for this frame */
+    if (ethSocket->timestamping) {
+        readTransmitTimestamps(ethSocket);
+        ethSocket->txTimestamp = 0;
+    }
+
+    /* with a send ring the socket only transmits frames from the ring */
+    if (ethSocket->txFrameCount > 0) {
+        sendPacketWithRing(ethSocket, buffer, packetSize);
+        return;
+    }
+
     sendto(ethSocket->rawSocket, buffer, packetSize,
                 0, (struct sockaddr*) &(ethSocket->socketAddress), sizeof(ethSocket->socketAddress));
 }
@@ -338,7 +1106,14 @@ Ethernet_sendPacket(EthernetSocket ethSocket, uint8_t* buffer, int packetSize)
 void
 Ethernet_destroySocket(EthernetSocket ethSocket)
 {
+    if (ethSocket->ring)
+        munmap(ethSocket->ring, ethSocket->ringSize);
+
     close(ethSocket->rawSocket);
+    GLOBAL_FREEMEM(ethSocket->rxMessages);
+    GLOBAL_FREEMEM(ethSocket->rxVectors);
+    GLOBAL_FREEMEM(ethSocket->rxTimestamps);
+    GLOBAL_FREEMEM(ethSocket->rxControl);
     GLOBAL_FREEMEM(ethSocket);
 }
 
@@ -36,6 +36,8 @@
 // Set to 1 to workaround WaitForMutlipleObjects problem (returns timeout even when packets are received)
 #define ETHERNET_WIN32_DISABLE_ETHERNET_HANDLESET 1
 
+#define ETH_FRAME_BUFFER_SIZE 1518
+
 #if (CONFIG_INCLUDE_ETHERNET_WINDOWS == 1)
 
 
@@ -407,6 +409,41 @@ Ethernet_setProtocolFilter(EthernetSocket ethSocket, uint16_t etherType)
     }
 }
 
+bool
+Ethernet_setFrameFilter(EthernetSocket ethSocket, uint16_t etherType, const uint16_t* appIds, int appIdCount,
+        const uint8_t* dstAddresses, int dstAddressCount)
+{
+    Ethernet_setProtocolFilter(ethSocket, etherType);
+
+    return false;
+}
+
+int
+Ethernet_joinFanoutGroup(EthernetSocket ethSocket, int groupId, EthernetFanoutMode mode)
+{
+    /* not supported */
+    return -1;
+}
+
+bool
+Ethernet_enableTimestamping(EthernetSocket ethSocket, bool hardware)
+{
+    /* not supported */
+    return false;
+}
+
+uint64_t
+Ethernet_getReceiveTimestamp(EthernetSocket ethSocket, int index)
+{
+    return 0;
+}
+
+uint64_t
+Ethernet_getTransmitTimestamp(EthernetSocket ethSocket)
+{
+    return 0;
+}
+
 int
 Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
 {
@@ -433,6 +470,56 @@ Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
     }
 }
 
+int
+Ethernet_receivePackets(EthernetSocket self, uint8_t** buffers, int bufferSize, int* packetSizes, int maxPackets)
+{
+    int received = 0;
+
+    while (received < maxPackets) {
+        int packetSize = Ethernet_receivePacket(self, buffers[received], bufferSize);
+
+        if (packetSize <= 0)
+            break;
+
+        packetSizes[received++] = packetSize;
+    }
+
+    return received;
+}
+
+bool
+Ethernet_setupReceiveRing(EthernetSocket self, int blockSize, int blockCount, int blockTimeout)
+{
+    return false;
+}
+
+bool
+Ethernet_setupSendRing(EthernetSocket self, int frameCount)
+{
+    return false;
+}
+
+int
+Ethernet_receiveFrames(EthernetSocket self, EthernetFrameHandler handler, void* parameter, int maxFrames)
+{
+    uint8_t buffer[ETH_FRAME_BUFFER_SIZE];
+
+    int received = 0;
+
+    while (received < maxFrames) {
+        int frameSize = Ethernet_receivePacket(self, buffer, ETH_FRAME_BUFFER_SIZE);
+
+        if (frameSize <= 0)
+            break;
+
+        handler(parameter, buffer, frameSize);
+
+        received++;
+    }
+
+    return received;
+}
+
 bool
 Ethernet_isSupported()
 {
@@ -505,10 +592,65 @@ Ethernet_setProtocolFilter(EthernetSocket ethSocket, uint16_t etherType)
 {
 }
 
+bool
+Ethernet_setFrameFilter(EthernetSocket ethSocket, uint16_t etherType, const uint16_t* appIds, int appIdCount,
+        const uint8_t* dstAddresses, int dstAddressCount)
+{
+    return false;
+}
+
+int
+Ethernet_joinFanoutGroup(EthernetSocket ethSocket, int groupId, EthernetFanoutMode mode)
+{
+    return -1;
+}
+
+bool
+Ethernet_enableTimestamping(EthernetSocket ethSocket, bool hardware)
+{
+    return false;
+}
+
+uint64_t
+Ethernet_getReceiveTimestamp(EthernetSocket ethSocket, int index)
+{
+    return 0;
+}
+
+uint64_t
+Ethernet_getTransmitTimestamp(EthernetSocket ethSocket)
+{
+    return 0;
+}
+
 int
 Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
 {
     return 0;
 }
 
+int
+Ethernet_receivePackets(EthernetSocket self, uint8_t** buffers, int bufferSize, int* packetSizes, int maxPackets)
+{
+    return 0;
+}
+
+bool
+Ethernet_setupReceiveRing(EthernetSocket self, int blockSize, int blockCount, int blockTimeout)
+{
+    return false;
+}
+
+bool
+Ethernet_setupSendRing(EthernetSocket self, int frameCount)
+{
+    return false;
+}
+
+int
+Ethernet_receiveFrames(EthernetSocket self, EthernetFrameHandler handler, void* parameter, int maxFrames)
+{
+    return 0;
+}
+
 #endif /* (CONFIG_INCLUDE_ETHERNET_WINDOWS == 1) */
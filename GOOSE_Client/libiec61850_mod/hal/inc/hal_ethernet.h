@@ -43,6 +43,12 @@ typedef enum {
     ETHERNET_SOCKET_MODE_HOST_ONLY /**<< receive only messages for the host */
 } EthernetSocketMode;
 
+typedef enum {
+    ETHERNET_FANOUT_APPID, /**<< frames with the same APPID (GOOSE, SV) are received by the same socket */
+    ETHERNET_FANOUT_HASH, /**<< distribution by the flow hash of the network stack */
+    ETHERNET_FANOUT_CPU /**<< distribution by the CPU that received the frame (RSS queue) */
+} EthernetFanoutMode;
+
 /**
  * \brief Create a new connection handle set (EthernetHandleSet)
  *
@@ -159,6 +165,93 @@ Ethernet_addMulticastAddress(EthernetSocket ethSocket, uint8_t* multicastAddress
 PAL_API void
 Ethernet_setProtocolFilter(EthernetSocket ethSocket, uint16_t etherType);
 
+/**
+ * \brief set a filter for the ether type, APPID and destination address of received frames
+ *
+ * Frames with and without VLAN tag are accepted. The APPID is the 16 bit value following the
+ * ether type (GOOSE, SV). Used in place of \ref Ethernet_setProtocolFilter. Can be called again
+ * to replace the filter.
+ *
+ * NOTE: Implementations that cannot filter APPID and destination address only set the
+ * ether type filter and return false. Large sets may be ignored by the filter as well.
+ *
+ * \param ethSocket the ethernet socket handle
+ * \param etherType the ether type of messages to accept
+ * \param appIds APPIDs to accept or NULL to accept all APPIDs
+ * \param appIdCount number of elements of appIds
+ * \param dstAddresses destination addresses to accept (6 byte each) or NULL to accept all addresses
+ * \param dstAddressCount number of addresses in dstAddresses
+ *
+ * \return true when the filter is applied by the OS/network stack, false otherwise
+ */
+PAL_API bool
+Ethernet_setFrameFilter(EthernetSocket ethSocket, uint16_t etherType, const uint16_t* appIds, int appIdCount,
+        const uint8_t* dstAddresses, int dstAddressCount);
+
+/**
+ * \brief Add the socket to a fanout group that distributes the received frames over its sockets
+ *
+ * Each received frame is passed to only one socket of the group. All sockets of a group have to
+ * use the same interface and mode.
+ *
+ * NOTE: Only supported on Linux (PACKET_FANOUT). The flow hash of \ref ETHERNET_FANOUT_HASH is
+ * usually the same for all non-IP frames.
+ *
+ * \param ethSocket the ethernet socket handle
+ * \param groupId the id of an existing group (as returned for the first socket) or -1 to create a new group
+ * \param mode how the frames are distributed
+ *
+ * \return the id of the group or -1 on failure
+ */
+PAL_API int
+Ethernet_joinFanoutGroup(EthernetSocket ethSocket, int groupId, EthernetFanoutMode mode);
+
+/**
+ * \brief Enable timestamps of the received and sent frames taken by the kernel or the NIC
+ *
+ * Software timestamps are taken by the network stack when a frame is passed from or to the driver.
+ * With hardware timestamps the NIC timestamps all frames (requires NIC support and the permission
+ * to configure the interface). Hardware timestamps use the clock of the NIC, that has to be
+ * synchronized with the system clock (e.g. by phc2sys) to compare them with the system time.
+ * Software timestamps are used for frames without hardware timestamp.
+ *
+ * A socket created with a destination address does not receive frames anymore.
+ *
+ * NOTE: Only supported on Linux (SO_TIMESTAMPING).
+ *
+ * \param ethSocket the ethernet socket handle
+ * \param hardware true to use hardware timestamps when the NIC supports them
+ *
+ * \return true when timestamps are enabled
+ */
+PAL_API bool
+Ethernet_enableTimestamping(EthernetSocket ethSocket, bool hardware);
+
+/**
+ * \brief Get the receive timestamp of a received frame
+ *
+ * \param ethSocket the ethernet socket handle
+ * \param index position of the frame in the last call of Ethernet_receivePackets - 0 for the frame of
+ *        Ethernet_receivePacket and for the frame passed to the handler of Ethernet_receiveFrames
+ *
+ * \return the timestamp in nanoseconds since epoch or 0 when not available
+ */
+PAL_API uint64_t
+Ethernet_getReceiveTimestamp(EthernetSocket ethSocket, int index);
+
+/**
+ * \brief Get the transmit timestamp of the last frame sent with Ethernet_sendPacket
+ *
+ * The kernel reports the timestamp after the frame has been passed to the driver (software) or
+ * has been sent by the NIC (hardware).
+ *
+ * \param ethSocket the ethernet socket handle
+ *
+ * \return the timestamp in nanoseconds since epoch or 0 when not (yet) available
+ */
+PAL_API uint64_t
+Ethernet_getTransmitTimestamp(EthernetSocket ethSocket);
+
 /**
  * \brief receive an ethernet packet (non-blocking)
  *
@@ -171,6 +264,77 @@ Ethernet_setProtocolFilter(EthernetSocket ethSocket, uint16_t etherType);
 PAL_API int
 Ethernet_receivePacket(EthernetSocket ethSocket, uint8_t* buffer, int bufferSize);
 
+/**
+ * \brief receive up to maxPackets Ethernet packets (non-blocking)
+ *
+ * Drains the packets that are already queued on the socket. On Linux a single recvmmsg
+ * system call is used for all packets.
+ *
+ * \param ethSocket the ethernet socket handle to use
+ * \param buffers array of maxPackets receive buffers
+ * \param bufferSize size of each receive buffer
+ * \param[out] packetSizes array of maxPackets elements for the sizes of the received packets
+ * \param maxPackets maximum number of packets to receive
+ *
+ * \return number of received packets (0 when no packet is available)
+ */
+PAL_API int
+Ethernet_receivePackets(EthernetSocket ethSocket, uint8_t** buffers, int bufferSize, int* packetSizes, int maxPackets);
+
+/**
+ * \brief Callback for \ref Ethernet_receiveFrames
+ *
+ * The frame is only valid until the callback returns.
+ *
+ * \param parameter user provided parameter
+ * \param frame the received Ethernet frame
+ * \param frameSize size of the frame in bytes
+ */
+typedef void (*EthernetFrameHandler) (void* parameter, uint8_t* frame, int frameSize);
+
+/**
+ * \brief Set up a memory mapped receive ring for the socket (Linux PACKET_MMAP, TPACKET_V3)
+ *
+ * Has to be called after \ref Ethernet_setProtocolFilter and before the first packet is received.
+ * A socket can have either a receive or a send ring.
+ *
+ * \param ethSocket the ethernet socket handle to use
+ * \param blockSize size of a ring block in bytes (multiple of the page size)
+ * \param blockCount number of blocks of the ring
+ * \param blockTimeout time in ms after which a block that is not full is passed to the application
+ *
+ * \return true when the ring is used, false when the socket keeps using the copying receive functions
+ */
+PAL_API bool
+Ethernet_setupReceiveRing(EthernetSocket ethSocket, int blockSize, int blockCount, int blockTimeout);
+
+/**
+ * \brief Set up a memory mapped send ring for the socket (Linux PACKET_MMAP, TPACKET_V2)
+ *
+ * \param ethSocket the ethernet socket handle to use
+ * \param frameCount number of frames of the ring
+ *
+ * \return true when the ring is used by \ref Ethernet_sendPacket, false otherwise
+ */
+PAL_API bool
+Ethernet_setupSendRing(EthernetSocket ethSocket, int frameCount);
+
+/**
+ * \brief Pass up to maxFrames received frames to the handler (non-blocking)
+ *
+ * With a receive ring the handler is called with the frames in the ring without copying them.
+ * Otherwise the frames are copied into a temporary buffer.
+ *
+ * \param ethSocket the ethernet socket handle to use
+ * \param handler the function that is called for each frame
+ * \param parameter user provided parameter for the handler
+ * \param maxFrames maximum number of frames to handle
+ *
+ * \return number of handled frames
+ */
+PAL_API int
+Ethernet_receiveFrames(EthernetSocket ethSocket, EthernetFrameHandler handler, void* parameter, int maxFrames);
+
 /**
  * \brief Indicates if runtime provides support for direct Ethernet access
  *
@@ -51,6 +51,9 @@ typedef struct sSocket* Socket;
 /** Opaque reference for a set of server and socket handles */
 typedef struct sHandleSet* HandleSet;
 
+/** Opaque reference for an edge triggered socket event queue (epoll) */
+typedef struct sSocketEventQueue* SocketEventQueue;
+
 /** State of an asynchronous connect */
 typedef enum
 {
@@ -115,6 +118,60 @@ Handleset_waitReady(HandleSet self, unsigned int timeoutMs);
 PAL_API void
 Handleset_destroy(HandleSet self);
 
+/**
+ * \brief Create a new socket event queue
+ *
+ * In contrast to the HandleSet the event queue reports only the sockets that became
+ * readable (edge triggered). After an event the socket has to be read until Socket_read
+ * returns 0, otherwise no new event is reported for the remaining data.
+ *
+ * Implementation of this function is OPTIONAL (only required for the server event loop -
+ * CONFIG_MMS_SERVER_EVENT_LOOP). It is only available on Linux.
+ *
+ * \return new SocketEventQueue instance or NULL if not supported
+ */
+PAL_API SocketEventQueue
+SocketEventQueue_create(void);
+
+/**
+ * \brief add a socket to the event queue
+ *
+ * \param self the SocketEventQueue instance
+ * \param sock the socket to add
+ * \param parameter user provided parameter that is returned by SocketEventQueue_waitReady
+ *
+ * \return true if the socket has been added, false otherwise
+ */
+PAL_API bool
+SocketEventQueue_addSocket(SocketEventQueue self, const Socket sock, void* parameter);
+
+/**
+ * \brief remove a socket from the event queue
+ */
+PAL_API void
+SocketEventQueue_removeSocket(SocketEventQueue self, const Socket sock);
+
+/**
+ * \brief wait for sockets that became readable
+ *
+ * \param self the SocketEventQueue instance
+ * \param parameters array to store the parameters of the ready sockets
+ * \param maxParameters size of the parameters array
+ * \param timeoutMs maximum time to wait in milliseconds (ms)
+ *
+ * \return the number of ready sockets, 0 on timeout, or -1 in case of an error
+ */
+PAL_API int
+SocketEventQueue_waitReady(SocketEventQueue self, void** parameters, int maxParameters, unsigned int timeoutMs);
+
+/**
+ * \brief destroy the SocketEventQueue instance
+ *
+ * \param self the SocketEventQueue instance to destroy
+ */
+PAL_API void
+SocketEventQueue_destroy(SocketEventQueue self);
+
 /**
  * \brief Create a new TcpServerSocket instance
  *
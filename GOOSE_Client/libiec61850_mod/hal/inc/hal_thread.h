@@ -40,6 +40,9 @@ typedef struct sThread* Thread;
 /** Qpaque reference of a Semaphore instance */
 typedef void* Semaphore;
 
+/** Opaque reference of a ThreadEvent instance */
+typedef void* ThreadEvent;
+
 /** Reference to a function that is called when starting the thread */
 typedef void* (*ThreadExecutionFunction) (void*);
 
@@ -80,6 +83,51 @@ Thread_destroy(Thread thread);
 PAL_API void
 Thread_sleep(int millies);
 
+/**
+ * \brief Restrict a started thread to run on a single CPU (core)
+ *
+ * \param thread the Thread instance (has to be started)
+ * \param cpu the number of the CPU starting with 0
+ *
+ * \return true on success, false if not supported by the platform or the CPU does not exist
+ */
+PAL_API bool
+Thread_setCpuAffinity(Thread thread, int cpu);
+
+/**
+ * \brief Run a started thread with a fixed real-time priority (SCHED_FIFO on POSIX systems)
+ *
+ * Usually requires elevated privileges (e.g. CAP_SYS_NICE on Linux).
+ *
+ * \param thread the Thread instance (has to be started)
+ * \param priority the real-time priority (1 - 99 on Linux, higher values preempt lower values)
+ *
+ * \return true on success, false if not supported by the platform or not permitted
+ */
+PAL_API bool
+Thread_setRealtimePriority(Thread thread, int priority);
+
+/**
+ * \brief Lock all current and future memory pages of the process in RAM
+ *
+ * Avoids page faults in time critical threads.
+ *
+ * \return true on success, false if not supported by the platform or not permitted
+ */
+PAL_API bool
+Thread_lockMemory(void);
+
+/**
+ * \brief Suspend execution of the Thread until an absolute time is reached
+ *
+ * Other than repeated calls of \ref Thread_sleep a loop of absolute deadlines does not accumulate
+ * the wakeup delays.
+ *
+ * \param monotonicTime the time to wake up as returned by \ref Hal_getMonotonicTimeInNs
+ */
+PAL_API void
+Thread_sleepUntil(uint64_t monotonicTime);
+
 PAL_API Semaphore
 Semaphore_create(int initialValue);
 
@@ -93,6 +141,39 @@ Semaphore_post(Semaphore self);
 PAL_API void
 Semaphore_destroy(Semaphore self);
 
+/**
+ * \brief Create a new ThreadEvent instance
+ *
+ * A thread event is an auto-reset signal. \ref ThreadEvent_signal wakes up a thread waiting
+ * in \ref ThreadEvent_waitTimeout. When no thread is waiting the signal is kept until the next wait.
+ *
+ * \return the newly created ThreadEvent instance
+ */
+PAL_API ThreadEvent
+ThreadEvent_create(void);
+
+/**
+ * \brief Wait until the event is signaled or the timeout expired
+ *
+ * \param self the ThreadEvent instance
+ * \param timeoutInMs the maximum waiting time in milliseconds
+ *
+ * \return true when the event was signaled, false when the timeout expired
+ */
+PAL_API bool
+ThreadEvent_waitTimeout(ThreadEvent self, unsigned int timeoutInMs);
+
+/**
+ * \brief Signal the event
+ *
+ * \param self the ThreadEvent instance
+ */
+PAL_API void
+ThreadEvent_signal(ThreadEvent self);
+
+PAL_API void
+ThreadEvent_destroy(ThreadEvent self);
+
 /*! @} */
 
 /*! @} */
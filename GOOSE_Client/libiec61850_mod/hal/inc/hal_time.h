@@ -68,6 +68,17 @@ Hal_getTimeInNs(void);
 PAL_API bool
 Hal_setTimeInNs(nsSinceEpoch nsTime);
 
+/**
+ * Get the time of a monotonic clock in nanoseconds.
+ *
+ * The clock has an arbitrary start and is not affected by changes of the system time.
+ * Use it to measure intervals and for deadlines (see \ref Thread_sleepUntil).
+ *
+ * \return the monotonic time with nanosecond resolution.
+ */
+PAL_API uint64_t
+Hal_getMonotonicTimeInNs(void);
+
 /*! @} */
 
 /*! @} */
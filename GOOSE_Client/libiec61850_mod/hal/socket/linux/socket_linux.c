@@ -11,6 +11,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/select.h>
+#include <sys/epoll.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <string.h>
@@ -168,6 +169,100 @@ Handleset_destroy(HandleSet self)
     }
 }
 
+#define SOCKET_EVENT_QUEUE_MAX_EVENTS 64
+
+struct sSocketEventQueue {
+    int epollFd;
+};
+
+SocketEventQueue
+SocketEventQueue_create(void)
+{
+    SocketEventQueue self = (SocketEventQueue) GLOBAL_MALLOC(sizeof(struct sSocketEventQueue));
+
+    if (self) {
+        self->epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+        if (self->epollFd == -1) {
+            if (DEBUG_SOCKET)
+                printf("SOCKET: epoll_create1 failed (errno: %i)\n", errno);
+
+            GLOBAL_FREEMEM(self);
+            self = NULL;
+        }
+    }
+
+    return self;
+}
+
+bool
+SocketEventQueue_addSocket(SocketEventQueue self, const Socket sock, void* parameter)
+{
+    if (sock->fd == -1)
+        return false;
+
+    struct epoll_event event;
+
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+    event.data.ptr = parameter;
+
+    if (epoll_ctl(self->epollFd, EPOLL_CTL_ADD, sock->fd, &event) == -1) {
+        if (DEBUG_SOCKET)
+            printf("SOCKET: epoll_ctl failed (errno: %i)\n", errno);
+
+        return false;
+    }
+
+    return true;
+}
+
+void
+SocketEventQueue_removeSocket(SocketEventQueue self, const Socket sock)
+{
+    /* event argument is ignored but has to be non-NULL for kernels before 2.6.9 */
+    struct epoll_event event;
+
+    if (sock->fd != -1)
+        epoll_ctl(self->epollFd, EPOLL_CTL_DEL, sock->fd, &event);
+}
+
+int
+SocketEventQueue_waitReady(SocketEventQueue self, void** parameters, int maxParameters, unsigned int timeoutMs)
+{
+    struct epoll_event events[SOCKET_EVENT_QUEUE_MAX_EVENTS];
+
+    if (maxParameters > SOCKET_EVENT_QUEUE_MAX_EVENTS)
+        maxParameters = SOCKET_EVENT_QUEUE_MAX_EVENTS;
+
+    int result = epoll_wait(self->epollFd, events, maxParameters, (int) timeoutMs);
+
+    if (result == -1) {
+        if (errno == EINTR)
+            return 0;
+
+        if (DEBUG_SOCKET)
+            printf("SOCKET: epoll_wait error (errno: %i)\n", errno);
+
+        return -1;
+    }
+
+    int i;
+
+    for (i = 0; i < result; i++)
+        parameters[i] = events[i].data.ptr;
+
+    return result;
+}
+
+void
+SocketEventQueue_destroy(SocketEventQueue self)
+{
+    if (self) {
+        close(self->epollFd);
+        GLOBAL_FREEMEM(self);
+    }
+}
+
 void
 Socket_activateTcpKeepAlive(Socket self, int idleTime, int interval, int count)
 {
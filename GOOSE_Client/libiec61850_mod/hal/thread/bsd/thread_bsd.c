@@ -8,8 +8,12 @@
  */
 
 #include <pthread.h>
+#include <sched.h>
 #include <semaphore.h>
 #include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/mman.h>
 #include "hal_thread.h"
 #include "lib_memory.h"
 
@@ -51,6 +55,94 @@ Semaphore_destroy(Semaphore self)
     GLOBAL_FREEMEM(self);
 }
 
+struct sThreadEvent {
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+    bool signaled;
+};
+
+ThreadEvent
+ThreadEvent_create(void)
+{
+    struct sThreadEvent* self = (struct sThreadEvent*) GLOBAL_CALLOC(1, sizeof(struct sThreadEvent));
+
+    if (self) {
+        pthread_condattr_t attr;
+
+        pthread_condattr_init(&attr);
+
+        /* timeouts are not affected by changes of the system time */
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+
+        pthread_mutex_init(&(self->mutex), NULL);
+        pthread_cond_init(&(self->condition), &attr);
+
+        pthread_condattr_destroy(&attr);
+    }
+
+    return (ThreadEvent) self;
+}
+
+bool
+ThreadEvent_waitTimeout(ThreadEvent self, unsigned int timeoutInMs)
+{
+    struct sThreadEvent* event = (struct sThreadEvent*) self;
+
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    deadline.tv_sec += timeoutInMs / 1000;
+    deadline.tv_nsec += (long) (timeoutInMs % 1000) * 1000000L;
+
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&(event->mutex));
+
+    while (event->signaled == false) {
+        if (pthread_cond_timedwait(&(event->condition), &(event->mutex), &deadline) == ETIMEDOUT)
+            break;
+    }
+
+    bool signaled = event->signaled;
+
+    event->signaled = false;
+
+    pthread_mutex_unlock(&(event->mutex));
+
+    return signaled;
+}
+
+void
+ThreadEvent_signal(ThreadEvent self)
+{
+    struct sThreadEvent* event = (struct sThreadEvent*) self;
+
+    pthread_mutex_lock(&(event->mutex));
+
+    event->signaled = true;
+
+    pthread_cond_signal(&(event->condition));
+
+    pthread_mutex_unlock(&(event->mutex));
+}
+
+void
+ThreadEvent_destroy(ThreadEvent self)
+{
+    struct sThreadEvent* event = (struct sThreadEvent*) self;
+
+    if (event) {
+        pthread_cond_destroy(&(event->condition));
+        pthread_mutex_destroy(&(event->mutex));
+
+        GLOBAL_FREEMEM(event);
+    }
+}
+
 Thread
 Thread_create(ThreadExecutionFunction function, void* parameter, bool autodestroy)
 {
@@ -107,3 +199,52 @@ Thread_sleep(int millies)
     usleep(millies * 1000);
 }
 
+bool
+Thread_setCpuAffinity(Thread thread, int cpu)
+{
+    /* not supported */
+    (void) thread;
+    (void) cpu;
+
+    return false;
+}
+
+bool
+Thread_setRealtimePriority(Thread thread, int priority)
+{
+    if ((thread->state != 1) || (priority < sched_get_priority_min(SCHED_FIFO)) ||
+            (priority > sched_get_priority_max(SCHED_FIFO)))
+        return false;
+
+    struct sched_param param;
+
+    param.sched_priority = priority;
+
+    return (pthread_setschedparam(thread->pthread, SCHED_FIFO, &param) == 0);
+}
+
+bool
+Thread_lockMemory(void)
+{
+    return (mlockall(MCL_CURRENT | MCL_FUTURE) == 0);
+}
+
+void
+Thread_sleepUntil(uint64_t monotonicTime)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    uint64_t nowNs = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+
+    if (monotonicTime > nowNs) {
+        struct timespec delay;
+
+        delay.tv_sec = (time_t) ((monotonicTime - nowNs) / 1000000000ULL);
+        delay.tv_nsec = (long) ((monotonicTime - nowNs) % 1000000000ULL);
+
+        nanosleep(&delay, NULL);
+    }
+}
+
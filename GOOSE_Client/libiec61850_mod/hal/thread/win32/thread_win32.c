@@ -12,6 +12,7 @@
 #include <windows.h>
 #include "lib_memory.h"
 #include "hal_thread.h"
+#include "hal_time.h"
 
 struct sThread {
 	ThreadExecutionFunction function;
@@ -88,6 +89,41 @@ Thread_sleep(int millies)
 	Sleep(millies);
 }
 
+bool
+Thread_setCpuAffinity(Thread thread, int cpu)
+{
+	if ((thread->state != 1) || (cpu < 0) || (cpu >= (int) (sizeof(DWORD_PTR) * 8)))
+		return false;
+
+	return (SetThreadAffinityMask(thread->handle, ((DWORD_PTR) 1) << cpu) != 0);
+}
+
+bool
+Thread_setRealtimePriority(Thread thread, int priority)
+{
+	/* Windows has no fixed priority levels - any priority maps to the highest thread priority */
+	if ((thread->state != 1) || (priority < 1))
+		return false;
+
+	return (SetThreadPriority(thread->handle, THREAD_PRIORITY_TIME_CRITICAL) != 0);
+}
+
+bool
+Thread_lockMemory(void)
+{
+	/* not supported */
+	return false;
+}
+
+void
+Thread_sleepUntil(uint64_t monotonicTime)
+{
+	uint64_t now = Hal_getMonotonicTimeInNs();
+
+	if (monotonicTime > now)
+		Sleep((DWORD) ((monotonicTime - now + 999999ULL) / 1000000ULL));
+}
+
 Semaphore
 Semaphore_create(int initialValue)
 {
@@ -114,3 +150,30 @@ Semaphore_destroy(Semaphore self)
 {
     CloseHandle((HANDLE) self);
 }
+
+ThreadEvent
+ThreadEvent_create(void)
+{
+    /* auto-reset event */
+    HANDLE self = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+    return self;
+}
+
+bool
+ThreadEvent_waitTimeout(ThreadEvent self, unsigned int timeoutInMs)
+{
+    return (WaitForSingleObject((HANDLE) self, (DWORD) timeoutInMs) == WAIT_OBJECT_0);
+}
+
+void
+ThreadEvent_signal(ThreadEvent self)
+{
+    SetEvent((HANDLE) self);
+}
+
+void
+ThreadEvent_destroy(ThreadEvent self)
+{
+    CloseHandle((HANDLE) self);
+}
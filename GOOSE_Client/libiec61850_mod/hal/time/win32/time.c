@@ -59,3 +59,20 @@ Hal_setTimeInNs(nsSinceEpoch nsTime)
     return SetSystemTime(&st);
 }
 
+uint64_t
+Hal_getMonotonicTimeInNs()
+{
+   static LARGE_INTEGER frequency;
+
+   LARGE_INTEGER counter;
+
+   if (frequency.QuadPart == 0)
+      QueryPerformanceFrequency(&frequency);
+
+   QueryPerformanceCounter(&counter);
+
+   /* split to avoid an overflow of counter * 10^9 */
+   return (uint64_t) (counter.QuadPart / frequency.QuadPart) * 1000000000ULL +
+         (uint64_t) (counter.QuadPart % frequency.QuadPart) * 1000000000ULL / (uint64_t) frequency.QuadPart;
+}
+
@@ -29,11 +29,29 @@
 
 typedef struct sMap* Map;
 
+/* slot of the open addressing hash table - key == NULL marks an empty slot */
+typedef struct sMapEntry {
+	void* key;
+	void* value;
+	uint32_t hash;
+	bool arenaKey; /* key is owned by the key arena of the map */
+} MapEntry;
+
+typedef struct sMapKeyBlock* MapKeyBlock;
+
 struct sMap {
-	LinkedList entries;
+	MapEntry* entries;
+	int size;
+	int capacity; /* number of slots - power of two or 0 */
 
 	/* client provided function to compare two keys */
 	int (*compareKeys)(void* key1, void* key2);
+
+	/* client provided hash function - has to be consistent with compareKeys */
+	uint32_t (*hashKey)(void* key);
+
+	/* memory blocks for keys copied by Map_copyKeyToArena */
+	MapKeyBlock keyBlocks;
 };
 
 LIB61850_INTERNAL Map
@@ -42,6 +60,11 @@ Map_create(void);
 LIB61850_INTERNAL int
 Map_size(Map map);
 
+/**
+ * Add an entry to the map. The key has to stay valid as long as the entry is in the map
+ * and must not be NULL. When a key is added twice Map_getEntry returns the value of the
+ * first entry.
+ */
 LIB61850_INTERNAL void*
 Map_addEntry(Map map, void* key, void* value);
 
@@ -51,6 +74,14 @@ Map_removeEntry(Map map, void* key, bool deleteKey);
 LIB61850_INTERNAL void*
 Map_getEntry(Map map, void* key);
 
+/* copy a key into the key arena of the map - released with the map */
+LIB61850_INTERNAL void*
+Map_copyKeyToArena(Map map, const void* key, int keySize);
+
+/* add an entry with a key returned by Map_copyKeyToArena - the key is never freed by deleteKey */
+LIB61850_INTERNAL void*
+Map_addEntryWithArenaKey(Map map, void* key, void* value);
+
 LIB61850_INTERNAL void
 Map_delete(Map map, bool deleteKey);
 
@@ -0,0 +1,124 @@
+/*
+ *  rcu_snapshot.h
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef RCU_SNAPSHOT_H_
+#define RCU_SNAPSHOT_H_
+
+#include "libiec61850_common_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Pointer to an immutable snapshot that is read without locks by a fixed number of reader threads
+ *
+ * Writers (serialized by the caller) publish a new snapshot instead of modifying the current one.
+ * Replaced snapshots are freed when every online reader has passed a quiescent state (a point where it
+ * holds no reference to a snapshot) after the replacement.
+ */
+typedef struct sRcuSnapshot* RcuSnapshot;
+
+/**
+ * \brief Create a new instance
+ *
+ * \param readerCount number of reader threads - readers are identified by an index 0 .. readerCount - 1
+ */
+RcuSnapshot
+RcuSnapshot_create(int readerCount);
+
+/**
+ * \brief Destroy the instance and free the current and all replaced snapshots
+ *
+ * All readers have to be offline.
+ */
+void
+RcuSnapshot_destroy(RcuSnapshot self);
+
+/**
+ * \brief Allocate memory (set to zero) for a new snapshot
+ */
+void*
+RcuSnapshot_allocate(int size);
+
+/**
+ * \brief Free a snapshot that has not been published
+ */
+void
+RcuSnapshot_free(void* snapshot);
+
+/**
+ * \brief Replace the current snapshot (writer)
+ *
+ * \param snapshot memory allocated with RcuSnapshot_allocate (can be NULL)
+ */
+void
+RcuSnapshot_publish(RcuSnapshot self, void* snapshot);
+
+/**
+ * \brief Get the epoch of the last replacement (writer)
+ *
+ * Together with RcuSnapshot_hasReaderPassed a writer can wait until no reader uses a replaced snapshot.
+ */
+uint32_t
+RcuSnapshot_getEpoch(RcuSnapshot self);
+
+/**
+ * \brief Check if a reader holds no snapshot that was replaced up to the given epoch (writer)
+ *
+ * \return true when the reader is offline or passed a quiescent state after the epoch was reached
+ */
+bool
+RcuSnapshot_hasReaderPassed(RcuSnapshot self, int reader, uint32_t epoch);
+
+/**
+ * \brief Free the replaced snapshots that are not used by a reader anymore (writer)
+ *
+ * Also done by RcuSnapshot_publish.
+ */
+void
+RcuSnapshot_reclaim(RcuSnapshot self);
+
+/**
+ * \brief Get the current snapshot (reader)
+ *
+ * The snapshot can be used until the next call of RcuSnapshot_quiescent or RcuSnapshot_setReaderOnline.
+ */
+void*
+RcuSnapshot_get(RcuSnapshot self);
+
+/**
+ * \brief Tell the writers that the reader holds no snapshot reference (reader)
+ */
+void
+RcuSnapshot_quiescent(RcuSnapshot self, int reader);
+
+/**
+ * \brief Mark the reader online (it may call RcuSnapshot_get) or offline
+ */
+void
+RcuSnapshot_setReaderOnline(RcuSnapshot self, int reader, bool online);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RCU_SNAPSHOT_H_ */
@@ -26,3 +26,10 @@
 LIB61850_INTERNAL Map
 StringMap_create(void);
 
+/**
+ * Add an entry with a copy of the key. The copy is stored in the key arena of the map
+ * and is released together with the map.
+ */
+LIB61850_INTERNAL void*
+StringMap_addEntry(Map map, const char* key, void* value);
+
@@ -24,11 +24,23 @@
 #include "libiec61850_platform_includes.h"
 #include "map.h"
 
-typedef struct sMapEntry
-{
-    void* key;
-    void* value;
-} MapEntry;
+/*
+ * Open addressing hash table with linear probing. The hash of each key is stored in
+ * the slot so that probing and growing do not have to call the hash function again
+ * and most key comparisons can be skipped. Entries are removed by backward shifting
+ * so no tombstones are required.
+ */
+
+#define MAP_INITIAL_CAPACITY 16
+
+#define MAP_KEY_BLOCK_SIZE 4096
+
+struct sMapKeyBlock {
+    MapKeyBlock next;
+    int size;
+    int used;
+    uint8_t buffer[];
+};
 
 static int
 comparePointerKeys(void* key1, void* key2)
@@ -39,123 +51,290 @@ comparePointerKeys(void* key1, void* key2)
         return -1;
 }
 
+static uint32_t
+hashPointerKey(void* key)
+{
+    uint64_t value = (uint64_t) (uintptr_t) key;
+
+    /* mix the bits - the lower bits of heap pointers are mostly zero */
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+
+    return (uint32_t) value;
+}
+
 Map
 Map_create()
 {
     Map map = (Map) GLOBAL_CALLOC(1, sizeof(struct sMap));
-    map->entries = LinkedList_create();
     map->compareKeys = comparePointerKeys;
+    map->hashKey = hashPointerKey;
     return map;
 }
 
 int
 Map_size(Map map)
 {
-    return LinkedList_size(map->entries);
+    return map->size;
+}
+
+static void
+insertIntoSlots(MapEntry* entries, int capacity, MapEntry* entry)
+{
+    uint32_t mask = (uint32_t) (capacity - 1);
+    uint32_t index = entry->hash & mask;
+
+    while (entries[index].key != NULL)
+        index = (index + 1) & mask;
+
+    entries[index] = *entry;
+}
+
+static bool
+growMap(Map map)
+{
+    int newCapacity = (map->capacity == 0) ? MAP_INITIAL_CAPACITY : (map->capacity * 2);
+
+    MapEntry* newEntries = (MapEntry*) GLOBAL_CALLOC(newCapacity, sizeof(MapEntry));
+
+    if (newEntries == NULL)
+        return false;
+
+    int i;
+
+    /* keep the insertion order of entries with the same key - the first entry is
+     * reinserted first and found first */
+    if (map->capacity > 0) {
+        uint32_t mask = (uint32_t) (map->capacity - 1);
+        int start = 0;
+
+        /* start after an empty slot so that no probe sequence wraps around the start */
+        while (map->entries[start].key != NULL)
+            start++;
+
+        for (i = 1; i <= map->capacity; i++) {
+            MapEntry* entry = &(map->entries[(start + i) & mask]);
+
+            if (entry->key != NULL)
+                insertIntoSlots(newEntries, newCapacity, entry);
+        }
+
+        GLOBAL_FREEMEM(map->entries);
+    }
+
+    map->entries = newEntries;
+    map->capacity = newCapacity;
+
+    return true;
+}
+
+static int
+findSlot(Map map, void* key, uint32_t hash)
+{
+    if (map->size == 0)
+        return -1;
+
+    uint32_t mask = (uint32_t) (map->capacity - 1);
+    uint32_t index = hash & mask;
+
+    while (map->entries[index].key != NULL) {
+        MapEntry* entry = &(map->entries[index]);
+
+        if ((entry->hash == hash) && (map->compareKeys(key, entry->key) == 0))
+            return (int) index;
+
+        index = (index + 1) & mask;
+    }
+
+    return -1;
+}
+
+static void*
+addEntry(Map map, void* key, void* value, bool arenaKey)
+{
+    if (key == NULL)
+        return NULL;
+
+    /* keep load factor below 0.75 */
+    if (((map->size + 1) * 4) > (map->capacity * 3)) {
+        if (growMap(map) == false)
+            return NULL;
+    }
+
+    MapEntry entry;
+
+    entry.key = key;
+    entry.value = value;
+    entry.hash = map->hashKey(key);
+    entry.arenaKey = arenaKey;
+
+    insertIntoSlots(map->entries, map->capacity, &entry);
+
+    map->size++;
+
+    return key;
 }
 
 void*
 Map_addEntry(Map map, void* key, void* value)
 {
-    MapEntry* entry = (MapEntry*) GLOBAL_MALLOC(sizeof(MapEntry));
-    entry->key = key;
-    entry->value = value;
-    LinkedList_add(map->entries, entry);
+    return addEntry(map, key, value, false);
+}
 
-    return entry->key;
+void*
+Map_addEntryWithArenaKey(Map map, void* key, void* value)
+{
+    return addEntry(map, key, value, true);
 }
 
 void*
 Map_removeEntry(Map map, void* key, bool deleteKey)
 {
-    LinkedList element = map->entries;
-    LinkedList lastElement = element;
-    MapEntry* entry;
-    void* value = NULL;
+    int slot = findSlot(map, key, map->hashKey(key));
 
-    while ((element = LinkedList_getNext(element)) != NULL) {
-        entry = (MapEntry*) element->data;
+    if (slot == -1)
+        return NULL;
 
-        if (map->compareKeys(key, entry->key) == 0) {
-            lastElement->next = element->next;
-            value = entry->value;
+    MapEntry* entries = map->entries;
+    uint32_t mask = (uint32_t) (map->capacity - 1);
+    uint32_t index = (uint32_t) slot;
 
-            if (deleteKey == true)
-                GLOBAL_FREEMEM(entry->key);
-            GLOBAL_FREEMEM(entry);
-            GLOBAL_FREEMEM(element);
+    void* value = entries[index].value;
+
+    if ((deleteKey == true) && (entries[index].arenaKey == false))
+        GLOBAL_FREEMEM(entries[index].key);
+
+    /* backward shift deletion - move following entries of the cluster into the gap
+     * when the gap is between their home slot and their current slot */
+    uint32_t next = (index + 1) & mask;
 
-            break;
+    while (entries[next].key != NULL) {
+        uint32_t home = entries[next].hash & mask;
+
+        if (((next - home) & mask) >= ((next - index) & mask)) {
+            entries[index] = entries[next];
+            index = next;
         }
 
-        lastElement = element;
+        next = (next + 1) & mask;
     }
 
+    entries[index].key = NULL;
+    entries[index].value = NULL;
+
+    map->size--;
+
     return value;
 }
 
 void*
 Map_getEntry(Map map, void* key)
 {
-    LinkedList element = map->entries;
+    int slot = findSlot(map, key, map->hashKey(key));
+
+    if (slot == -1)
+        return NULL;
+
+    return map->entries[slot].value;
+}
+
+void*
+Map_copyKeyToArena(Map map, const void* key, int keySize)
+{
+    MapKeyBlock block = map->keyBlocks;
+
+    if ((block == NULL) || ((block->size - block->used) < keySize)) {
+        int blockSize = (keySize > MAP_KEY_BLOCK_SIZE) ? keySize : MAP_KEY_BLOCK_SIZE;
+
+        block = (MapKeyBlock) GLOBAL_MALLOC(sizeof(struct sMapKeyBlock) + blockSize);
 
-    while ((element = LinkedList_getNext(element)) != NULL) {
-        MapEntry* entry = (MapEntry*) element->data;
-        if (map->compareKeys(key, entry->key) == 0) {
-            return entry->value;
-        };
+        if (block == NULL)
+            return NULL;
+
+        block->size = blockSize;
+        block->used = 0;
+        block->next = map->keyBlocks;
+        map->keyBlocks = block;
     }
 
-    return NULL;
+    void* keyCopy = block->buffer + block->used;
+
+    memcpy(keyCopy, key, keySize);
+
+    block->used += keySize;
+
+    return keyCopy;
+}
+
+static void
+releaseMap(Map map)
+{
+    MapKeyBlock block = map->keyBlocks;
+
+    while (block) {
+        MapKeyBlock next = block->next;
+        GLOBAL_FREEMEM(block);
+        block = next;
+    }
+
+    if (map->entries)
+        GLOBAL_FREEMEM(map->entries);
+
+    GLOBAL_FREEMEM(map);
 }
 
 void
 Map_delete(Map map, bool deleteKey)
 {
-    LinkedList element = map->entries;
+    int i;
+
+    for (i = 0; i < map->capacity; i++) {
+        MapEntry* entry = &(map->entries[i]);
 
-    while ((element = LinkedList_getNext(element)) != NULL) {
-        MapEntry* entry = (MapEntry*) element->data;
-        if (deleteKey == true)
-            GLOBAL_FREEMEM(entry->key);
-        GLOBAL_FREEMEM(entry->value);
+        if (entry->key != NULL) {
+            if ((deleteKey == true) && (entry->arenaKey == false))
+                GLOBAL_FREEMEM(entry->key);
+            GLOBAL_FREEMEM(entry->value);
+        }
     }
 
-    LinkedList_destroy(map->entries);
-    GLOBAL_FREEMEM(map);
+    releaseMap(map);
 }
 
 void
 Map_deleteStatic(Map map, bool deleteKey)
 {
-    LinkedList element = map->entries;
+    int i;
 
     if (deleteKey == true) {
-        while ((element = LinkedList_getNext(element)) != NULL) {
-            MapEntry* entry = (MapEntry*) element->data;
-            GLOBAL_FREEMEM(entry->key);
+        for (i = 0; i < map->capacity; i++) {
+            MapEntry* entry = &(map->entries[i]);
+
+            if ((entry->key != NULL) && (entry->arenaKey == false))
+                GLOBAL_FREEMEM(entry->key);
         }
     }
 
-    LinkedList_destroy(map->entries);
-    GLOBAL_FREEMEM(map);
+    releaseMap(map);
 }
 
 void
 Map_deleteDeep(Map map, bool deleteKey, void (*valueDeleteFunction)(void*))
 {
     if (map) {
-        LinkedList element = map->entries;
+        int i;
 
-        while ((element = LinkedList_getNext(element)) != NULL) {
-            MapEntry* entry = (MapEntry*) element->data;
-            if (deleteKey == true)
-                GLOBAL_FREEMEM(entry->key);
-            valueDeleteFunction(entry->value);
-        }
+        for (i = 0; i < map->capacity; i++) {
+            MapEntry* entry = &(map->entries[i]);
 
-        LinkedList_destroy(map->entries);
+            if (entry->key != NULL) {
+                if ((deleteKey == true) && (entry->arenaKey == false))
+                    GLOBAL_FREEMEM(entry->key);
+                valueDeleteFunction(entry->value);
+            }
+        }
 
-        GLOBAL_FREEMEM(map);
+        releaseMap(map);
     }
 }
@@ -0,0 +1,218 @@
+/*
+ *  rcu_snapshot.c
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include "libiec61850_platform_includes.h"
+#include "lib_memory.h"
+#include "rcu_snapshot.h"
+
+#if defined(_MSC_VER)
+#include <windows.h>
+
+#define ATOMIC_LOAD(ptr) (MemoryBarrier(), *(ptr))
+#define ATOMIC_STORE_UINT32(ptr, value) InterlockedExchange((volatile LONG*) (ptr), (LONG) (value))
+#define ATOMIC_STORE_BOOL(ptr, value) do { MemoryBarrier(); *(ptr) = (value); MemoryBarrier(); } while (0)
+#define ATOMIC_EXCHANGE_POINTER(ptr, value) InterlockedExchangePointer((PVOID volatile*) (ptr), (value))
+#define ATOMIC_INCREMENT_UINT32(ptr) ((uint32_t) InterlockedIncrement((volatile LONG*) (ptr)))
+#else
+/* all accesses are sequentially consistent - the protocol relies on the order of stores and loads */
+#define ATOMIC_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#define ATOMIC_STORE_UINT32(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_SEQ_CST)
+#define ATOMIC_STORE_BOOL(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_SEQ_CST)
+#define ATOMIC_EXCHANGE_POINTER(ptr, value) __atomic_exchange_n((ptr), (value), __ATOMIC_SEQ_CST)
+#define ATOMIC_INCREMENT_UINT32(ptr) __atomic_add_fetch((ptr), 1, __ATOMIC_SEQ_CST)
+#endif
+
+typedef struct sRcuSnapshotHeader* RcuSnapshotHeader;
+
+/* placed in front of every snapshot */
+struct sRcuSnapshotHeader {
+    RcuSnapshotHeader nextRetired;
+    uint32_t retireEpoch; /* the snapshot can be freed when all readers have seen this epoch */
+};
+
+/* one cache line per reader - the readers do not invalidate each other's cache */
+typedef union {
+    struct {
+        uint32_t epoch; /* epoch seen by the reader in its last quiescent state */
+        bool online;
+    } state;
+
+    uint8_t padding[64];
+} RcuSnapshotReader;
+
+struct sRcuSnapshot {
+    void* current;
+
+    uint32_t epoch; /* incremented with every replaced snapshot */
+
+    RcuSnapshotHeader retired; /* replaced snapshots that may still be used by a reader */
+
+    int readerCount;
+    RcuSnapshotReader* readers;
+};
+
+static RcuSnapshotHeader
+getHeader(void* snapshot)
+{
+    return (RcuSnapshotHeader) ((uint8_t*) snapshot - sizeof(struct sRcuSnapshotHeader));
+}
+
+RcuSnapshot
+RcuSnapshot_create(int readerCount)
+{
+    RcuSnapshot self = (RcuSnapshot) GLOBAL_CALLOC(1, sizeof(struct sRcuSnapshot));
+
+    if (self) {
+        self->readerCount = readerCount;
+        self->readers = (RcuSnapshotReader*) GLOBAL_CALLOC(readerCount, sizeof(RcuSnapshotReader));
+
+        if (self->readers == NULL) {
+            GLOBAL_FREEMEM(self);
+            self = NULL;
+        }
+    }
+
+    return self;
+}
+
+void*
+RcuSnapshot_allocate(int size)
+{
+    uint8_t* memory = (uint8_t*) GLOBAL_CALLOC(1, sizeof(struct sRcuSnapshotHeader) + size);
+
+    if (memory == NULL)
+        return NULL;
+
+    return memory + sizeof(struct sRcuSnapshotHeader);
+}
+
+void
+RcuSnapshot_free(void* snapshot)
+{
+    if (snapshot)
+        GLOBAL_FREEMEM(getHeader(snapshot));
+}
+
+void
+RcuSnapshot_reclaim(RcuSnapshot self)
+{
+    /* oldest epoch seen by an online reader - the current epoch when all readers are offline */
+    uint32_t minEpoch = ATOMIC_LOAD(&(self->epoch));
+
+    int i;
+
+    for (i = 0; i < self->readerCount; i++) {
+        RcuSnapshotReader* reader = &(self->readers[i]);
+
+        if (ATOMIC_LOAD(&(reader->state.online))) {
+            uint32_t readerEpoch = ATOMIC_LOAD(&(reader->state.epoch));
+
+            /* wrap around safe comparison of readerEpoch < minEpoch */
+            if ((int32_t) (readerEpoch - minEpoch) < 0)
+                minEpoch = readerEpoch;
+        }
+    }
+
+    RcuSnapshotHeader* slot = &(self->retired);
+
+    while (*slot) {
+        RcuSnapshotHeader header = *slot;
+
+        /* wrap around safe comparison of minEpoch >= retireEpoch */
+        if ((int32_t) (minEpoch - header->retireEpoch) >= 0) {
+            *slot = header->nextRetired;
+            GLOBAL_FREEMEM(header);
+        }
+        else
+            slot = &(header->nextRetired);
+    }
+}
+
+void
+RcuSnapshot_publish(RcuSnapshot self, void* snapshot)
+{
+    void* oldSnapshot = ATOMIC_EXCHANGE_POINTER(&(self->current), snapshot);
+
+    if (oldSnapshot) {
+        RcuSnapshotHeader header = getHeader(oldSnapshot);
+
+        header->retireEpoch = ATOMIC_INCREMENT_UINT32(&(self->epoch));
+        header->nextRetired = self->retired;
+        self->retired = header;
+    }
+
+    RcuSnapshot_reclaim(self);
+}
+
+uint32_t
+RcuSnapshot_getEpoch(RcuSnapshot self)
+{
+    return ATOMIC_LOAD(&(self->epoch));
+}
+
+bool
+RcuSnapshot_hasReaderPassed(RcuSnapshot self, int reader, uint32_t epoch)
+{
+    RcuSnapshotReader* readerState = &(self->readers[reader]);
+
+    if (ATOMIC_LOAD(&(readerState->state.online)) == false)
+        return true;
+
+    /* wrap around safe comparison of readerEpoch >= epoch */
+    return ((int32_t) (ATOMIC_LOAD(&(readerState->state.epoch)) - epoch) >= 0);
+}
+
+void*
+RcuSnapshot_get(RcuSnapshot self)
+{
+    return ATOMIC_LOAD(&(self->current));
+}
+
+void
+RcuSnapshot_quiescent(RcuSnapshot self, int reader)
+{
+    ATOMIC_STORE_UINT32(&(self->readers[reader].state.epoch), ATOMIC_LOAD(&(self->epoch)));
+}
+
+void
+RcuSnapshot_setReaderOnline(RcuSnapshot self, int reader, bool online)
+{
+    ATOMIC_STORE_BOOL(&(self->readers[reader].state.online), online);
+
+    if (online)
+        RcuSnapshot_quiescent(self, reader);
+}
+
+void
+RcuSnapshot_destroy(RcuSnapshot self)
+{
+    if (self) {
+        int i;
+
+        for (i = 0; i < self->readerCount; i++)
+            ATOMIC_STORE_BOOL(&(self->readers[i].state.online), false);
+
+        RcuSnapshot_publish(self, NULL);
+
+        GLOBAL_FREEMEM(self->readers);
+        GLOBAL_FREEMEM(self);
+    }
+}
@@ -24,9 +24,36 @@
 #include "libiec61850_platform_includes.h"
 #include "string_map.h"
 
+/* FNV-1a */
+static uint32_t
+hashStringKey(void* key)
+{
+	const uint8_t* str = (const uint8_t*) key;
+	uint32_t hash = 2166136261u;
+
+	while (*str) {
+		hash ^= *str++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
 Map
 StringMap_create() {
 	Map map = Map_create();
 	map->compareKeys = (int (*) (void*, void*)) strcmp;
+	map->hashKey = hashStringKey;
 	return map;
 }
+
+void*
+StringMap_addEntry(Map map, const char* key, void* value)
+{
+	void* keyCopy = Map_copyKeyToArena(map, key, (int) strlen(key) + 1);
+
+	if (keyCopy == NULL)
+		return NULL;
+
+	return Map_addEntryWithArenaKey(map, keyCopy, value);
+}
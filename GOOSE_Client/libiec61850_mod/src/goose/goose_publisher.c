@@ -35,9 +35,36 @@
 
 #define GOOSE_MAX_MESSAGE_SIZE 1518
 
+#ifndef CONFIG_ETHERNET_USE_PACKET_MMAP
+#define CONFIG_ETHERNET_USE_PACKET_MMAP 0
+#endif
+
+#ifndef CONFIG_ETHERNET_TX_RING_FRAME_COUNT
+#define CONFIG_ETHERNET_TX_RING_FRAME_COUNT 64
+#endif
+
 static bool
 prepareGooseBuffer(GoosePublisher self, CommParameters* parameters, const char* interfaceID, bool useVlanTags);
 
+/* positions (relative to payload start) of the fields patched in a pre-encoded frame */
+typedef struct sGooseFrameLayout {
+    int timestampPos;
+    int stNumPos;
+    int stNumSize;
+    int sqNumPos;
+    int sqNumSize;
+    int valueCount; /* number of elements of valuePos and valueSize */
+    int* valuePos;
+    int* valueSize;
+} GooseFrameLayout;
+
+typedef struct sGooseFrameTemplate {
+    bool valid; /* false when the buffer has to be encoded again */
+    LinkedList dataSet; /* owned by the caller, has to outlive the template */
+    MmsValue** values; /* layout.valueCount elements */
+    GooseFrameLayout layout;
+} GooseFrameTemplate;
+
 struct sGoosePublisher {
     uint8_t* buffer;
 
@@ -58,8 +85,18 @@ struct sGoosePublisher {
     bool simulation;
 
     MmsValue* timestamp; /* time when stNum is increased */
+    uint8_t timeQuality; /* quality byte used by GoosePublisher_setTimestampNs */
+
+    GooseFrameTemplate* frame;
 };
 
+static void
+invalidateFrameTemplate(GoosePublisher self)
+{
+    if (self->frame)
+        self->frame->valid = false;
+}
+
 GoosePublisher
 GoosePublisher_createEx(CommParameters* parameters, const char* interfaceID, bool useVlanTag)
 {
@@ -69,6 +106,7 @@ GoosePublisher_createEx(CommParameters* parameters, const char* interfaceID, boo
     {
         if (prepareGooseBuffer(self, parameters, interfaceID, useVlanTag)) {
             self->timestamp = MmsValue_newUtcTimeByMsTime(Hal_getTimeInMs());
+            self->timeQuality = 0x0a; /* 10 bit sub-second time accuracy, as MmsValue_setUtcTimeMs */
 
             GoosePublisher_reset(self);
         }
@@ -98,6 +136,8 @@ GoosePublisher_destroy(GoosePublisher self)
 
         MmsValue_delete(self->timestamp);
 
+        GoosePublisher_releaseFrameTemplate(self);
+
         if (self->goID)
             GLOBAL_FREEMEM(self->goID);
 
@@ -121,6 +161,8 @@ GoosePublisher_setGoID(GoosePublisher self, char* goID)
         GLOBAL_FREEMEM(self->goID);
 
     self->goID = StringUtils_copyString(goID);
+
+    invalidateFrameTemplate(self);
 }
 
 void
@@ -130,6 +172,8 @@ GoosePublisher_setGoCbRef(GoosePublisher self, char* goCbRef)
         GLOBAL_FREEMEM(self->goCBRef);
 
     self->goCBRef = StringUtils_copyString(goCbRef);
+
+    invalidateFrameTemplate(self);
 }
 
 void
@@ -139,18 +183,24 @@ GoosePublisher_setDataSetRef(GoosePublisher self, char* dataSetRef)
         GLOBAL_FREEMEM(self->dataSetRef);
 
     self->dataSetRef = StringUtils_copyString(dataSetRef);
+
+    invalidateFrameTemplate(self);
 }
 
 void
 GoosePublisher_setConfRev(GoosePublisher self, uint32_t confRev)
 {
     self->confRev = confRev;
+
+    invalidateFrameTemplate(self);
 }
 
 void
 GoosePublisher_setSimulation(GoosePublisher self, bool simulation)
 {
     self->simulation = simulation;
+
+    invalidateFrameTemplate(self);
 }
 
 void
@@ -163,6 +213,46 @@ void GoosePublisher_setTimestamp(GoosePublisher self, uint64_t customTime) {
     MmsValue_setUtcTimeMs(self->timestamp, customTime);
 }
 
+void
+GoosePublisher_setTimestampNs(GoosePublisher self, uint64_t timestampNs)
+{
+    uint8_t* utcTime = self->timestamp->value.utcTime;
+
+    uint32_t seconds = (uint32_t) (timestampNs / 1000000000ULL);
+    uint64_t remainder = timestampNs % 1000000000ULL;
+
+    /* binary fraction of second with 24 bit (~60 ns) resolution */
+    uint32_t fractionOfSecond = (uint32_t) ((remainder << 24) / 1000000000ULL);
+
+    utcTime[0] = (uint8_t) (seconds >> 24);
+    utcTime[1] = (uint8_t) (seconds >> 16);
+    utcTime[2] = (uint8_t) (seconds >> 8);
+    utcTime[3] = (uint8_t) seconds;
+    utcTime[4] = (uint8_t) (fractionOfSecond >> 16);
+    utcTime[5] = (uint8_t) (fractionOfSecond >> 8);
+    utcTime[6] = (uint8_t) fractionOfSecond;
+    utcTime[7] = self->timeQuality;
+}
+
+void
+GoosePublisher_setTimeQuality(GoosePublisher self, bool leapSecondKnown, bool clockFailure, bool clockNotSynchronized, int subsecondPrecision)
+{
+    uint8_t timeQuality = 0;
+
+    if (leapSecondKnown)
+        timeQuality |= 0x80;
+
+    if (clockFailure)
+        timeQuality |= 0x40;
+
+    if (clockNotSynchronized)
+        timeQuality |= 0x20;
+
+    timeQuality |= (uint8_t) (subsecondPrecision & 0x1f);
+
+    self->timeQuality = timeQuality;
+}
+
 void
 GoosePublisher_setSqNum(GoosePublisher self, uint32_t sqNum)
 {
@@ -173,6 +263,8 @@ void
 GoosePublisher_setNeedsCommission(GoosePublisher self, bool ndsCom)
 {
     self->needsCommission = ndsCom;
+
+    invalidateFrameTemplate(self);
 }
 
 uint64_t
@@ -203,6 +295,8 @@ void
 GoosePublisher_setTimeAllowedToLive(GoosePublisher self, uint32_t timeAllowedToLive)
 {
     self->timeAllowedToLive = timeAllowedToLive;
+
+    invalidateFrameTemplate(self);
 }
 
 static bool
@@ -241,6 +335,11 @@ prepareGooseBuffer(GoosePublisher self, CommParameters* parameters, const char*
         self->ethernetSocket = Ethernet_createSocket(CONFIG_ETHERNET_INTERFACE_ID, dstAddr);
 
     if (self->ethernetSocket) {
+#if (CONFIG_ETHERNET_USE_PACKET_MMAP == 1)
+        if ((Ethernet_setupSendRing(self->ethernetSocket, CONFIG_ETHERNET_TX_RING_FRAME_COUNT) == false) && DEBUG_GOOSE_PUBLISHER)
+            printf("GOOSE_PUBLISHER: no send ring - use socket send\n");
+#endif
+
         self->buffer = (uint8_t*) GLOBAL_MALLOC(GOOSE_MAX_MESSAGE_SIZE);
 
         if (self->buffer == NULL) {
@@ -299,7 +398,8 @@ prepareGooseBuffer(GoosePublisher self, CommParameters* parameters, const char*
     }
 }
 
-static int32_t createGoosePayload(GoosePublisher self, LinkedList dataSetValues, uint8_t* buffer, size_t maxPayloadSize) {
+static int32_t createGoosePayload(GoosePublisher self, LinkedList dataSetValues, uint8_t* buffer, size_t maxPayloadSize,
+        GooseFrameLayout* layout) {
 
     /* Step 1 - calculate length fields */
     uint32_t goosePduLength = 0;
@@ -384,12 +484,25 @@ static int32_t createGoosePayload(GoosePublisher self, LinkedList dataSetValues,
     /* Encode t */
     bufPos = BerEncoder_encodeOctetString(0x84, self->timestamp->value.utcTime, 8, buffer, bufPos);
 
+    if (layout)
+        layout->timestampPos = bufPos - 8;
+
     /* Encode stNum */
     bufPos = BerEncoder_encodeUInt32WithTL(0x85, self->stNum, buffer, bufPos);
 
+    if (layout) {
+        layout->stNumSize = BerEncoder_UInt32determineEncodedSize(self->stNum);
+        layout->stNumPos = bufPos - layout->stNumSize;
+    }
+
     /* Encode sqNum */
     bufPos = BerEncoder_encodeUInt32WithTL(0x86, self->sqNum, buffer, bufPos);
 
+    if (layout) {
+        layout->sqNumSize = BerEncoder_UInt32determineEncodedSize(self->sqNum);
+        layout->sqNumPos = bufPos - layout->sqNumSize;
+    }
+
     /* Encode simulation */
     bufPos = BerEncoder_encodeBoolean(0x87, self->simulation, buffer, bufPos);
 
@@ -408,9 +521,13 @@ static int32_t createGoosePayload(GoosePublisher self, LinkedList dataSetValues,
     /* Encode data set entries */
     element = LinkedList_getNext(dataSetValues);
 
+    int entryIndex = 0;
+
     while (element) {
         MmsValue* dataSetEntry = (MmsValue*) element->data;
 
+        int entryStart = bufPos;
+
         if (dataSetEntry) {
             bufPos = MmsValue_encodeMmsData(dataSetEntry, buffer, bufPos, true);
         }
@@ -418,12 +535,30 @@ static int32_t createGoosePayload(GoosePublisher self, LinkedList dataSetValues,
             /* TODO encode MMS NULL */
         }
 
+        if (layout && (entryIndex < layout->valueCount)) {
+            layout->valuePos[entryIndex] = entryStart;
+            layout->valueSize[entryIndex] = bufPos - entryStart;
+        }
+
+        entryIndex++;
+
         element = LinkedList_getNext(element);
     }
 
     return bufPos;
 }
 
+static void
+setGooseLengthField(GoosePublisher self)
+{
+    int lengthIndex = self->lengthField;
+
+    size_t gooseLength = self->payloadLength + 8;
+
+    self->buffer[lengthIndex] = gooseLength / 256;
+    self->buffer[lengthIndex + 1] = gooseLength & 0xff;
+}
+
 int
 GoosePublisher_publish(GoosePublisher self, LinkedList dataSet)
 {
@@ -431,7 +566,10 @@ GoosePublisher_publish(GoosePublisher self, LinkedList dataSet)
 
     size_t maxPayloadSize = GOOSE_MAX_MESSAGE_SIZE - self->payloadStart;
 
-    self->payloadLength = createGoosePayload(self, dataSet, buffer, maxPayloadSize);
+    /* the buffer is shared with a pre-encoded frame */
+    invalidateFrameTemplate(self);
+
+    self->payloadLength = createGoosePayload(self, dataSet, buffer, maxPayloadSize, NULL);
 
     if (self->payloadLength == -1)
         return -1;
@@ -441,12 +579,7 @@ GoosePublisher_publish(GoosePublisher self, LinkedList dataSet)
     if (self->sqNum == 0)
         self->sqNum = 1;
 
-    int lengthIndex = self->lengthField;
-
-    size_t gooseLength = self->payloadLength + 8;
-
-    self->buffer[lengthIndex] = gooseLength / 256;
-    self->buffer[lengthIndex + 1] = gooseLength & 0xff;
+    setGooseLengthField(self);
 
     if (DEBUG_GOOSE_PUBLISHER)
         printf("GOOSE_PUBLISHER: send GOOSE message\n");
@@ -474,3 +607,214 @@ GoosePublisher_publishAndDump(GoosePublisher self, LinkedList dataSet, char *msg
 
     return rc;
 }
+
+static void
+freeFrameTemplateValues(GooseFrameTemplate* frame)
+{
+    if (frame->values)
+        GLOBAL_FREEMEM(frame->values);
+
+    if (frame->layout.valuePos)
+        GLOBAL_FREEMEM(frame->layout.valuePos);
+
+    if (frame->layout.valueSize)
+        GLOBAL_FREEMEM(frame->layout.valueSize);
+
+    frame->values = NULL;
+    frame->layout.valuePos = NULL;
+    frame->layout.valueSize = NULL;
+    frame->layout.valueCount = 0;
+}
+
+/* read the values of the data set list again - the list can be changed after the template was prepared */
+static bool
+updateFrameTemplateValues(GooseFrameTemplate* frame)
+{
+    int valueCount = LinkedList_size(frame->dataSet);
+
+    if (valueCount != frame->layout.valueCount) {
+        freeFrameTemplateValues(frame);
+
+        if (valueCount > 0) {
+            frame->values = (MmsValue**) GLOBAL_CALLOC(valueCount, sizeof(MmsValue*));
+            frame->layout.valuePos = (int*) GLOBAL_CALLOC(valueCount, sizeof(int));
+            frame->layout.valueSize = (int*) GLOBAL_CALLOC(valueCount, sizeof(int));
+
+            if ((frame->values == NULL) || (frame->layout.valuePos == NULL) || (frame->layout.valueSize == NULL)) {
+                freeFrameTemplateValues(frame);
+                return false;
+            }
+
+            frame->layout.valueCount = valueCount;
+        }
+    }
+
+    LinkedList element = LinkedList_getNext(frame->dataSet);
+
+    int i = 0;
+
+    while (element) {
+        frame->values[i++] = (MmsValue*) element->data;
+        element = LinkedList_getNext(element);
+    }
+
+    return true;
+}
+
+static bool
+encodeFrameTemplate(GoosePublisher self)
+{
+    GooseFrameTemplate* frame = self->frame;
+
+    if (updateFrameTemplateValues(frame) == false)
+        return false;
+
+    int32_t payloadLength = createGoosePayload(self, frame->dataSet, self->buffer + self->payloadStart,
+            GOOSE_MAX_MESSAGE_SIZE - self->payloadStart, &(frame->layout));
+
+    if (payloadLength == -1)
+        return false;
+
+    self->payloadLength = payloadLength;
+
+    setGooseLengthField(self);
+
+    frame->valid = true;
+
+    return true;
+}
+
+bool
+GoosePublisher_prepareFrameTemplate(GoosePublisher self, LinkedList dataSet)
+{
+    GoosePublisher_releaseFrameTemplate(self);
+
+    GooseFrameTemplate* frame = (GooseFrameTemplate*) GLOBAL_CALLOC(1, sizeof(GooseFrameTemplate));
+
+    if (frame == NULL)
+        return false;
+
+    frame->dataSet = dataSet;
+
+    self->frame = frame;
+
+    if (encodeFrameTemplate(self) == false) {
+        if (DEBUG_GOOSE_PUBLISHER)
+            printf("GOOSE_PUBLISHER: data set too large for frame template or out of memory\n");
+
+        GoosePublisher_releaseFrameTemplate(self);
+        return false;
+    }
+
+    return true;
+}
+
+void
+GoosePublisher_releaseFrameTemplate(GoosePublisher self)
+{
+    GooseFrameTemplate* frame = self->frame;
+
+    if (frame) {
+        freeFrameTemplateValues(frame);
+
+        GLOBAL_FREEMEM(frame);
+
+        self->frame = NULL;
+    }
+}
+
+bool
+GoosePublisher_updateFrameValues(GoosePublisher self)
+{
+    GooseFrameTemplate* frame = self->frame;
+
+    if (frame == NULL)
+        return false;
+
+    if (frame->valid == false)
+        return true; /* encoded from scratch with the next publish */
+
+    /* elements added to or removed from the data set list invalidate the cached positions */
+    if (LinkedList_size(frame->dataSet) != frame->layout.valueCount) {
+        frame->valid = false;
+        return true;
+    }
+
+    uint8_t* buffer = self->buffer + self->payloadStart;
+
+    int i;
+
+    for (i = 0; i < frame->layout.valueCount; i++) {
+        MmsValue* value = frame->values[i];
+
+        if (value == NULL)
+            continue;
+
+        if (MmsValue_encodeMmsData(value, NULL, 0, false) == frame->layout.valueSize[i]) {
+            MmsValue_encodeMmsData(value, buffer, frame->layout.valuePos[i], true);
+        }
+        else {
+            /* encoded size changed -> all following positions move */
+            frame->valid = false;
+            break;
+        }
+    }
+
+    return true;
+}
+
+int
+GoosePublisher_publishFrame(GoosePublisher self)
+{
+    GooseFrameTemplate* frame = self->frame;
+
+    if (frame == NULL)
+        return -1;
+
+    GooseFrameLayout* layout = &(frame->layout);
+
+    if (frame->valid) {
+        /* BER integers have to be minimal so a width change needs a new encoding */
+        if ((BerEncoder_UInt32determineEncodedSize(self->stNum) != layout->stNumSize) ||
+            (BerEncoder_UInt32determineEncodedSize(self->sqNum) != layout->sqNumSize))
+        {
+            frame->valid = false;
+        }
+    }
+
+    if (frame->valid) {
+        uint8_t* buffer = self->buffer + self->payloadStart;
+
+        memcpy(buffer + layout->timestampPos, self->timestamp->value.utcTime, 8);
+        BerEncoder_encodeUInt32(self->stNum, buffer, layout->stNumPos);
+        BerEncoder_encodeUInt32(self->sqNum, buffer, layout->sqNumPos);
+    }
+    else {
+        if (encodeFrameTemplate(self) == false)
+            return -1;
+    }
+
+    self->sqNum++;
+
+    if (self->sqNum == 0)
+        self->sqNum = 1;
+
+    if (DEBUG_GOOSE_PUBLISHER)
+        printf("GOOSE_PUBLISHER: send GOOSE message (frame template)\n");
+
+    Ethernet_sendPacket(self->ethernetSocket, self->buffer, self->payloadStart + self->payloadLength);
+
+    return 0;
+}
+
+bool
+GoosePublisher_enableTimestamping(GoosePublisher self, bool hardware)
+{
+    return Ethernet_enableTimestamping(self->ethernetSocket, hardware);
+}
+
+uint64_t
+GoosePublisher_getTransmitTimestampNs(GoosePublisher self)
+{
+    return Ethernet_getTransmitTimestamp(self->ethernetSocket);
+}
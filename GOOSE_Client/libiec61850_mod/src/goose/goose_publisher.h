@@ -103,6 +103,60 @@ GoosePublisher_publish(GoosePublisher self, LinkedList dataSet);
 LIB61850_API int
 GoosePublisher_publishAndDump(GoosePublisher self, LinkedList dataSet, char* msgBuf, int32_t* msgLen, int32_t bufSize);
 
+/**
+ * \brief Encode the complete GOOSE frame for the given data set once and keep it for \ref GoosePublisher_publishFrame
+ *
+ * The data set list and its MmsValue instances are referenced, not copied, and have to stay valid
+ * until \ref GoosePublisher_releaseFrameTemplate is called or the publisher is destroyed.
+ * Changing any of the header parameters (goID, goCbRef, datSet, confRev, timeAllowedToLive, simulation,
+ * ndsCom) or calling \ref GoosePublisher_publish causes the frame to be encoded again on the next
+ * call of \ref GoosePublisher_publishFrame.
+ *
+ * \param self GoosePublisher instance
+ * \param dataSet the GOOSE data set that is sent with \ref GoosePublisher_publishFrame
+ *
+ * \return true when the frame could be encoded, false otherwise (e.g. the data set is too large)
+ */
+LIB61850_API bool
+GoosePublisher_prepareFrameTemplate(GoosePublisher self, LinkedList dataSet);
+
+/**
+ * \brief Write the current values of the bound data set into the pre-encoded frame
+ *
+ * Values are encoded in place when their encoded size did not change. Otherwise, or when elements
+ * were added to or removed from the data set list, the frame is encoded completely with the next
+ * call of \ref GoosePublisher_publishFrame.
+ *
+ * \param self GoosePublisher instance
+ *
+ * \return false when no frame template is prepared
+ */
+LIB61850_API bool
+GoosePublisher_updateFrameValues(GoosePublisher self);
+
+/**
+ * \brief Publish the pre-encoded GOOSE frame
+ *
+ * Only the timestamp, stNum and sqNum fields are written before sending. The frame is encoded again
+ * when it has been invalidated or when the encoded size of stNum or sqNum changed.
+ *
+ * NOTE: This function also increases the sequence number of the GOOSE publisher
+ *
+ * \param self GoosePublisher instance
+ *
+ * \return 0 on success, -1 when no frame template is prepared or the frame cannot be encoded
+ */
+LIB61850_API int
+GoosePublisher_publishFrame(GoosePublisher self);
+
+/**
+ * \brief Release the frame template created by \ref GoosePublisher_prepareFrameTemplate
+ *
+ * \param self GoosePublisher instance
+ */
+LIB61850_API void
+GoosePublisher_releaseFrameTemplate(GoosePublisher self);
+
 /**
  * \brief Sets the GoID used by the GoosePublisher instance
  *
@@ -179,6 +233,33 @@ GoosePublisher_setStNum(GoosePublisher self, uint32_t stNum);
 LIB61850_API void
 GoosePublisher_setTimestamp(GoosePublisher self, uint64_t customTime);
 
+/**
+ * \brief Sets the timestamp used by the GoosePublisher instance with sub-millisecond resolution
+ *
+ * The time is encoded in place as IEC 61850 UtcTime (24 bit fraction of second) together with the
+ * quality byte set by \ref GoosePublisher_setTimeQuality. No memory is allocated, so the function can be
+ * called for every event. A pre-encoded frame (\ref GoosePublisher_publishFrame) only copies the 8 bytes.
+ *
+ * \param self GoosePublisher instance
+ * \param timestampNs the time of the event in nanoseconds since 1970-01-01 UTC (e.g. \ref Hal_getTimeInNs)
+ */
+LIB61850_API void
+GoosePublisher_setTimestampNs(GoosePublisher self, uint64_t timestampNs);
+
+/**
+ * \brief Sets the time quality encoded by \ref GoosePublisher_setTimestampNs
+ *
+ * The default is a synchronized clock with 10 bit sub-second accuracy, as used by \ref GoosePublisher_setTimestamp.
+ *
+ * \param self GoosePublisher instance
+ * \param leapSecondKnown the LeapSecondsKnown flag
+ * \param clockFailure the ClockFailure flag
+ * \param clockNotSynchronized the ClockNotSynchronized flag
+ * \param subsecondPrecision number of significant bits of the fraction of second (0 - 24, 31 = unspecified)
+ */
+LIB61850_API void
+GoosePublisher_setTimeQuality(GoosePublisher self, bool leapSecondKnown, bool clockFailure, bool clockNotSynchronized, int subsecondPrecision);
+
 /**
  * \brief Manually sets the sequence number (sqNum) of the GoosePublisher instance
  *
@@ -211,6 +292,30 @@ GoosePublisher_setNeedsCommission(GoosePublisher self, bool ndsCom);
 LIB61850_API uint64_t
 GoosePublisher_increaseStNum(GoosePublisher self);
 
+/**
+ * \brief Enable kernel (or NIC) timestamps of the sent GOOSE frames
+ *
+ * \param self GoosePublisher instance
+ * \param hardware true to use hardware timestamps when the NIC supports them (see \ref Ethernet_enableTimestamping)
+ *
+ * \return true when timestamps are enabled, false when not supported by the platform
+ */
+LIB61850_API bool
+GoosePublisher_enableTimestamping(GoosePublisher self, bool hardware);
+
+/**
+ * \brief Get the time when the last GOOSE message was sent to the network
+ *
+ * Requires \ref GoosePublisher_enableTimestamping. The timestamp is reported by the kernel shortly
+ * after the frame has been handed to the driver or sent by the NIC.
+ *
+ * \param self GoosePublisher instance
+ *
+ * \return the transmit timestamp in nanoseconds since epoch or 0 when not (yet) available
+ */
+LIB61850_API uint64_t
+GoosePublisher_getTransmitTimestampNs(GoosePublisher self);
+
 /**
  * \brief Reset state and sequence number of the GoosePublisher instance
  *
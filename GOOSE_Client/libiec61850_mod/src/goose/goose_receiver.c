@@ -33,6 +33,7 @@
 #include "mms_value.h"
 #include "mms_value_internal.h"
 #include "linked_list.h"
+#include "rcu_snapshot.h"
 
 #include "goose_receiver.h"
 #include "goose_receiver_internal.h"
@@ -45,16 +46,93 @@
 
 #define ETH_P_GOOSE 0x88b8
 
+#ifndef CONFIG_ETHERNET_RECEIVE_BATCH_SIZE
+#define CONFIG_ETHERNET_RECEIVE_BATCH_SIZE 32
+#endif
+
+#ifndef CONFIG_ETHERNET_USE_PACKET_MMAP
+#define CONFIG_ETHERNET_USE_PACKET_MMAP 0
+#endif
+
+#ifndef CONFIG_ETHERNET_RX_RING_BLOCK_SIZE
+#define CONFIG_ETHERNET_RX_RING_BLOCK_SIZE 65536
+#endif
+
+#ifndef CONFIG_ETHERNET_RX_RING_BLOCK_COUNT
+#define CONFIG_ETHERNET_RX_RING_BLOCK_COUNT 8
+#endif
+
+#ifndef CONFIG_ETHERNET_RX_RING_BLOCK_TIMEOUT
+#define CONFIG_ETHERNET_RX_RING_BLOCK_TIMEOUT 2
+#endif
+
+#ifndef CONFIG_ETHERNET_MAX_RECEIVE_WORKERS
+#define CONFIG_ETHERNET_MAX_RECEIVE_WORKERS 8
+#endif
+
+/* initial number of buckets of the subscriber index - has to be a power of two */
+#define SUBSCRIBER_INDEX_INITIAL_SIZE 16
+
+typedef struct sGooseSubscriberIndexEntry* GooseSubscriberIndexEntry;
+
+struct sGooseSubscriberIndexEntry {
+    uint32_t hash; /* hash of the gocbRef */
+    GooseSubscriber subscriber;
+    GooseSubscriberIndexEntry next;
+};
+
+typedef struct sGooseSubscriberIndex* GooseSubscriberIndex;
+
+/* immutable - followed by the buckets and the entries in the same memory block */
+struct sGooseSubscriberIndex {
+    int size; /* number of buckets - power of two */
+    int subscriberCount;
+    GooseSubscriberIndexEntry* buckets;
+    GooseSubscriber observer; /* receives the messages without a dedicated subscriber */
+};
+
+typedef struct sGooseReceiverWorker* GooseReceiverWorker;
+
+/* socket with its receive thread - worker 0 is also used by the threadless API */
+struct sGooseReceiverWorker
+{
+    GooseReceiver receiver;
+    int id; /* reader index of the subscriber index */
+    EthernetSocket ethSocket;
+    bool rxRing; /* frames are parsed in place in the receive ring of the socket */
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    Thread thread;
+
+    /* frames read by the worker thread with one call of Ethernet_receivePackets */
+    uint8_t* batchBuffer;
+    uint8_t* batchFrames[CONFIG_ETHERNET_RECEIVE_BATCH_SIZE];
+    int batchSizes[CONFIG_ETHERNET_RECEIVE_BATCH_SIZE];
+#endif
+};
+
 struct sGooseReceiver
 {
     bool running;
     bool stop;
     char* interfaceId;
     uint8_t* buffer;
-    EthernetSocket ethSocket;
     LinkedList subscriberList;
+
+    /* GooseSubscriberIndex of the subscriber list - read by the workers without lock */
+    RcuSnapshot subscriberIndex;
+
+    struct sGooseReceiverWorker workers[CONFIG_ETHERNET_MAX_RECEIVE_WORKERS];
+    int workerCount; /* number of workers with open socket */
+
+    bool timestamping;
+    bool hardwareTimestamps;
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
-    Thread thread;
+    Semaphore subscriberListLock; /* serializes changes of the subscriber list and the worker sockets */
+
+    /* parameters of GooseReceiver_setWorkers */
+    int requestedWorkers;
+    EthernetFanoutMode fanoutMode;
+    int workerCpus[CONFIG_ETHERNET_MAX_RECEIVE_WORKERS];
 #endif
 };
 
@@ -68,10 +146,31 @@ GooseReceiver_createEx(uint8_t* buffer)
         self->stop = false;
         self->interfaceId = NULL;
         self->buffer = buffer;
-        self->ethSocket = NULL;
         self->subscriberList = LinkedList_create();
+        self->subscriberIndex = RcuSnapshot_create(CONFIG_ETHERNET_MAX_RECEIVE_WORKERS);
+        self->workerCount = 0;
+        self->timestamping = false;
+        self->hardwareTimestamps = false;
+
+        int i;
+
+        for (i = 0; i < CONFIG_ETHERNET_MAX_RECEIVE_WORKERS; i++) {
+            GooseReceiverWorker worker = &(self->workers[i]);
+
+            worker->receiver = self;
+            worker->id = i;
+            worker->ethSocket = NULL;
+            worker->rxRing = false;
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
-        self->thread = NULL;
+            worker->thread = NULL;
+            worker->batchBuffer = NULL;
+#endif
+        }
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+        self->subscriberListLock = Semaphore_create(1);
+        self->requestedWorkers = 1;
+        self->fanoutMode = ETHERNET_FANOUT_APPID;
 #endif
     }
 
@@ -90,16 +189,208 @@ GooseReceiver_create()
     return self;
 }
 
+static uint32_t
+hashGoCBRef(const uint8_t* goCBRef, int length)
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261u;
+
+    int i;
+
+    for (i = 0; i < length; i++) {
+        hash ^= goCBRef[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static void
+insertIndexEntry(GooseSubscriberIndexEntry* index, int indexSize, GooseSubscriberIndexEntry entry)
+{
+    /* append to keep the order in which the subscribers were added */
+    GooseSubscriberIndexEntry* slot = &(index[entry->hash & (indexSize - 1)]);
+
+    while (*slot)
+        slot = &((*slot)->next);
+
+    entry->next = NULL;
+    *slot = entry;
+}
+
+static void
+setupFrameFilter(GooseReceiver self, EthernetSocket ethSocket);
+
+/* replace the index used by the receiver - call with subscriberListLock */
+static void
+publishSubscriberIndex(GooseReceiver self)
+{
+    int subscriberCount = 0;
+    GooseSubscriber observer = NULL;
+
+    LinkedList element = LinkedList_getNext(self->subscriberList);
+
+    while (element) {
+        GooseSubscriber subscriber = (GooseSubscriber) LinkedList_getData(element);
+
+        if (subscriber->isObserver) {
+            if (observer == NULL)
+                observer = subscriber;
+        }
+        else
+            subscriberCount++;
+
+        element = LinkedList_getNext(element);
+    }
+
+    int size = SUBSCRIBER_INDEX_INITIAL_SIZE;
+
+    while (size < subscriberCount)
+        size = size * 2;
+
+    GooseSubscriberIndex index = (GooseSubscriberIndex) RcuSnapshot_allocate(sizeof(struct sGooseSubscriberIndex) +
+            (size * sizeof(GooseSubscriberIndexEntry)) + (subscriberCount * sizeof(struct sGooseSubscriberIndexEntry)));
+
+    if (index) {
+        index->size = size;
+        index->subscriberCount = subscriberCount;
+        index->buckets = (GooseSubscriberIndexEntry*) (index + 1);
+        index->observer = observer;
+
+        GooseSubscriberIndexEntry entry = (GooseSubscriberIndexEntry) (index->buckets + size);
+
+        element = LinkedList_getNext(self->subscriberList);
+
+        while (element) {
+            GooseSubscriber subscriber = (GooseSubscriber) LinkedList_getData(element);
+
+            if (subscriber->isObserver == false) {
+                entry->hash = hashGoCBRef((uint8_t*) subscriber->goCBRef, subscriber->goCBRefLen);
+                entry->subscriber = subscriber;
+
+                insertIndexEntry(index->buckets, size, entry);
+
+                entry++;
+            }
+
+            element = LinkedList_getNext(element);
+        }
+    }
+    else {
+        /* never keep a removed subscriber in the old index */
+        if (DEBUG_GOOSE_SUBSCRIBER)
+            printf("GOOSE_SUBSCRIBER: no memory for subscriber index - messages are ignored\n");
+    }
+
+    RcuSnapshot_publish(self->subscriberIndex, index);
+}
+
+/* find the subscriber for the gocbRef, APPID and destination MAC address of a received message */
+static GooseSubscriber
+lookupSubscriber(GooseSubscriberIndex index, uint8_t* goCBRef, int goCBRefLen, uint16_t appId, uint8_t* dstMac)
+{
+    if (index->subscriberCount == 0)
+        return NULL;
+
+    uint32_t hash = hashGoCBRef(goCBRef, goCBRefLen);
+
+    GooseSubscriberIndexEntry entry = index->buckets[hash & (index->size - 1)];
+
+    while (entry) {
+        GooseSubscriber subscriber = entry->subscriber;
+
+        if ((entry->hash == hash) && (subscriber->goCBRefLen == goCBRefLen) &&
+                (memcmp(subscriber->goCBRef, goCBRef, goCBRefLen) == 0) &&
+                ((subscriber->appId == -1) || (subscriber->appId == appId)) &&
+                (!subscriber->dstMacSet || (memcmp(subscriber->dstMac, dstMac, 6) == 0)))
+        {
+            return subscriber;
+        }
+
+        entry = entry->next;
+    }
+
+    return NULL;
+}
+
 void
 GooseReceiver_addSubscriber(GooseReceiver self, GooseSubscriber subscriber)
 {
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    Semaphore_wait(self->subscriberListLock);
+#endif
+
     LinkedList_add(self->subscriberList, (void*) subscriber);
+
+    publishSubscriberIndex(self);
+
+    int i;
+
+    for (i = 0; i < self->workerCount; i++) {
+        EthernetSocket ethSocket = self->workers[i].ethSocket;
+
+        setupFrameFilter(self, ethSocket);
+
+        if (subscriber->dstMacSet == false)
+            Ethernet_setMode(ethSocket, ETHERNET_SOCKET_MODE_ALL_MULTICAST);
+        else
+            Ethernet_addMulticastAddress(ethSocket, subscriber->dstMac);
+    }
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    Semaphore_post(self->subscriberListLock);
+#endif
+}
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+/* wait until the worker threads passed a quiescent state - call without subscriberListLock */
+static void
+waitForWorkers(GooseReceiver self, uint32_t epoch)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_ETHERNET_MAX_RECEIVE_WORKERS; i++) {
+        GooseReceiverWorker worker = &(self->workers[i]);
+
+        /* with the threadless API the caller is the reader */
+        while ((worker->thread != NULL) && (RcuSnapshot_hasReaderPassed(self->subscriberIndex, worker->id, epoch) == false))
+            Thread_sleep(1);
+    }
 }
+#endif
 
 void
 GooseReceiver_removeSubscriber(GooseReceiver self, GooseSubscriber subscriber)
 {
-    LinkedList_remove(self->subscriberList, (void*) subscriber);
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    Semaphore_wait(self->subscriberListLock);
+#endif
+
+    bool removed = LinkedList_remove(self->subscriberList, (void*) subscriber);
+
+    if (removed) {
+        publishSubscriberIndex(self);
+
+        int i;
+
+        for (i = 0; i < self->workerCount; i++)
+            setupFrameFilter(self, self->workers[i].ethSocket);
+    }
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    uint32_t epoch = RcuSnapshot_getEpoch(self->subscriberIndex);
+
+    Semaphore_post(self->subscriberListLock);
+
+    /* a worker can still process a message for the subscriber with the old index */
+    if (removed) {
+        waitForWorkers(self, epoch);
+
+        Semaphore_wait(self->subscriberListLock);
+        RcuSnapshot_reclaim(self->subscriberIndex);
+        Semaphore_post(self->subscriberListLock);
+    }
+#endif
 }
 
 void
@@ -645,8 +936,177 @@ exit_with_error:
     return NULL;
 }
 
+static GooseParseError
+compileLayout(GooseSubscriber self, uint8_t* buffer, int bufPos, int maxBufPos, int depth)
+{
+    while (bufPos < maxBufPos) {
+        int headerOffset = bufPos;
+        uint8_t tag = buffer[bufPos++];
+        int elementLength;
+
+        bufPos = BerDecoder_decodeLength(buffer, &elementLength, bufPos, maxBufPos);
+
+        if (bufPos < 0)
+            return GOOSE_PARSE_ERROR_TAGDECODE;
+
+        if (self->layoutSize == CONFIG_GOOSE_MAX_COMPILED_ELEMENTS)
+            return GOOSE_PARSE_ERROR_OVERFLOW;
+
+        GooseElementLayout* element = &(self->layout[self->layoutSize++]);
+
+        element->tag = tag;
+        element->depth = (uint8_t) depth;
+        element->headerOffset = (uint16_t) headerOffset;
+        element->offset = (uint16_t) bufPos;
+        element->length = (uint16_t) elementLength;
+
+        if ((tag == 0xa1) || (tag == 0xa2)) {
+            GooseParseError pe = compileLayout(self, buffer, bufPos, bufPos + elementLength, depth + 1);
+
+            if (pe != GOOSE_PARSE_ERROR_NO_ERROR)
+                return pe;
+        }
+
+        bufPos += elementLength;
+    }
+
+    return GOOSE_PARSE_ERROR_NO_ERROR;
+}
+
+/* true when the new allData has the same structure as the one the layout was compiled for */
+static bool
+layoutMatches(GooseSubscriber self, uint8_t* buffer, int length, uint32_t confRev)
+{
+    if ((self->layoutValid == false) || (self->layoutConfRev != confRev) || (self->allDataLength != length))
+        return false;
+
+    int i;
+
+    for (i = 0; i < self->layoutSize; i++) {
+        GooseElementLayout* element = &(self->layout[i]);
+
+        /* tag and length bytes have to be identical */
+        if (memcmp(buffer + element->headerOffset, self->allData + element->headerOffset,
+                element->offset - element->headerOffset) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+static GooseParseError
+parseAllDataCompiled(GooseSubscriber self, uint8_t* buffer, int allDataLength, uint32_t confRev)
+{
+    if (allDataLength > ETH_BUFFER_LENGTH) {
+        self->layoutValid = false;
+        return GOOSE_PARSE_ERROR_OVERFLOW;
+    }
+
+    bool reuseLayout = layoutMatches(self, buffer, allDataLength, confRev);
+
+    if (allDataLength > 0)
+        memcpy(self->allData, buffer, allDataLength);
+
+    self->allDataLength = allDataLength;
+
+    if (reuseLayout)
+        return GOOSE_PARSE_ERROR_NO_ERROR;
+
+    if (DEBUG_GOOSE_SUBSCRIBER)
+        printf("GOOSE_SUBSCRIBER: compile allData layout (confRev: %u)\n", confRev);
+
+    self->layoutSize = 0;
+
+    GooseParseError pe = compileLayout(self, self->allData, 0, allDataLength, 0);
+
+    self->layoutValid = (pe == GOOSE_PARSE_ERROR_NO_ERROR);
+    self->layoutConfRev = confRev;
+
+    return pe;
+}
+
+/* sequence state machine - O(1) per message, stNum and sqNum compared with serial number arithmetic */
 static int
-parseGoosePayload(GooseReceiver self, uint8_t* buffer, int apduLength)
+classifyMessage(GooseSubscriber self, uint32_t stNum, uint32_t sqNum, uint64_t currentTime)
+{
+    int frameClass;
+
+    if (self->sequenceValid == false) {
+        frameClass = GOOSE_FRAME_NEW_EVENT;
+        self->counters.newEvents++;
+        self->sequenceValid = true;
+        self->sequenceStNum = stNum;
+        self->sequenceSqNum = sqNum;
+
+        return frameClass;
+    }
+
+    int32_t stNumDiff = (int32_t) (stNum - self->sequenceStNum);
+
+    if (stNumDiff > 0) {
+        frameClass = GOOSE_FRAME_NEW_EVENT;
+        self->counters.newEvents++;
+        self->counters.missedEvents += (uint32_t) (stNumDiff - 1);
+        self->sequenceStNum = stNum;
+        self->sequenceSqNum = sqNum;
+    }
+    else if (stNumDiff < 0) {
+        /* follow the publisher - after a restart the following messages are in sequence again */
+        frameClass = GOOSE_FRAME_ST_NUM_ROLLBACK;
+        self->counters.stNumRollbacks++;
+        self->sequenceStNum = stNum;
+        self->sequenceSqNum = sqNum;
+    }
+    else {
+        int32_t sqNumDiff = (int32_t) (sqNum - self->sequenceSqNum);
+
+        if (sqNumDiff > 0) {
+            frameClass = GOOSE_FRAME_RETRANSMISSION;
+            self->counters.retransmissions++;
+            self->counters.missedRetransmissions += (uint32_t) (sqNumDiff - 1);
+            self->sequenceSqNum = sqNum;
+        }
+        else if (sqNumDiff == 0) {
+            frameClass = GOOSE_FRAME_DUPLICATE;
+            self->counters.duplicates++;
+        }
+        else {
+            frameClass = GOOSE_FRAME_OUT_OF_ORDER;
+            self->counters.outOfOrder++;
+        }
+    }
+
+    if (currentTime > self->invalidityTime) {
+        frameClass |= GOOSE_FRAME_TTL_EXPIRED;
+        self->counters.ttlExpiries++;
+    }
+
+    return frameClass;
+}
+
+/* lock a subscriber that can receive messages from more than one worker */
+static bool
+lockSubscriber(GooseReceiver self, GooseSubscriber subscriber)
+{
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    /* only the APPID fanout keeps all messages of a subscriber with APPID at the same worker */
+    if ((self->workerCount > 1) && ((self->fanoutMode != ETHERNET_FANOUT_APPID) ||
+            subscriber->isObserver || (subscriber->appId == -1)))
+    {
+        Semaphore_wait(subscriber->receiveLock);
+        return true;
+    }
+#else
+    (void) self;
+    (void) subscriber;
+#endif
+
+    return false;
+}
+
+static int
+parseGoosePayload(GooseReceiver self, GooseSubscriberIndex index, uint8_t* buffer, int apduLength, uint16_t appId, uint8_t* dstMac,
+        uint8_t* srcMac, bool vlanSet, uint16_t vlanId, uint8_t vlanPrio, uint64_t rxTimestamp)
 {
     int bufPos = 0;
     uint32_t timeAllowedToLive = 0;
@@ -659,6 +1119,8 @@ parseGoosePayload(GooseReceiver self, uint8_t* buffer, int apduLength)
     uint8_t* timestampBufPos = NULL;
     uint8_t* dataSetBufferAddress = NULL;
     int dataSetBufferLength = 0;
+    bool subscriberLocked = false;
+    int result = 0;
 
     uint32_t numberOfDatSetEntries = 0;
 
@@ -681,7 +1143,7 @@ parseGoosePayload(GooseReceiver self, uint8_t* buffer, int apduLength)
             if (bufPos < 0) {
                 if (DEBUG_GOOSE_SUBSCRIBER)
                     printf("GOOSE_SUBSCRIBER: Malformed message: failed to decode BER length tag!\n");
-                return 0;
+                goto exit_parse;
             }
 
             if (bufPos == -1)
@@ -694,39 +1156,48 @@ parseGoosePayload(GooseReceiver self, uint8_t* buffer, int apduLength)
                     printf("GOOSE_SUBSCRIBER:   Found gocbRef\n");
 
                 {
-                    LinkedList element = LinkedList_getNext(self->subscriberList);
-
-                    while (element != NULL) {
-                        GooseSubscriber subscriber = (GooseSubscriber) LinkedList_getData(element);
-
-                        if (subscriber->isObserver)
-                        {
-                            if (elementLength > 129) {
-                                if (DEBUG_GOOSE_SUBSCRIBER)
-                                    printf("GOOSE_SUBSCRIBER:   gocbRef too long!\n");
-                            }
-                            else {
-                                memcpy(subscriber->goCBRef, buffer + bufPos, elementLength);
-                                subscriber->goCBRef[elementLength] = 0;
-                            }
-
-                            matchingSubscriber = subscriber;
-                            break;
-                        }
-                        else if (subscriber->goCBRefLen == elementLength) {
-                            if (memcmp(subscriber->goCBRef, buffer + bufPos, elementLength) == 0) {
-                                if (DEBUG_GOOSE_SUBSCRIBER)
-                                    printf("GOOSE_SUBSCRIBER:   gocbRef is matching!\n");
-                                matchingSubscriber = subscriber;
-                                break;
-                            }
-                        }
+                    if (matchingSubscriber) {
+                        if (DEBUG_GOOSE_SUBSCRIBER)
+                            printf("GOOSE_SUBSCRIBER:   duplicate gocbRef - ignored\n");
+                        break;
+                    }
+
+                    matchingSubscriber = lookupSubscriber(index, buffer + bufPos, elementLength, appId, dstMac);
 
-                        element = LinkedList_getNext(element);
+                    if (matchingSubscriber) {
+                        if (DEBUG_GOOSE_SUBSCRIBER)
+                            printf("GOOSE_SUBSCRIBER:   gocbRef is matching!\n");
+
+                        subscriberLocked = lockSubscriber(self, matchingSubscriber);
                     }
+                    else {
+                        if (index->observer == NULL) {
+                            if (DEBUG_GOOSE_SUBSCRIBER)
+                                printf("GOOSE_SUBSCRIBER: GOOSE message ignored due to unknown gocbRef, DST-MAC or APPID value\n");
+                            return 0;
+                        }
+
+                        /* messages without a dedicated subscriber go to the observer */
+                        matchingSubscriber = index->observer;
+
+                        subscriberLocked = lockSubscriber(self, matchingSubscriber);
+
+                        matchingSubscriber->appId = appId;
+                        memcpy(matchingSubscriber->srcMac, srcMac, 6);
+                        memcpy(matchingSubscriber->dstMac, dstMac, 6);
+                        matchingSubscriber->vlanSet = vlanSet;
+                        matchingSubscriber->vlanId = vlanId;
+                        matchingSubscriber->vlanPrio = vlanPrio;
 
-                    if (matchingSubscriber == NULL)
-                        return 0;
+                        if (elementLength > 129) {
+                            if (DEBUG_GOOSE_SUBSCRIBER)
+                                printf("GOOSE_SUBSCRIBER:   gocbRef too long!\n");
+                        }
+                        else {
+                            memcpy(matchingSubscriber->goCBRef, buffer + bufPos, elementLength);
+                            matchingSubscriber->goCBRef[elementLength] = 0;
+                        }
+                    }
                 }
 
                 break;
@@ -834,6 +1305,24 @@ parseGoosePayload(GooseReceiver self, uint8_t* buffer, int apduLength)
 
         if (matchingSubscriber != NULL) {
 
+            uint64_t currentTime = Hal_getTimeInMs();
+
+            int frameClass = 0;
+
+            /* the observer gets the messages of all publishers - they do not form one sequence */
+            if (matchingSubscriber->isObserver == false)
+                frameClass = classifyMessage(matchingSubscriber, stNum, sqNum, currentTime);
+
+            bool isValid = ((frameClass & (GOOSE_FRAME_DUPLICATE | GOOSE_FRAME_OUT_OF_ORDER)) == 0);
+
+            bool notifyListener = (matchingSubscriber->listener != NULL) && (matchingSubscriber->isObserver ||
+                    ((frameClass & matchingSubscriber->listenerClasses) != 0));
+
+            /* a filtered retransmission or duplicate carries the data of the last state change */
+            bool decodeData = notifyListener || matchingSubscriber->isObserver ||
+                    ((frameClass & (GOOSE_FRAME_RETRANSMISSION | GOOSE_FRAME_DUPLICATE)) == 0) ||
+                    (matchingSubscriber->stateValid == false) || (matchingSubscriber->confRev != confRev);
+
             matchingSubscriber->timeAllowedToLive = timeAllowedToLive;
             matchingSubscriber->ndsCom = ndsCom;
             matchingSubscriber->simulation = simulation;
@@ -862,53 +1351,67 @@ parseGoosePayload(GooseReceiver self, uint8_t* buffer, int apduLength)
                 matchingSubscriber->dataSetValues = NULL;
             }
 
-            bool isValid = true;
+            if (decodeData) {
+                if (matchingSubscriber->compiledDecoding) {
+                    GooseParseError parseError = parseAllDataCompiled(matchingSubscriber, dataSetBufferAddress, dataSetBufferLength, confRev);
 
-            if (matchingSubscriber->dataSetValues == NULL)
-                matchingSubscriber->dataSetValues = parseAllDataUnknownValue(matchingSubscriber, dataSetBufferAddress, dataSetBufferLength, false);
-            else {
-                GooseParseError parseError = parseAllData(dataSetBufferAddress, dataSetBufferLength, matchingSubscriber->dataSetValues);
+                    if (parseError != GOOSE_PARSE_ERROR_NO_ERROR) {
+                        isValid = false;
+                    }
 
-                if (parseError != GOOSE_PARSE_ERROR_NO_ERROR) {
-                    isValid = false;
+                    matchingSubscriber->parseError = parseError;
                 }
+                else if (matchingSubscriber->dataSetValues == NULL)
+                    matchingSubscriber->dataSetValues = parseAllDataUnknownValue(matchingSubscriber, dataSetBufferAddress, dataSetBufferLength, false);
+                else {
+                    GooseParseError parseError = parseAllData(dataSetBufferAddress, dataSetBufferLength, matchingSubscriber->dataSetValues);
 
-                matchingSubscriber->parseError = parseError;
-            }
+                    if (parseError != GOOSE_PARSE_ERROR_NO_ERROR) {
+                        isValid = false;
+                    }
 
-            if (matchingSubscriber->stNum == stNum) {
-                if (matchingSubscriber->sqNum >= sqNum) {
-                    isValid = false;
+                    matchingSubscriber->parseError = parseError;
                 }
             }
 
             matchingSubscriber->stateValid = isValid;
+            matchingSubscriber->frameClass = frameClass;
 
             matchingSubscriber->stNum = stNum;
             matchingSubscriber->sqNum = sqNum;
 
-            matchingSubscriber->invalidityTime = Hal_getTimeInMs() + timeAllowedToLive;
+            matchingSubscriber->invalidityTime = currentTime + timeAllowedToLive;
+            matchingSubscriber->rxTimestamp = rxTimestamp;
 
-            if (matchingSubscriber->listener != NULL)
+            if (notifyListener)
                 matchingSubscriber->listener(matchingSubscriber, matchingSubscriber->listenerParameter);
 
-            return 1;
+            result = 1;
         }
 
-        return 0;
+        goto exit_parse;
     }
 
 exit_with_fault:
     if (DEBUG_GOOSE_SUBSCRIBER)
         printf("GOOSE_SUBSCRIBER: Invalid goose payload\n");
-    return -1;
+    result = -1;
+
+exit_parse:
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    if (subscriberLocked)
+        Semaphore_post(matchingSubscriber->receiveLock);
+#else
+    (void) subscriberLocked;
+#endif
+
+    return result;
 }
 
 static void
-parseGooseMessage(GooseReceiver self, uint8_t* buffer, int numbytes)
+parseGooseMessage(GooseReceiver self, uint8_t* buffer, int numbytes, uint64_t rxTimestamp)
 {
     int bufPos;
-    bool subscriberFound = false;
 
     if (numbytes < 22)
         return;
@@ -971,48 +1474,106 @@ parseGooseMessage(GooseReceiver self, uint8_t* buffer, int numbytes)
         printf("GOOSE_SUBSCRIBER:   APDU length: %i\n", apduLength);
     }
 
-    /* check if there is an interested subscriber */
-    LinkedList element = LinkedList_getNext(self->subscriberList);
-
-    while (element != NULL) {
-        GooseSubscriber subscriber = (GooseSubscriber) LinkedList_getData(element);
-        
-        if (subscriber->isObserver)
-        {
-            subscriber->appId = appId;
-            memcpy(subscriber->srcMac, srcMac,6);
-            memcpy(subscriber->dstMac, dstMac, 6);
-            subscriberFound = true;
-            subscriber->vlanSet = vlanSet;
-            subscriber->vlanId = vlanId;
-            subscriber->vlanPrio = priority;
-            break;
-        }
-
-        if (((subscriber->appId == -1) || (subscriber->appId == appId)) &&
-                (!subscriber->dstMacSet || (memcmp(subscriber->dstMac, dstMac,6) == 0))) {
-            subscriberFound = true;
-            break;
-        }
+    GooseSubscriberIndex index = (GooseSubscriberIndex) RcuSnapshot_get(self->subscriberIndex);
 
-        element = LinkedList_getNext(element);
+    if (index == NULL) {
+        if (DEBUG_GOOSE_SUBSCRIBER)
+            printf("GOOSE_SUBSCRIBER: GOOSE message ignored - no subscriber\n");
+        return;
     }
 
-    if (subscriberFound)
-        parseGoosePayload(self, buffer + bufPos, apduLength);
-    else {
+    if ((index->observer == NULL) && (index->subscriberCount == 0)) {
         if (DEBUG_GOOSE_SUBSCRIBER)
-            printf("GOOSE_SUBSCRIBER: GOOSE message ignored due to unknown DST-MAC or APPID value\n");
+            printf("GOOSE_SUBSCRIBER: GOOSE message ignored - no subscriber\n");
+        return;
+    }
+
+    /* the subscriber is looked up by gocbRef, APPID and DST-MAC when the gocbRef is parsed */
+    parseGoosePayload(self, index, buffer + bufPos, apduLength, appId, dstMac, srcMac, vlanSet, vlanId, priority,
+            rxTimestamp);
+}
+
+static void
+handleFrame(void* parameter, uint8_t* frame, int frameSize)
+{
+    GooseReceiverWorker worker = (GooseReceiverWorker) parameter;
+
+    parseGooseMessage(worker->receiver, frame, frameSize, Ethernet_getReceiveTimestamp(worker->ethSocket, 0));
+}
+
+/* receive a single frame - the receive buffer of the receiver is only used by worker 0 */
+static bool
+receiveFrame(GooseReceiverWorker worker)
+{
+    GooseReceiver self = worker->receiver;
+
+    if (worker->rxRing)
+        return (Ethernet_receiveFrames(worker->ethSocket, handleFrame, worker, 1) > 0);
+
+    int packetSize = Ethernet_receivePacket(worker->ethSocket, self->buffer, ETH_BUFFER_LENGTH);
+
+    if (packetSize > 0) {
+        parseGooseMessage(self, self->buffer, packetSize, Ethernet_getReceiveTimestamp(worker->ethSocket, 0));
+        return true;
     }
+    else
+        return false;
 }
 
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
+static void
+receiveFrameBatch(GooseReceiverWorker worker)
+{
+    GooseReceiver self = worker->receiver;
+
+    int received;
+
+    if (worker->rxRing) {
+        while (Ethernet_receiveFrames(worker->ethSocket, handleFrame, worker, CONFIG_ETHERNET_RECEIVE_BATCH_SIZE)
+                == CONFIG_ETHERNET_RECEIVE_BATCH_SIZE);
+
+        return;
+    }
+
+    /* a full batch means that more frames may be queued */
+    do {
+        received = Ethernet_receivePackets(worker->ethSocket, worker->batchFrames, ETH_BUFFER_LENGTH,
+                worker->batchSizes, CONFIG_ETHERNET_RECEIVE_BATCH_SIZE);
+
+        int i;
+
+        for (i = 0; i < received; i++)
+            parseGooseMessage(self, worker->batchFrames[i], worker->batchSizes[i],
+                    Ethernet_getReceiveTimestamp(worker->ethSocket, i));
+    } while (received == CONFIG_ETHERNET_RECEIVE_BATCH_SIZE);
+}
+
+static bool
+allocateFrameBatch(GooseReceiverWorker worker)
+{
+    if (worker->batchBuffer == NULL) {
+        worker->batchBuffer = (uint8_t*) GLOBAL_MALLOC(CONFIG_ETHERNET_RECEIVE_BATCH_SIZE * ETH_BUFFER_LENGTH);
+
+        if (worker->batchBuffer == NULL)
+            return false;
+
+        int i;
+
+        for (i = 0; i < CONFIG_ETHERNET_RECEIVE_BATCH_SIZE; i++)
+            worker->batchFrames[i] = worker->batchBuffer + (i * ETH_BUFFER_LENGTH);
+    }
+
+    return true;
+}
+
 static void*
 gooseReceiverLoop(void *threadParameter)
 {
-    GooseReceiver self = (GooseReceiver) threadParameter;
+    GooseReceiverWorker worker = (GooseReceiverWorker) threadParameter;
+    GooseReceiver self = worker->receiver;
+
     EthernetHandleSet handleSet = EthernetHandleSet_new();
-    EthernetHandleSet_addSocket(handleSet, self->ethSocket);
+    EthernetHandleSet_addSocket(handleSet, worker->ethSocket);
 
     bool running = true;
 
@@ -1020,6 +1581,8 @@ gooseReceiverLoop(void *threadParameter)
     {
         while (running)
         {
+            RcuSnapshot_quiescent(self->subscriberIndex, worker->id);
+
             switch (EthernetHandleSet_waitReady(handleSet, 100))
             {
             case -1:
@@ -1029,21 +1592,86 @@ gooseReceiverLoop(void *threadParameter)
             case 0:
                 break;
             default:
-                GooseReceiver_tick(self);
+                if (worker->rxRing || worker->batchBuffer)
+                    receiveFrameBatch(worker);
+                else
+                    receiveFrame(worker);
             }
             if (self->stop)
                 break;
 
             running = self->running;
         }
-
-        GooseReceiver_stopThreadless(self);
     }
 
     EthernetHandleSet_destroy(handleSet);
 
     return NULL;
 }
+
+static void
+discardFrame(void* parameter, uint8_t* frame, int frameSize)
+{
+    (void) parameter;
+    (void) frame;
+    (void) frameSize;
+}
+
+static bool
+openWorkerSocket(GooseReceiverWorker worker);
+
+static void
+closeWorkerSocket(GooseReceiverWorker worker);
+
+/* open the sockets of the additional workers - a fanout group distributes the frames */
+static void
+openWorkerSockets(GooseReceiver self)
+{
+    if (self->requestedWorkers < 2)
+        return;
+
+    int groupId = Ethernet_joinFanoutGroup(self->workers[0].ethSocket, -1, self->fanoutMode);
+
+    if (groupId == -1) {
+        if (DEBUG_GOOSE_SUBSCRIBER)
+            printf("GOOSE_SUBSCRIBER: no fanout group - use a single receive thread\n");
+
+        return;
+    }
+
+    int i;
+
+    for (i = 1; i < self->requestedWorkers; i++) {
+        GooseReceiverWorker worker = &(self->workers[i]);
+
+        if (openWorkerSocket(worker) == false)
+            break;
+
+#if (CONFIG_ETHERNET_USE_PACKET_MMAP == 1)
+        worker->rxRing = Ethernet_setupReceiveRing(worker->ethSocket, CONFIG_ETHERNET_RX_RING_BLOCK_SIZE,
+                CONFIG_ETHERNET_RX_RING_BLOCK_COUNT, CONFIG_ETHERNET_RX_RING_BLOCK_TIMEOUT);
+#endif
+
+        /* only worker 0 can fall back to the receive buffer of the receiver */
+        if (((worker->rxRing == false) && (allocateFrameBatch(worker) == false)) ||
+                (Ethernet_joinFanoutGroup(worker->ethSocket, groupId, self->fanoutMode) == -1))
+        {
+            closeWorkerSocket(worker);
+            break;
+        }
+
+        /* frames queued before joining the group are also received by the other workers */
+        if (worker->rxRing)
+            while (Ethernet_receiveFrames(worker->ethSocket, discardFrame, NULL, CONFIG_ETHERNET_RECEIVE_BATCH_SIZE) > 0);
+        else
+            while (Ethernet_receivePacket(worker->ethSocket, worker->batchFrames[0], ETH_BUFFER_LENGTH) > 0);
+
+        RcuSnapshot_setReaderOnline(self->subscriberIndex, worker->id, true);
+    }
+
+    if (DEBUG_GOOSE_SUBSCRIBER)
+        printf("GOOSE_SUBSCRIBER: %i receive threads in fanout group %i\n", self->workerCount, groupId);
+}
 #endif
 
 /* start GOOSE receiver in a separate thread */
@@ -1053,22 +1681,70 @@ GooseReceiver_start(GooseReceiver self)
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
     if (GooseReceiver_startThreadless(self))
     {
-        self->thread = Thread_create((ThreadExecutionFunction) gooseReceiverLoop, (void*) self, false);
+        openWorkerSockets(self);
 
-        if (self->thread != NULL) {
-            if (DEBUG_GOOSE_SUBSCRIBER)
-                printf("GOOSE_SUBSCRIBER: GOOSE receiver started for interface %s\n", self->interfaceId);
+        int i;
 
-            Thread_start(self->thread);
-        }
-        else {
-            if (DEBUG_GOOSE_SUBSCRIBER)
-                printf("GOOSE_SUBSCRIBER: Starting GOOSE receiver failed for interface %s\n", self->interfaceId);
+        for (i = 0; i < self->workerCount; i++) {
+            GooseReceiverWorker worker = &(self->workers[i]);
+
+            if ((worker->rxRing == false) && (allocateFrameBatch(worker) == false)) {
+                if (DEBUG_GOOSE_SUBSCRIBER)
+                    printf("GOOSE_SUBSCRIBER: no memory for receive batch - receive single frames\n");
+            }
+
+            worker->thread = Thread_create((ThreadExecutionFunction) gooseReceiverLoop, (void*) worker, false);
+
+            if (worker->thread != NULL) {
+                if (DEBUG_GOOSE_SUBSCRIBER)
+                    printf("GOOSE_SUBSCRIBER: GOOSE receiver started for interface %s\n", self->interfaceId);
+
+                Thread_start(worker->thread);
+
+                if ((self->workerCpus[i] != -1) && (Thread_setCpuAffinity(worker->thread, self->workerCpus[i]) == false)) {
+                    if (DEBUG_GOOSE_SUBSCRIBER)
+                        printf("GOOSE_SUBSCRIBER: failed to bind receive thread to CPU %i\n", self->workerCpus[i]);
+                }
+            }
+            else {
+                if (DEBUG_GOOSE_SUBSCRIBER)
+                    printf("GOOSE_SUBSCRIBER: Starting GOOSE receiver failed for interface %s\n", self->interfaceId);
+            }
         }
     }
 #endif
 }
 
+void
+GooseReceiver_setWorkers(GooseReceiver self, int count, EthernetFanoutMode mode, const int* cpus)
+{
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    if (count < 1)
+        count = 1;
+    else if (count > CONFIG_ETHERNET_MAX_RECEIVE_WORKERS)
+        count = CONFIG_ETHERNET_MAX_RECEIVE_WORKERS;
+
+    self->requestedWorkers = count;
+    self->fanoutMode = mode;
+
+    int i;
+
+    for (i = 0; i < CONFIG_ETHERNET_MAX_RECEIVE_WORKERS; i++) {
+        if (cpus && (i < count))
+            self->workerCpus[i] = cpus[i];
+        else
+            self->workerCpus[i] = -1;
+    }
+#endif
+}
+
+void
+GooseReceiver_enableTimestamping(GooseReceiver self, bool hardware)
+{
+    self->timestamping = true;
+    self->hardwareTimestamps = hardware;
+}
+
 bool
 GooseReceiver_isRunning(GooseReceiver self)
 {
@@ -1082,8 +1758,18 @@ GooseReceiver_stop(GooseReceiver self)
     self->stop = true;
     self->running = false;
 
-    if (self->thread)
-        Thread_destroy(self->thread);
+    int i;
+
+    for (i = 0; i < self->workerCount; i++) {
+        GooseReceiverWorker worker = &(self->workers[i]);
+
+        if (worker->thread) {
+            Thread_destroy(worker->thread);
+            worker->thread = NULL;
+        }
+    }
+
+    GooseReceiver_stopThreadless(self);
 
     self->stop = false;
 #endif
@@ -1094,67 +1780,224 @@ GooseReceiver_destroy(GooseReceiver self)
 {
     if (self) {
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
-        if ((self->thread != NULL) && (GooseReceiver_isRunning(self)))
+        if ((self->workers[0].thread != NULL) && (GooseReceiver_isRunning(self)))
             GooseReceiver_stop(self);
 #endif
 
         if (self->interfaceId != NULL)
             GLOBAL_FREEMEM(self->interfaceId);
 
+        RcuSnapshot_destroy(self->subscriberIndex);
+
         LinkedList_destroyDeep(self->subscriberList,
                 (LinkedListValueDeleteFunction) GooseSubscriber_destroy);
 
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+        Semaphore_destroy(self->subscriberListLock);
+
+        int i;
+
+        for (i = 0; i < CONFIG_ETHERNET_MAX_RECEIVE_WORKERS; i++) {
+            if (self->workers[i].batchBuffer)
+                GLOBAL_FREEMEM(self->workers[i].batchBuffer);
+        }
+#endif
+
         GLOBAL_FREEMEM(self->buffer);
         GLOBAL_FREEMEM(self);
     }
 }
 
-/***************************************
- * Functions for non-threaded operation
- ***************************************/
-EthernetSocket
-GooseReceiver_startThreadless(GooseReceiver self)
+static bool
+containsAddress(uint8_t* addresses, int count, uint8_t* address)
 {
-    if (self->interfaceId == NULL)
-        self->ethSocket = Ethernet_createSocket(CONFIG_ETHERNET_INTERFACE_ID, NULL);
-    else
-        self->ethSocket = Ethernet_createSocket(self->interfaceId, NULL);
+    int i;
 
-    if (self->ethSocket != NULL) {
-        Ethernet_setProtocolFilter(self->ethSocket, ETH_P_GOOSE);
+    for (i = 0; i < count; i++) {
+        if (memcmp(addresses + (i * 6), address, 6) == 0)
+            return true;
+    }
 
-        /* set multicast addresses for subscribers */
-        Ethernet_setMode(self->ethSocket, ETHERNET_SOCKET_MODE_MULTICAST);
+    return false;
+}
 
-        LinkedList element = LinkedList_getNext(self->subscriberList);
+/* only pass frames with APPID and destination address of a subscriber to user space - call with subscriberListLock */
+static void
+setupFrameFilter(GooseReceiver self, EthernetSocket ethSocket)
+{
+    int subscriberCount = LinkedList_size(self->subscriberList);
 
-        while (element != NULL) {
-            GooseSubscriber subscriber = (GooseSubscriber) LinkedList_getData(element);
+    uint16_t* appIds = (uint16_t*) GLOBAL_MALLOC(sizeof(uint16_t) * (subscriberCount + 1));
+    uint8_t* addresses = (uint8_t*) GLOBAL_MALLOC(6 * (subscriberCount + 1));
 
-            if (subscriber->dstMacSet == false) {
-                /* no destination MAC address defined -> we have to switch to all multicast mode */
-                Ethernet_setMode(self->ethSocket, ETHERNET_SOCKET_MODE_ALL_MULTICAST);
-            }
-            else {
-                Ethernet_addMulticastAddress(self->ethSocket, subscriber->dstMac);
+    int appIdCount = 0;
+    int addressCount = 0;
+
+    bool allAppIds = false;
+    bool allAddresses = false;
+
+    LinkedList element = LinkedList_getNext(self->subscriberList);
+
+    while (element && !(allAppIds && allAddresses)) {
+        GooseSubscriber subscriber = (GooseSubscriber) LinkedList_getData(element);
+
+        /* an observer is interested in all messages */
+        if (subscriber->isObserver) {
+            allAppIds = true;
+            allAddresses = true;
+        }
+        else if (subscriber->appId == -1)
+            allAppIds = true;
+        else if (appIds) {
+            int i;
+
+            for (i = 0; i < appIdCount; i++) {
+                if (appIds[i] == (uint16_t) subscriber->appId)
+                    break;
             }
 
-            element = LinkedList_getNext(element);
+            if (i == appIdCount)
+                appIds[appIdCount++] = (uint16_t) subscriber->appId;
+        }
+
+        if (subscriber->dstMacSet == false)
+            allAddresses = true;
+        else if (addresses && !containsAddress(addresses, addressCount, subscriber->dstMac)) {
+            memcpy(addresses + (addressCount * 6), subscriber->dstMac, 6);
+            addressCount++;
+        }
+
+        element = LinkedList_getNext(element);
+    }
+
+    if ((appIds == NULL) || (appIdCount == 0))
+        allAppIds = true;
+
+    if ((addresses == NULL) || (addressCount == 0))
+        allAddresses = true;
+
+    if (Ethernet_setFrameFilter(ethSocket, ETH_P_GOOSE, allAppIds ? NULL : appIds, appIdCount,
+            allAddresses ? NULL : addresses, addressCount) == false)
+    {
+        if (DEBUG_GOOSE_SUBSCRIBER)
+            printf("GOOSE_SUBSCRIBER: no APPID/DST-MAC filter - only ether type is filtered\n");
+    }
+
+    if (appIds)
+        GLOBAL_FREEMEM(appIds);
+
+    if (addresses)
+        GLOBAL_FREEMEM(addresses);
+}
+
+/* open a socket for the messages of all subscribers */
+static bool
+openWorkerSocket(GooseReceiverWorker worker)
+{
+    GooseReceiver self = worker->receiver;
+
+    EthernetSocket ethSocket = Ethernet_createSocket(GooseReceiver_getInterfaceId(self), NULL);
+
+    if (ethSocket == NULL)
+        return false;
+
+    if (self->timestamping && (Ethernet_enableTimestamping(ethSocket, self->hardwareTimestamps) == false)) {
+        if (DEBUG_GOOSE_SUBSCRIBER)
+            printf("GOOSE_SUBSCRIBER: no receive timestamps\n");
+    }
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    Semaphore_wait(self->subscriberListLock);
+#endif
+
+    setupFrameFilter(self, ethSocket);
+
+    /* set multicast addresses for subscribers */
+    Ethernet_setMode(ethSocket, ETHERNET_SOCKET_MODE_MULTICAST);
+
+    LinkedList element = LinkedList_getNext(self->subscriberList);
+
+    while (element != NULL) {
+        GooseSubscriber subscriber = (GooseSubscriber) LinkedList_getData(element);
+
+        if (subscriber->dstMacSet == false) {
+            /* no destination MAC address defined -> we have to switch to all multicast mode */
+            Ethernet_setMode(ethSocket, ETHERNET_SOCKET_MODE_ALL_MULTICAST);
+        }
+        else {
+            Ethernet_addMulticastAddress(ethSocket, subscriber->dstMac);
         }
 
+        element = LinkedList_getNext(element);
+    }
+
+    /* from now on the socket is updated by GooseReceiver_addSubscriber/removeSubscriber */
+    worker->ethSocket = ethSocket;
+    worker->rxRing = false;
+    self->workerCount = worker->id + 1;
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    Semaphore_post(self->subscriberListLock);
+#endif
+
+    return true;
+}
+
+static void
+closeWorkerSocket(GooseReceiverWorker worker)
+{
+    GooseReceiver self = worker->receiver;
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    Semaphore_wait(self->subscriberListLock);
+#endif
+
+    self->workerCount = worker->id;
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    Semaphore_post(self->subscriberListLock);
+#endif
+
+    Ethernet_destroySocket(worker->ethSocket);
+
+    worker->ethSocket = NULL;
+    worker->rxRing = false;
+
+    RcuSnapshot_setReaderOnline(self->subscriberIndex, worker->id, false);
+}
+
+/***************************************
+ * Functions for non-threaded operation
+ ***************************************/
+EthernetSocket
+GooseReceiver_startThreadless(GooseReceiver self)
+{
+    GooseReceiverWorker worker = &(self->workers[0]);
+
+    if (openWorkerSocket(worker)) {
+#if (CONFIG_ETHERNET_USE_PACKET_MMAP == 1)
+        worker->rxRing = Ethernet_setupReceiveRing(worker->ethSocket, CONFIG_ETHERNET_RX_RING_BLOCK_SIZE,
+                CONFIG_ETHERNET_RX_RING_BLOCK_COUNT, CONFIG_ETHERNET_RX_RING_BLOCK_TIMEOUT);
+
+        if ((worker->rxRing == false) && DEBUG_GOOSE_SUBSCRIBER)
+            printf("GOOSE_SUBSCRIBER: no receive ring - use socket receive\n");
+#endif
+
+        RcuSnapshot_setReaderOnline(self->subscriberIndex, worker->id, true);
+
         self->running = true;
     }
     else
         self->running = false;
 
-    return self->ethSocket;
+    return worker->ethSocket;
 }
 
 void
 GooseReceiver_stopThreadless(GooseReceiver self)
 {
-    if (self->ethSocket)
-        Ethernet_destroySocket(self->ethSocket);
+    while (self->workerCount > 0)
+        closeWorkerSocket(&(self->workers[self->workerCount - 1]));
 
     self->running = false;
 }
@@ -1163,18 +2006,15 @@ GooseReceiver_stopThreadless(GooseReceiver self)
 bool
 GooseReceiver_tick(GooseReceiver self)
 {
-    int packetSize = Ethernet_receivePacket(self->ethSocket, self->buffer, ETH_BUFFER_LENGTH);
+    RcuSnapshot_quiescent(self->subscriberIndex, 0);
 
-    if (packetSize > 0) {
-        parseGooseMessage(self, self->buffer, packetSize);
-        return true;
-    }
-    else
-        return false;
+    return receiveFrame(&(self->workers[0]));
 }
 
 void
 GooseReceiver_handleMessage(GooseReceiver self, uint8_t* buffer, int size)
 {
-    parseGooseMessage(self, buffer, size);
+    RcuSnapshot_quiescent(self->subscriberIndex, 0);
+
+    parseGooseMessage(self, buffer, size, 0);
 }
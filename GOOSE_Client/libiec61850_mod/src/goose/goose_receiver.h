@@ -86,8 +86,12 @@ GooseReceiver_getInterfaceId(GooseReceiver self);
 /**
  * \brief Add a subscriber to this receiver instance
  *
- * NOTE: Do not call this function while the receiver is running (after GooseReceiver_start
- * has been called)!
+ * Received messages are dispatched to the first added subscriber with matching gocbRef, APPID
+ * and destination MAC address. Messages without matching subscriber are passed to the observer
+ * (if any). The observer flag has to be set before the subscriber is added.
+ *
+ * The function can be called while the receiver is running. The receiver continues with the
+ * old subscriber set until the message it is handling has been processed.
  *
  * \param self the GooseReceiver instance
  * \param subscriber the GooseSubscriber instance to add
@@ -98,8 +102,10 @@ GooseReceiver_addSubscriber(GooseReceiver self, GooseSubscriber subscriber);
 /**
  * \brief Remove a subscriber from this receiver instance
  *
- * NOTE: Do not call this function while the receiver is running (after GooseReceiver_start
- * has been called)!
+ * The function can be called while the receiver is running. It waits until the receive threads
+ * finished the messages they are processing, so the subscriber can be destroyed when the function
+ * returns. It must not be called from a listener. With the threadless API it has to be called by
+ * the thread that receives the messages.
  *
  * \param self the GooseReceiver instance
  * \param subscriber the GooseSubscriber instance to remove
@@ -115,6 +121,40 @@ GooseReceiver_removeSubscriber(GooseReceiver self, GooseSubscriber subscriber);
 LIB61850_API void
 GooseReceiver_start(GooseReceiver self);
 
+/**
+ * \brief Use multiple receive threads (workers), each with its own socket
+ *
+ * The frames are distributed over the sockets by the kernel (Linux PACKET_FANOUT). With
+ * \ref ETHERNET_FANOUT_APPID all messages with the same APPID are handled by the same worker,
+ * so the messages of a GoCB are reported in order. Listeners of different subscribers can be
+ * called concurrently. With \ref ETHERNET_FANOUT_HASH and \ref ETHERNET_FANOUT_CPU the messages of
+ * a GoCB can arrive at different workers. The workers then process the messages of a subscriber
+ * one at a time, but not necessarily in the order of reception. The same applies to the observer
+ * and to subscribers without APPID in all modes.
+ *
+ * When the platform does not support fanout groups a single worker is used. Has to be called
+ * before the receiver is started.
+ *
+ * \param self the GooseReceiver instance
+ * \param count number of workers (1 to CONFIG_ETHERNET_MAX_RECEIVE_WORKERS)
+ * \param mode how the frames are distributed over the workers
+ * \param cpus CPU for each worker thread or NULL (the value -1 means no CPU affinity)
+ */
+LIB61850_API void
+GooseReceiver_setWorkers(GooseReceiver self, int count, EthernetFanoutMode mode, const int* cpus);
+
+/**
+ * \brief Take kernel (or NIC) timestamps of the received GOOSE frames
+ *
+ * The timestamps are provided by \ref GooseSubscriber_getReceiveTimestampNs. Has to be called
+ * before the receiver is started.
+ *
+ * \param self the GooseReceiver instance
+ * \param hardware true to use hardware timestamps when the NIC supports them (see \ref Ethernet_enableTimestamping)
+ */
+LIB61850_API void
+GooseReceiver_enableTimestamping(GooseReceiver self, bool hardware);
+
 /**
  * \brief stop the GOOSE receiver running in a separate thread
  *
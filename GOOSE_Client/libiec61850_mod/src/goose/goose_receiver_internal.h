@@ -33,6 +33,18 @@
 #define DEBUG_GOOSE_SUBSCRIBER 0
 #endif
 
+#ifndef CONFIG_GOOSE_MAX_COMPILED_ELEMENTS
+#define CONFIG_GOOSE_MAX_COMPILED_ELEMENTS 128
+#endif
+
+/* position of one allData element in the copy of the last received allData */
+typedef struct {
+    uint8_t tag;
+    uint8_t depth; /* nesting level in structures/arrays */
+    uint16_t headerOffset; /* position of the tag */
+    uint16_t offset; /* position of the value */
+    uint16_t length;
+} GooseElementLayout;
 
 struct sGooseSubscriber {
     char goCBRef[130];
@@ -48,6 +60,16 @@ struct sGooseSubscriber {
     bool ndsCom;
 
     uint64_t invalidityTime;
+
+    /* sequence state machine - highest stNum/sqNum seen so far */
+    bool sequenceValid;
+    uint32_t sequenceStNum;
+    uint32_t sequenceSqNum;
+    int frameClass;
+    int listenerClasses; /* GooseFrameClass values that invoke the listener */
+    GooseSubscriberCounters counters;
+
+    uint64_t rxTimestamp; /* kernel/NIC receive timestamp of the last message in ns (0 if not available) */
     bool stateValid;
     GooseParseError parseError;
 
@@ -57,6 +79,15 @@ struct sGooseSubscriber {
 
     MmsValue* dataSetValues;
     bool dataSetValuesSelfAllocated;
+
+    /* compiled decoding - allData is copied and accessed through the layout table */
+    bool compiledDecoding;
+    GooseElementLayout* layout;
+    int layoutSize;
+    bool layoutValid;
+    uint32_t layoutConfRev;
+    uint8_t* allData;
+    int allDataLength;
     bool dstMacSet;
     bool isObserver;
     bool vlanSet;
@@ -65,6 +96,10 @@ struct sGooseSubscriber {
 
     GooseListener listener;
     void* listenerParameter;
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    Semaphore receiveLock; /* serializes receive workers that get messages for this subscriber */
+#endif
 };
 
 
@@ -0,0 +1,523 @@
+/*
+ *  goose_retransmission_scheduler.c
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include "libiec61850_platform_includes.h"
+#include "stack_config.h"
+#include "goose_retransmission_scheduler.h"
+#include "hal_thread.h"
+#include "hal_time.h"
+#include "linked_list.h"
+
+#ifndef DEBUG_GOOSE_PUBLISHER
+#define DEBUG_GOOSE_PUBLISHER 0
+#endif
+
+/* number of slots of the timer wheel - has to be a power of two */
+#ifndef CONFIG_GOOSE_RETRANSMISSION_WHEEL_SIZE
+#define CONFIG_GOOSE_RETRANSMISSION_WHEEL_SIZE 256
+#endif
+
+#define WHEEL_MASK (CONFIG_GOOSE_RETRANSMISSION_WHEEL_SIZE - 1)
+
+typedef struct sGooseRetransmission* GooseRetransmission;
+
+struct sGooseRetransmission {
+    GoosePublisher publisher;
+
+    uint32_t minTime;
+    uint32_t maxTime;
+    uint32_t interval; /* gap to the next retransmission in ms */
+
+    uint64_t dueTick;
+    bool scheduled;
+
+    /* list of the wheel slot the entry is in */
+    GooseRetransmission prev;
+    GooseRetransmission next;
+};
+
+struct sGooseRetransmissionScheduler {
+    int tickInterval;
+    uint64_t tickLength; /* tickInterval in ns */
+    uint64_t startTime; /* monotonic time in ns - a step of the system time does not disturb the wheel */
+    uint64_t currentTick; /* last processed tick */
+
+    GooseRetransmission wheel[CONFIG_GOOSE_RETRANSMISSION_WHEEL_SIZE];
+    LinkedList entries;
+
+    uint64_t sentFrames;
+
+    GooseRetransmissionDeadlineStats deadlineStats;
+
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+    Semaphore lock;
+    Semaphore startSignal; /* holds the thread back until its scheduling parameters are set */
+    Thread thread;
+    bool running;
+#endif
+};
+
+static void
+lockScheduler(GooseRetransmissionScheduler self)
+{
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+    Semaphore_wait(self->lock);
+#endif
+}
+
+static void
+unlockScheduler(GooseRetransmissionScheduler self)
+{
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+    Semaphore_post(self->lock);
+#endif
+}
+
+static uint64_t
+getNowTick(GooseRetransmissionScheduler self)
+{
+    return (Hal_getMonotonicTimeInNs() - self->startTime) / self->tickLength;
+}
+
+static uint64_t
+ticksFor(GooseRetransmissionScheduler self, uint32_t timeInMs)
+{
+    uint64_t ticks = (timeInMs + self->tickInterval - 1) / self->tickInterval;
+
+    if (ticks == 0)
+        ticks = 1;
+
+    return ticks;
+}
+
+static void
+unscheduleEntry(GooseRetransmissionScheduler self, GooseRetransmission entry)
+{
+    if (entry->scheduled == false)
+        return;
+
+    if (entry->prev)
+        entry->prev->next = entry->next;
+    else
+        self->wheel[entry->dueTick & WHEEL_MASK] = entry->next;
+
+    if (entry->next)
+        entry->next->prev = entry->prev;
+
+    entry->prev = NULL;
+    entry->next = NULL;
+    entry->scheduled = false;
+}
+
+static void
+scheduleEntry(GooseRetransmissionScheduler self, GooseRetransmission entry, uint64_t dueTick)
+{
+    int slot = (int) (dueTick & WHEEL_MASK);
+
+    entry->dueTick = dueTick;
+    entry->prev = NULL;
+    entry->next = self->wheel[slot];
+
+    if (entry->next)
+        entry->next->prev = entry;
+
+    self->wheel[slot] = entry;
+    entry->scheduled = true;
+}
+
+static GooseRetransmission
+findEntry(GooseRetransmissionScheduler self, GoosePublisher publisher)
+{
+    LinkedList element = LinkedList_getNext(self->entries);
+
+    while (element) {
+        GooseRetransmission entry = (GooseRetransmission) LinkedList_getData(element);
+
+        if (entry->publisher == publisher)
+            return entry;
+
+        element = LinkedList_getNext(element);
+    }
+
+    return NULL;
+}
+
+static bool
+sendFrame(GooseRetransmissionScheduler self, GooseRetransmission entry)
+{
+    if (GoosePublisher_publishFrame(entry->publisher) == -1) {
+        if (DEBUG_GOOSE_PUBLISHER)
+            printf("GOOSE_PUBLISHER: retransmission failed (no frame template?)\n");
+
+        return false;
+    }
+
+    self->sentFrames++;
+
+    return true;
+}
+
+GooseRetransmissionScheduler
+GooseRetransmissionScheduler_create(int tickInterval)
+{
+    GooseRetransmissionScheduler self = (GooseRetransmissionScheduler) GLOBAL_CALLOC(1, sizeof(struct sGooseRetransmissionScheduler));
+
+    if (self) {
+        self->tickInterval = (tickInterval > 0) ? tickInterval : 1;
+        self->tickLength = (uint64_t) self->tickInterval * 1000000ULL;
+        self->startTime = Hal_getMonotonicTimeInNs();
+        self->entries = LinkedList_create();
+
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+        self->lock = Semaphore_create(1);
+        self->startSignal = Semaphore_create(0);
+#endif
+    }
+
+    return self;
+}
+
+bool
+GooseRetransmissionScheduler_addPublisher(GooseRetransmissionScheduler self, GoosePublisher publisher,
+        uint32_t minTime, uint32_t maxTime)
+{
+    if ((publisher == NULL) || (minTime == 0) || (minTime > maxTime))
+        return false;
+
+    bool added = false;
+
+    lockScheduler(self);
+
+    if (findEntry(self, publisher) == NULL) {
+        GooseRetransmission entry = (GooseRetransmission) GLOBAL_CALLOC(1, sizeof(struct sGooseRetransmission));
+
+        if (entry) {
+            entry->publisher = publisher;
+            entry->minTime = minTime;
+            entry->maxTime = maxTime;
+            entry->interval = maxTime;
+
+            LinkedList_add(self->entries, entry);
+
+            added = true;
+        }
+    }
+
+    unlockScheduler(self);
+
+    return added;
+}
+
+void
+GooseRetransmissionScheduler_removePublisher(GooseRetransmissionScheduler self, GoosePublisher publisher)
+{
+    lockScheduler(self);
+
+    GooseRetransmission entry = findEntry(self, publisher);
+
+    if (entry) {
+        unscheduleEntry(self, entry);
+        LinkedList_remove(self->entries, entry);
+        GLOBAL_FREEMEM(entry);
+    }
+
+    unlockScheduler(self);
+}
+
+void
+GooseRetransmissionScheduler_lock(GooseRetransmissionScheduler self)
+{
+    lockScheduler(self);
+}
+
+void
+GooseRetransmissionScheduler_unlock(GooseRetransmissionScheduler self)
+{
+    unlockScheduler(self);
+}
+
+bool
+GooseRetransmissionScheduler_triggerEvent(GooseRetransmissionScheduler self, GoosePublisher publisher)
+{
+    return GooseRetransmissionScheduler_triggerEventEx(self, publisher, NULL);
+}
+
+bool
+GooseRetransmissionScheduler_triggerEventEx(GooseRetransmissionScheduler self, GoosePublisher publisher,
+        uint64_t* txTimestamp)
+{
+    bool sent = false;
+
+    if (txTimestamp)
+        *txTimestamp = 0;
+
+    lockScheduler(self);
+
+    GooseRetransmission entry = findEntry(self, publisher);
+
+    if (entry) {
+        unscheduleEntry(self, entry);
+
+        sent = sendFrame(self, entry);
+
+        /* the next frame sent by the scheduler thread resets the timestamp of the socket */
+        if (sent && txTimestamp)
+            *txTimestamp = GoosePublisher_getTransmitTimestampNs(publisher);
+
+        uint64_t nowTick = getNowTick(self);
+
+        if (nowTick < self->currentTick)
+            nowTick = self->currentTick;
+
+        entry->interval = entry->minTime;
+
+        scheduleEntry(self, entry, nowTick + ticksFor(self, entry->interval));
+    }
+
+    unlockScheduler(self);
+
+    return sent;
+}
+
+/* called with the scheduler locked */
+static int
+processTicks(GooseRetransmissionScheduler self)
+{
+    int sentFrames = 0;
+
+    uint64_t nowTick = getNowTick(self);
+
+    while (self->currentTick < nowTick) {
+        self->currentTick++;
+
+        GooseRetransmission entry = self->wheel[self->currentTick & WHEEL_MASK];
+
+        while (entry) {
+            GooseRetransmission next = entry->next;
+
+            /* entries further ahead stay in the slot for the next turn of the wheel */
+            if (entry->dueTick <= self->currentTick) {
+                unscheduleEntry(self, entry);
+
+                if (sendFrame(self, entry))
+                    sentFrames++;
+
+                /* doubling the gap until maxTime gives the standard retransmission curve */
+                if (entry->interval < entry->maxTime) {
+                    entry->interval = entry->interval * 2;
+
+                    if (entry->interval > entry->maxTime)
+                        entry->interval = entry->maxTime;
+                }
+
+                scheduleEntry(self, entry, self->currentTick + ticksFor(self, entry->interval));
+            }
+
+            entry = next;
+        }
+    }
+
+    return sentFrames;
+}
+
+int
+GooseRetransmissionScheduler_tick(GooseRetransmissionScheduler self)
+{
+    lockScheduler(self);
+
+    int sentFrames = processTicks(self);
+
+    unlockScheduler(self);
+
+    return sentFrames;
+}
+
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+static void*
+schedulerLoop(void* threadParameter)
+{
+    GooseRetransmissionScheduler self = (GooseRetransmissionScheduler) threadParameter;
+
+    /* no tick is processed before the priority and CPU affinity are applied */
+    Semaphore_wait(self->startSignal);
+
+    /* wake up at the tick boundaries - absolute deadlines do not accumulate the wakeup delays */
+    uint64_t deadline = self->startTime + (getNowTick(self) + 1) * self->tickLength;
+
+    while (self->running) {
+        Thread_sleepUntil(deadline);
+
+        uint64_t lateness = Hal_getMonotonicTimeInNs() - deadline;
+
+        /* clock_nanosleep never returns early, the other platforms may */
+        if ((int64_t) lateness < 0)
+            lateness = 0;
+
+        /* deadlines that passed completely while the thread was waiting for the CPU */
+        uint64_t missed = lateness / self->tickLength;
+
+        lockScheduler(self);
+
+        GooseRetransmissionDeadlineStats* stats = &(self->deadlineStats);
+
+        stats->cycles++;
+        stats->missedDeadlines += missed;
+        stats->totalLateness += lateness;
+
+        if (lateness > stats->maxLateness)
+            stats->maxLateness = lateness;
+
+        processTicks(self);
+
+        unlockScheduler(self);
+
+        deadline += (missed + 1) * self->tickLength;
+    }
+
+    return NULL;
+}
+
+static bool
+startThread(GooseRetransmissionScheduler self)
+{
+    if (self->thread)
+        return false;
+
+    self->running = true;
+
+    self->thread = Thread_create((ThreadExecutionFunction) schedulerLoop, (void*) self, false);
+
+    if (self->thread == NULL) {
+        self->running = false;
+        return false;
+    }
+
+    Thread_start(self->thread);
+
+    return true;
+}
+#endif
+
+void
+GooseRetransmissionScheduler_start(GooseRetransmissionScheduler self)
+{
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+    if (startThread(self))
+        Semaphore_post(self->startSignal);
+#endif
+}
+
+bool
+GooseRetransmissionScheduler_startRealtime(GooseRetransmissionScheduler self, int priority, int cpu, bool lockMemory)
+{
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+    bool success = true;
+
+    /* before the thread starts, so its stack is locked as well */
+    if (lockMemory) {
+        if (Thread_lockMemory() == false) {
+            if (DEBUG_GOOSE_PUBLISHER)
+                printf("GOOSE_PUBLISHER: failed to lock memory\n");
+
+            success = false;
+        }
+    }
+
+    if (startThread(self) == false)
+        return false;
+
+    if (cpu >= 0) {
+        if (Thread_setCpuAffinity(self->thread, cpu) == false) {
+            if (DEBUG_GOOSE_PUBLISHER)
+                printf("GOOSE_PUBLISHER: failed to bind scheduler to CPU %i\n", cpu);
+
+            success = false;
+        }
+    }
+
+    if (priority > 0) {
+        if (Thread_setRealtimePriority(self->thread, priority) == false) {
+            if (DEBUG_GOOSE_PUBLISHER)
+                printf("GOOSE_PUBLISHER: failed to set real-time priority %i\n", priority);
+
+            success = false;
+        }
+    }
+
+    /* release the thread - it starts with the first tick boundary */
+    Semaphore_post(self->startSignal);
+
+    return success;
+#else
+    return false;
+#endif
+}
+
+void
+GooseRetransmissionScheduler_getDeadlineStats(GooseRetransmissionScheduler self, GooseRetransmissionDeadlineStats* stats)
+{
+    lockScheduler(self);
+    *stats = self->deadlineStats;
+    unlockScheduler(self);
+}
+
+void
+GooseRetransmissionScheduler_stop(GooseRetransmissionScheduler self)
+{
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+    if (self->thread) {
+        self->running = false;
+
+        Thread_destroy(self->thread);
+
+        self->thread = NULL;
+    }
+#endif
+}
+
+uint64_t
+GooseRetransmissionScheduler_getSentFrames(GooseRetransmissionScheduler self)
+{
+    uint64_t sentFrames;
+
+    lockScheduler(self);
+    sentFrames = self->sentFrames;
+    unlockScheduler(self);
+
+    return sentFrames;
+}
+
+void
+GooseRetransmissionScheduler_destroy(GooseRetransmissionScheduler self)
+{
+    if (self) {
+        GooseRetransmissionScheduler_stop(self);
+
+        LinkedList_destroy(self->entries);
+
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+        Semaphore_destroy(self->lock);
+        Semaphore_destroy(self->startSignal);
+#endif
+
+        GLOBAL_FREEMEM(self);
+    }
+}
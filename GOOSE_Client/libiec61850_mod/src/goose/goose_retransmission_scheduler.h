@@ -0,0 +1,228 @@
+/*
+ *  goose_retransmission_scheduler.h
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef GOOSE_RETRANSMISSION_SCHEDULER_H_
+#define GOOSE_RETRANSMISSION_SCHEDULER_H_
+
+#include "goose_publisher.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup goosepub_api_group
+ */
+/**@{*/
+
+/**
+ * \brief Retransmission scheduler for standalone GOOSE publishers
+ *
+ * Implements the retransmission curve of IEC 61850-8-1: after an event the frame is sent
+ * immediately, repeated after minTime and then with a doubled interval until the interval
+ * reaches maxTime. In the stable state the frame is repeated every maxTime.
+ *
+ * All publishers of a scheduler are served by a single timer wheel. The publishers have to
+ * have a frame template (see \ref GoosePublisher_prepareFrameTemplate).
+ */
+typedef struct sGooseRetransmissionScheduler* GooseRetransmissionScheduler;
+
+/**
+ * \brief Timing statistics of the scheduler thread
+ *
+ * The thread wakes up at the tick boundaries of the scheduler. A deadline is missed when the
+ * thread wakes up a full tick interval or more after it.
+ */
+typedef struct {
+    uint64_t cycles; /**< number of wakeups of the scheduler thread */
+    uint64_t missedDeadlines; /**< number of tick boundaries that passed without a wakeup */
+    uint64_t maxLateness; /**< largest delay between a deadline and the wakeup in ns */
+    uint64_t totalLateness; /**< sum of all wakeup delays in ns (divide by cycles for the mean) */
+} GooseRetransmissionDeadlineStats;
+
+/**
+ * \brief Create a new scheduler instance
+ *
+ * \param tickInterval resolution of the timer wheel in ms (0 = use 1 ms)
+ *
+ * \return the new scheduler instance
+ */
+LIB61850_API GooseRetransmissionScheduler
+GooseRetransmissionScheduler_create(int tickInterval);
+
+/**
+ * \brief Add a publisher to the scheduler
+ *
+ * No frames are sent for the publisher before the first call of \ref GooseRetransmissionScheduler_triggerEvent
+ * so that the application can set up the initial state first.
+ *
+ * NOTE: The time allowed to live of the publisher is not changed. It should be larger than maxTime.
+ *
+ * \param self the scheduler instance
+ * \param publisher the publisher (with a prepared frame template)
+ * \param minTime retransmission interval directly after an event in ms
+ * \param maxTime retransmission interval in the stable state in ms
+ *
+ * \return true on success, false when the publisher is already added or the parameters are invalid
+ */
+LIB61850_API bool
+GooseRetransmissionScheduler_addPublisher(GooseRetransmissionScheduler self, GoosePublisher publisher,
+        uint32_t minTime, uint32_t maxTime);
+
+/**
+ * \brief Remove a publisher from the scheduler
+ *
+ * \param self the scheduler instance
+ * \param publisher the publisher to remove
+ */
+LIB61850_API void
+GooseRetransmissionScheduler_removePublisher(GooseRetransmissionScheduler self, GoosePublisher publisher);
+
+/**
+ * \brief Lock the scheduler to change the state of the scheduled publishers
+ *
+ * No frames are sent while the scheduler is locked. Update the data set values, stNum and
+ * timestamp of a publisher only while holding this lock.
+ *
+ * \param self the scheduler instance
+ */
+LIB61850_API void
+GooseRetransmissionScheduler_lock(GooseRetransmissionScheduler self);
+
+/**
+ * \brief Release the lock acquired with \ref GooseRetransmissionScheduler_lock
+ *
+ * \param self the scheduler instance
+ */
+LIB61850_API void
+GooseRetransmissionScheduler_unlock(GooseRetransmissionScheduler self);
+
+/**
+ * \brief Send the current frame of the publisher immediately and restart the retransmission curve
+ *
+ * Has to be called after the state of the publisher was changed (e.g. new stNum).
+ * The scheduler must not be locked by the caller.
+ *
+ * \param self the scheduler instance
+ * \param publisher the publisher that has a new state
+ *
+ * \return true when the frame was sent, false otherwise
+ */
+LIB61850_API bool
+GooseRetransmissionScheduler_triggerEvent(GooseRetransmissionScheduler self, GoosePublisher publisher);
+
+/**
+ * \brief Like \ref GooseRetransmissionScheduler_triggerEvent, but also return the transmit timestamp of the event frame
+ *
+ * The timestamp is read while the scheduler is locked, so it cannot be replaced by the timestamp of a
+ * retransmission. Requires \ref GoosePublisher_enableTimestamping.
+ *
+ * \param self the scheduler instance
+ * \param publisher the publisher that has a new state
+ * \param txTimestamp the transmit timestamp in nanoseconds since epoch is stored here (0 when not available)
+ *
+ * \return true when the frame was sent, false otherwise
+ */
+LIB61850_API bool
+GooseRetransmissionScheduler_triggerEventEx(GooseRetransmissionScheduler self, GoosePublisher publisher,
+        uint64_t* txTimestamp);
+
+/**
+ * \brief Start a background thread that drives the scheduler
+ *
+ * \param self the scheduler instance
+ */
+LIB61850_API void
+GooseRetransmissionScheduler_start(GooseRetransmissionScheduler self);
+
+/**
+ * \brief Start the background thread in real-time mode
+ *
+ * The thread wakes up at absolute deadlines (tick boundaries), like with \ref GooseRetransmissionScheduler_start.
+ * In addition it runs with a fixed real-time priority (SCHED_FIFO), optionally bound to a single CPU, and
+ * the memory of the process can be locked to avoid page faults. This keeps the send time jitter bounded when
+ * other threads of the application are busy. Setting the priority and locking the memory usually requires
+ * elevated privileges (e.g. CAP_SYS_NICE and CAP_IPC_LOCK on Linux). The settings are applied before the
+ * thread processes its first tick.
+ *
+ * \param self the scheduler instance
+ * \param priority real-time priority of the thread (1 - 99 on Linux, 0 = keep the normal scheduling policy)
+ * \param cpu the CPU the thread is bound to (-1 = no affinity)
+ * \param lockMemory true to lock all current and future memory of the process (mlockall)
+ *
+ * \return true when the thread runs with all requested settings, false when a setting could not be applied.
+ *         The thread is running in this case too unless it was already started or could not be created.
+ */
+LIB61850_API bool
+GooseRetransmissionScheduler_startRealtime(GooseRetransmissionScheduler self, int priority, int cpu, bool lockMemory);
+
+/**
+ * \brief Get the timing statistics of the background thread
+ *
+ * \param self the scheduler instance
+ * \param stats the statistics are copied here
+ */
+LIB61850_API void
+GooseRetransmissionScheduler_getDeadlineStats(GooseRetransmissionScheduler self, GooseRetransmissionDeadlineStats* stats);
+
+/**
+ * \brief Stop the background thread of the scheduler
+ *
+ * \param self the scheduler instance
+ */
+LIB61850_API void
+GooseRetransmissionScheduler_stop(GooseRetransmissionScheduler self);
+
+/**
+ * \brief Send all frames that are due (for use without background thread)
+ *
+ * \param self the scheduler instance
+ *
+ * \return the number of frames sent
+ */
+LIB61850_API int
+GooseRetransmissionScheduler_tick(GooseRetransmissionScheduler self);
+
+/**
+ * \brief Number of frames the scheduler sent since it was created
+ *
+ * \param self the scheduler instance
+ */
+LIB61850_API uint64_t
+GooseRetransmissionScheduler_getSentFrames(GooseRetransmissionScheduler self);
+
+/**
+ * \brief Stop the scheduler and release all resources
+ *
+ * The publishers are not destroyed.
+ *
+ * \param self the scheduler instance
+ */
+LIB61850_API void
+GooseRetransmissionScheduler_destroy(GooseRetransmissionScheduler self);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GOOSE_RETRANSMISSION_SCHEDULER_H_ */
@@ -58,6 +58,11 @@ GooseSubscriber_create(char* goCbRef, MmsValue* dataSetValues)
         self->isObserver = false;
         self->vlanSet = false;
         self->parseError = GOOSE_PARSE_ERROR_NO_ERROR;
+        self->listenerClasses = GOOSE_FRAME_ALL;
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+        self->receiveLock = Semaphore_create(1);
+#endif
     }
 
     return self;
@@ -103,6 +108,16 @@ GooseSubscriber_destroy(GooseSubscriber self)
         if (self->dataSetValuesSelfAllocated)
             MmsValue_delete(self->dataSetValues);
 
+        if (self->layout)
+            GLOBAL_FREEMEM(self->layout);
+
+        if (self->allData)
+            GLOBAL_FREEMEM(self->allData);
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+        Semaphore_destroy(self->receiveLock);
+#endif
+
         GLOBAL_FREEMEM(self);
     }
 }
@@ -114,6 +129,30 @@ GooseSubscriber_setListener(GooseSubscriber self, GooseListener listener, void*
     self->listenerParameter = parameter;
 }
 
+void
+GooseSubscriber_setListenerClasses(GooseSubscriber self, int frameClasses)
+{
+    self->listenerClasses = frameClasses;
+}
+
+int
+GooseSubscriber_getFrameClass(GooseSubscriber self)
+{
+    return self->frameClass;
+}
+
+void
+GooseSubscriber_getCounters(GooseSubscriber self, GooseSubscriberCounters* counters)
+{
+    *counters = self->counters;
+}
+
+void
+GooseSubscriber_resetCounters(GooseSubscriber self)
+{
+    memset(&(self->counters), 0, sizeof(GooseSubscriberCounters));
+}
+
 int32_t
 GooseSubscriber_getAppId(GooseSubscriber self)
 {
@@ -192,6 +231,12 @@ GooseSubscriber_getTimestamp(GooseSubscriber self)
     return MmsValue_getUtcTimeInMs(self->timestamp);
 }
 
+uint64_t
+GooseSubscriber_getReceiveTimestampNs(GooseSubscriber self)
+{
+    return self->rxTimestamp;
+}
+
 MmsValue*
 GooseSubscriber_getDataSetValues(GooseSubscriber self)
 {
@@ -221,3 +266,222 @@ GooseSubscriber_setObserver(GooseSubscriber self)
 {
     self->isObserver = true;
 }
+
+bool
+GooseSubscriber_setCompiledDecoding(GooseSubscriber self, bool enable)
+{
+    if (enable && (self->layout == NULL)) {
+        self->layout = (GooseElementLayout*) GLOBAL_MALLOC(sizeof(GooseElementLayout) * CONFIG_GOOSE_MAX_COMPILED_ELEMENTS);
+        self->allData = (uint8_t*) GLOBAL_MALLOC(ETH_BUFFER_LENGTH);
+
+        if ((self->layout == NULL) || (self->allData == NULL)) {
+            if (self->layout)
+                GLOBAL_FREEMEM(self->layout);
+
+            if (self->allData)
+                GLOBAL_FREEMEM(self->allData);
+
+            self->layout = NULL;
+            self->allData = NULL;
+
+            return false;
+        }
+
+        self->layoutSize = 0;
+        self->layoutValid = false;
+        self->allDataLength = 0;
+    }
+
+    self->compiledDecoding = enable;
+
+    return true;
+}
+
+static GooseElementLayout*
+getElement(GooseSubscriber self, int index, uint8_t tag)
+{
+    if ((self->compiledDecoding == false) || (self->layoutValid == false))
+        return NULL;
+
+    if ((index < 0) || (index >= self->layoutSize))
+        return NULL;
+
+    GooseElementLayout* element = &(self->layout[index]);
+
+    if ((tag != 0) && (element->tag != tag))
+        return NULL;
+
+    return element;
+}
+
+int
+GooseSubscriber_getElementCount(GooseSubscriber self)
+{
+    if ((self->compiledDecoding == false) || (self->layoutValid == false))
+        return 0;
+
+    return self->layoutSize;
+}
+
+MmsType
+GooseSubscriber_getElementType(GooseSubscriber self, int index)
+{
+    GooseElementLayout* element = getElement(self, index, 0);
+
+    if (element == NULL)
+        return MMS_DATA_ACCESS_ERROR;
+
+    switch (element->tag) {
+    case 0xa1:
+        return MMS_ARRAY;
+    case 0xa2:
+        return MMS_STRUCTURE;
+    case 0x83:
+        return MMS_BOOLEAN;
+    case 0x84:
+        return MMS_BIT_STRING;
+    case 0x85:
+        return MMS_INTEGER;
+    case 0x86:
+        return MMS_UNSIGNED;
+    case 0x87:
+        return MMS_FLOAT;
+    case 0x89:
+        return MMS_OCTET_STRING;
+    case 0x8a:
+        return MMS_VISIBLE_STRING;
+    case 0x8c:
+        return MMS_BINARY_TIME;
+    case 0x90:
+        return MMS_STRING;
+    case 0x91:
+        return MMS_UTC_TIME;
+    default:
+        return MMS_DATA_ACCESS_ERROR;
+    }
+}
+
+bool
+GooseSubscriber_getElementBoolean(GooseSubscriber self, int index, bool* value)
+{
+    GooseElementLayout* element = getElement(self, index, 0x83);
+
+    if ((element == NULL) || (element->length != 1))
+        return false;
+
+    *value = BerDecoder_decodeBoolean(self->allData, element->offset);
+
+    return true;
+}
+
+bool
+GooseSubscriber_getElementInt32(GooseSubscriber self, int index, int32_t* value)
+{
+    GooseElementLayout* element = getElement(self, index, 0x85);
+
+    if ((element == NULL) || (element->length < 1) || (element->length > 4))
+        return false;
+
+    *value = BerDecoder_decodeInt32(self->allData, element->length, element->offset);
+
+    return true;
+}
+
+bool
+GooseSubscriber_getElementUint32(GooseSubscriber self, int index, uint32_t* value)
+{
+    GooseElementLayout* element = getElement(self, index, 0x86);
+
+    /* up to 5 bytes because of the leading zero of values >= 0x80000000 */
+    if ((element == NULL) || (element->length < 1) || (element->length > 5))
+        return false;
+
+    *value = BerDecoder_decodeUint32(self->allData, element->length, element->offset);
+
+    return true;
+}
+
+bool
+GooseSubscriber_getElementDouble(GooseSubscriber self, int index, double* value)
+{
+    GooseElementLayout* element = getElement(self, index, 0x87);
+
+    if (element == NULL)
+        return false;
+
+    if (element->length == 5)
+        *value = (double) BerDecoder_decodeFloat(self->allData, element->offset);
+    else if (element->length == 9)
+        *value = BerDecoder_decodeDouble(self->allData, element->offset);
+    else
+        return false;
+
+    return true;
+}
+
+bool
+GooseSubscriber_getElementBitString(GooseSubscriber self, int index, uint32_t* value, int* bitSize)
+{
+    GooseElementLayout* element = getElement(self, index, 0x84);
+
+    if ((element == NULL) || (element->length < 1))
+        return false;
+
+    uint8_t* buffer = self->allData + element->offset;
+
+    int padding = buffer[0];
+    int size = (8 * (element->length - 1)) - padding;
+
+    if ((padding > 7) || (size < 0) || (size > 32))
+        return false;
+
+    /* same bit order as MmsValue_getBitStringAsInteger */
+    uint32_t bits = 0;
+
+    int i;
+
+    for (i = 0; i < size; i++) {
+        if (buffer[1 + (i / 8)] & (0x80 >> (i % 8)))
+            bits += ((uint32_t) 1 << i);
+    }
+
+    *value = bits;
+
+    if (bitSize)
+        *bitSize = size;
+
+    return true;
+}
+
+bool
+GooseSubscriber_getElementUtcTime(GooseSubscriber self, int index, uint64_t* msTime)
+{
+    GooseElementLayout* element = getElement(self, index, 0x91);
+
+    if ((element == NULL) || (element->length != 8))
+        return false;
+
+    uint8_t* buffer = self->allData + element->offset;
+
+    uint32_t seconds = ((uint32_t) buffer[0] << 24) | ((uint32_t) buffer[1] << 16) | ((uint32_t) buffer[2] << 8) | buffer[3];
+    uint32_t fractionOfSecond = ((uint32_t) buffer[4] << 16) | ((uint32_t) buffer[5] << 8) | buffer[6];
+
+    /* same rounding as MmsValue_getUtcTimeInMs */
+    *msTime = ((uint64_t) seconds * 1000) + (fractionOfSecond / 16777);
+
+    return true;
+}
+
+bool
+GooseSubscriber_getElementData(GooseSubscriber self, int index, uint8_t** value, int* length)
+{
+    GooseElementLayout* element = getElement(self, index, 0);
+
+    if (element == NULL)
+        return false;
+
+    *value = self->allData + element->offset;
+    *length = element->length;
+
+    return true;
+}
@@ -52,6 +52,46 @@ typedef enum
 
 typedef struct sGooseSubscriber* GooseSubscriber;
 
+/**
+ * \brief Classification of a received GOOSE message by the subscriber sequence state machine
+ *
+ * Every message gets exactly one of the sequence classes (new event, retransmission, out-of-order,
+ * duplicate or stNum rollback). GOOSE_FRAME_TTL_EXPIRED is added when the message arrived after the
+ * TimeAllowedToLive of the previous message had elapsed.
+ */
+typedef enum
+{
+    /** stNum increased (also the first message received) */
+    GOOSE_FRAME_NEW_EVENT = 1,
+    /** same stNum, sqNum increased */
+    GOOSE_FRAME_RETRANSMISSION = 2,
+    /** same stNum, sqNum lower than the highest sqNum received */
+    GOOSE_FRAME_OUT_OF_ORDER = 4,
+    /** same stNum and sqNum as the highest received */
+    GOOSE_FRAME_DUPLICATE = 8,
+    /** stNum decreased (publisher restart or replayed message) */
+    GOOSE_FRAME_ST_NUM_ROLLBACK = 16,
+    /** the previous message was no longer valid when this message arrived */
+    GOOSE_FRAME_TTL_EXPIRED = 32
+} GooseFrameClass;
+
+#define GOOSE_FRAME_ALL 0x3f
+
+/**
+ * \brief Counters of the subscriber sequence state machine
+ */
+typedef struct
+{
+    uint64_t newEvents;
+    uint64_t retransmissions;
+    uint64_t outOfOrder;
+    uint64_t duplicates;
+    uint64_t stNumRollbacks;
+    uint64_t ttlExpiries;
+    uint64_t missedEvents; /* stNum values skipped by new events */
+    uint64_t missedRetransmissions; /* sqNum values skipped by retransmissions */
+} GooseSubscriberCounters;
+
 /**
  * \brief user provided callback function that will be invoked when a GOOSE message is received.
  *
@@ -170,6 +210,55 @@ GooseSubscriber_destroy(GooseSubscriber self);
 LIB61850_API void
 GooseSubscriber_setListener(GooseSubscriber self, GooseListener listener, void* parameter);
 
+/**
+ * \brief select the message classes for which the listener is invoked
+ *
+ * By default the listener is invoked for every message (GOOSE_FRAME_ALL). An application that only
+ * reacts on state changes can use GOOSE_FRAME_NEW_EVENT to skip the callbacks for retransmissions.
+ * The data set values are not decoded again for retransmissions and duplicates that are filtered out,
+ * because they carry the data of the last state change.
+ *
+ * The listener is invoked when the class of a message has any bit in common with frameClasses.
+ *
+ * NOTE: The messages of an observer subscriber are not classified. Its listener is invoked for every message.
+ *
+ * \param self GooseSubscriber instance to operate on.
+ * \param frameClasses bit mask of GooseFrameClass values
+ */
+LIB61850_API void
+GooseSubscriber_setListenerClasses(GooseSubscriber self, int frameClasses);
+
+/**
+ * \brief Get the class of the last received GOOSE message
+ *
+ * \param self GooseSubscriber instance to operate on.
+ *
+ * \return bit mask of GooseFrameClass values, 0 when no message was received or for an observer
+ */
+LIB61850_API int
+GooseSubscriber_getFrameClass(GooseSubscriber self);
+
+/**
+ * \brief Get the counters of the sequence state machine
+ *
+ * The counters are updated by the receiver thread. When the receiver runs in a separate thread
+ * the returned values are a snapshot that is not synchronized with the receiver. The counters of an
+ * observer subscriber stay at zero.
+ *
+ * \param self GooseSubscriber instance to operate on.
+ * \param counters the counter values
+ */
+LIB61850_API void
+GooseSubscriber_getCounters(GooseSubscriber self, GooseSubscriberCounters* counters);
+
+/**
+ * \brief Set all counters of the sequence state machine to zero
+ *
+ * \param self GooseSubscriber instance to operate on.
+ */
+LIB61850_API void
+GooseSubscriber_resetCounters(GooseSubscriber self);
+
 /**
  * \brief Get the APPID value of the received GOOSE message
  *
@@ -277,6 +366,19 @@ GooseSubscriber_getTimeAllowedToLive(GooseSubscriber self);
 LIB61850_API uint64_t
 GooseSubscriber_getTimestamp(GooseSubscriber self);
 
+/**
+ * \brief Get the time when the last message was received from the network
+ *
+ * The timestamp is taken by the kernel or the NIC when the receiver has been configured with
+ * \ref GooseReceiver_enableTimestamping.
+ *
+ * \param self GooseSubscriber instance to operate on.
+ *
+ * \return the receive timestamp in nanoseconds since epoch or 0 when not available
+ */
+LIB61850_API uint64_t
+GooseSubscriber_getReceiveTimestampNs(GooseSubscriber self);
+
 /**
  * \brief get the data set values received with the last report
  *
@@ -304,10 +406,129 @@ GooseSubscriber_getVlanPrio(GooseSubscriber self);
  * \brief Configure the Subscriber to listen to any received GOOSE message
  *
  * NOTE: When the observer flag is set the subscriber also has access to the
- * goCbRef, goId, and datSet values of the received GOOSE message
+ * goCbRef, goId, and datSet values of the received GOOSE message. The flag
+ * has to be set before the subscriber is added to the GooseReceiver.
+ *
+ * The messages of the different publishers are not classified by the sequence state machine
+ * (see \ref GooseSubscriber_getFrameClass).
  */
 LIB61850_API void
 GooseSubscriber_setObserver(GooseSubscriber self);
+
+/**
+ * \brief Decode the allData of received messages with a compiled layout instead of MmsValue objects
+ *
+ * When enabled the allData of a received message is copied into a buffer of the subscriber and the
+ * position of every element is stored in a layout table. The layout is only compiled again when the
+ * confRev or the encoding of the tags and lengths changes, so no memory is allocated per message.
+ * The elements are accessed with the GooseSubscriber_getElement* functions. GooseSubscriber_getDataSetValues
+ * is not updated in this mode.
+ *
+ * Elements are numbered depth-first: a structure or array element is followed by its members.
+ *
+ * \param self GooseSubscriber instance to operate on.
+ * \param enable true to enable compiled decoding, false to use MmsValue decoding
+ *
+ * \return true on success, false when the buffers could not be allocated
+ */
+LIB61850_API bool
+GooseSubscriber_setCompiledDecoding(GooseSubscriber self, bool enable);
+
+/**
+ * \brief Get the number of allData elements of the last received message (compiled decoding)
+ *
+ * \param self GooseSubscriber instance to operate on.
+ *
+ * \return number of elements including the members of structures and arrays, 0 when no valid layout exists
+ */
+LIB61850_API int
+GooseSubscriber_getElementCount(GooseSubscriber self);
+
+/**
+ * \brief Get the type of an allData element (compiled decoding)
+ *
+ * \param self GooseSubscriber instance to operate on.
+ * \param index the depth-first index of the element
+ *
+ * \return the type of the element or MMS_DATA_ACCESS_ERROR for an invalid index or unknown tag
+ */
+LIB61850_API MmsType
+GooseSubscriber_getElementType(GooseSubscriber self, int index);
+
+/**
+ * \brief Get the value of a boolean allData element (compiled decoding)
+ *
+ * \param self GooseSubscriber instance to operate on.
+ * \param index the depth-first index of the element
+ * \param value the decoded value
+ *
+ * \return true on success, false when the index is invalid or the element is not a boolean
+ */
+LIB61850_API bool
+GooseSubscriber_getElementBoolean(GooseSubscriber self, int index, bool* value);
+
+/**
+ * \brief Get the value of an integer allData element with up to 32 bit (compiled decoding)
+ *
+ * \return true on success, false when the index is invalid or the element is not a 32 bit integer
+ */
+LIB61850_API bool
+GooseSubscriber_getElementInt32(GooseSubscriber self, int index, int32_t* value);
+
+/**
+ * \brief Get the value of an unsigned allData element with up to 32 bit (compiled decoding)
+ *
+ * \return true on success, false when the index is invalid or the element is not a 32 bit unsigned
+ */
+LIB61850_API bool
+GooseSubscriber_getElementUint32(GooseSubscriber self, int index, uint32_t* value);
+
+/**
+ * \brief Get the value of a float (32 or 64 bit) allData element (compiled decoding)
+ *
+ * \return true on success, false when the index is invalid or the element is not a float
+ */
+LIB61850_API bool
+GooseSubscriber_getElementDouble(GooseSubscriber self, int index, double* value);
+
+/**
+ * \brief Get the value of a bit string allData element with up to 32 bit (compiled decoding)
+ *
+ * The bit order is the same as with MmsValue_getBitStringAsInteger (bit 0 of the bit string is the LSB).
+ *
+ * \param self GooseSubscriber instance to operate on.
+ * \param index the depth-first index of the element
+ * \param value the bits of the bit string
+ * \param bitSize the number of bits in the bit string (can be NULL)
+ *
+ * \return true on success, false when the index is invalid or the element is not a bit string with up to 32 bit
+ */
+LIB61850_API bool
+GooseSubscriber_getElementBitString(GooseSubscriber self, int index, uint32_t* value, int* bitSize);
+
+/**
+ * \brief Get the value of a UTC time allData element in milliseconds since epoch (compiled decoding)
+ *
+ * \return true on success, false when the index is invalid or the element is not a UTC time
+ */
+LIB61850_API bool
+GooseSubscriber_getElementUtcTime(GooseSubscriber self, int index, uint64_t* msTime);
+
+/**
+ * \brief Get the encoded value of an allData element (compiled decoding)
+ *
+ * Note: The buffer is overwritten by the next received message. It should only be used inside of
+ * the callback function, when the GOOSE receiver is running in a separate thread.
+ *
+ * \param self GooseSubscriber instance to operate on.
+ * \param index the depth-first index of the element
+ * \param value the BER encoded value (without tag and length)
+ * \param length the length of the encoded value
+ *
+ * \return true on success, false when the index is invalid
+ */
+LIB61850_API bool
+GooseSubscriber_getElementData(GooseSubscriber self, int index, uint8_t** value, int* length);
 #ifdef __cplusplus
 }
 #endif
@@ -86,6 +86,8 @@ typedef struct sLogControlBlock LogControlBlock;
 
 typedef struct sLog Log;
 
+typedef struct sIedModelIndex IedModelIndex;
+
 typedef enum {
 	IEC61850_UNKNOWN_TYPE = -1,
 	IEC61850_BOOLEAN = 0,/* int */
@@ -179,6 +181,7 @@ struct sIedModel {
     LogControlBlock* lcbs;
     Log* logs;
     void (*initializer) (void);
+    IedModelIndex* index; /* optional lookup tables - created by IedModel_buildIndex */
 };
 
 struct sLogicalDevice {
@@ -602,6 +605,27 @@ LIB61850_API DataAttribute*
 IedModel_lookupDataAttributeByMmsValue(IedModel* self, MmsValue* value);
 
 
+/**
+ * \brief Create hash tables for the lookup of model nodes and data sets by reference
+ *
+ * With the index IedModel_getModelNodeByObjectReference, IedModel_getModelNodeByShortObjectReference,
+ * IedModel_getDevice, IedModel_lookupDataSet and LogicalDevice_getChildByMmsVariableName don't have
+ * to walk the model tree. The model must not be changed while the index exists.
+ * NOTE: IedServer_create builds the index automatically (see IedServerConfig_useModelIndex).
+ *
+ * \param self IedModel instance
+ */
+LIB61850_API void
+IedModel_buildIndex(IedModel* self);
+
+/**
+ * \brief Release the lookup tables created by IedModel_buildIndex
+ *
+ * \param self IedModel instance
+ */
+LIB61850_API void
+IedModel_destroyIndex(IedModel* self);
+
 /**
  * \brief Get the number of logical devices
  *
@@ -86,6 +86,9 @@ struct sIedServerConfig
     /** when true (default) the integrated GOOSE publisher is used */
     bool useIntegratedGoosePublisher;
 
+    /** when true (default) hash tables for object reference lookups are created (see IedModel_buildIndex) */
+    bool useModelIndex;
+
     /** IEC 61850 edition (0 = edition 1, 1 = edition 2, 2 = edition 2.1, ...) */
     uint8_t edition;
 
@@ -390,6 +393,17 @@ IedServerConfig_isOwnerForRCBEnabled(IedServerConfig self);
 LIB61850_API void
 IedServerConfig_useIntegratedGoosePublisher(IedServerConfig self, bool enable);
 
+/**
+ * \brief Enable/disable the lookup tables for object references of the data model
+ *
+ * When enabled (default) the IedServer builds the index of the data model (see IedModel_buildIndex)
+ * at startup and releases it when the server is destroyed.
+ *
+ * \param[in] enable set true to build the model index, otherwise false
+ */
+LIB61850_API void
+IedServerConfig_useModelIndex(IedServerConfig self, bool enable);
+
 /**
  * \brief Is the log service for MMS enabled or disabled
  *
@@ -44,6 +44,9 @@ struct sIedServer
     LinkedList clientConnections;
     uint8_t writeAccessPolicies;
 
+    /* model index was created by the server and is released with it */
+    bool ownsModelIndex;
+
 #if (CONFIG_IEC61850_REPORT_SERVICE == 1)
     int reportBufferSizeBRCBs;
     int reportBufferSizeURCBs;
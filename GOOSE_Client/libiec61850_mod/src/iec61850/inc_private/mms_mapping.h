@@ -88,9 +88,23 @@ MmsMapping_startEventWorkerThread(MmsMapping* self);
 LIB61850_INTERNAL void
 MmsMapping_stopEventWorkerThread(MmsMapping* self);
 
+/* request the event worker to run again not later than eventTime (in ms) - wakes up the sleeping worker if required */
+LIB61850_INTERNAL void
+MmsMapping_scheduleEventWorker(MmsMapping* self, uint64_t eventTime);
+
+/* request the event worker to run as soon as possible */
+LIB61850_INTERNAL void
+MmsMapping_wakeEventWorker(MmsMapping* self);
+
 LIB61850_INTERNAL DataSet*
 MmsMapping_createDataSetByNamedVariableList(MmsMapping* self, MmsNamedVariableList variableList);
 
+LIB61850_INTERNAL void
+MmsMapping_buildDataSetObservers(MmsMapping* self);
+
+LIB61850_INTERNAL void
+MmsMapping_invalidateDataSetObservers(MmsMapping* self);
+
 LIB61850_INTERNAL void
 MmsMapping_triggerReportObservers(MmsMapping* self, MmsValue* value, int flag);
 
@@ -258,6 +258,25 @@ struct sLocbTrkInstance
 
 #endif /* (CONFIG_IEC61850_SERVICE_TRACKING == 1) */
 
+/* control block that has to be informed when an MmsValue of one of its data set members changes */
+typedef struct {
+    MmsValue* value; /* data set member or one of its children */
+    void* control; /* ReportControl*, MmsGooseControlBlock or LogControl* */
+    DataSet* dataSet; /* data set of the control when the index was built */
+    DataSetEntry* dataSetEntry;
+    int entryIndex;
+    int order; /* position of the control in the control list */
+} DataSetObserver;
+
+/* reverse index MmsValue -> observers - sorted by value, hash table for the first observer of a value */
+typedef struct {
+    DataSetObserver* observers;
+    int observerCount;
+    int observerCapacity;
+    int* slots; /* index of the first observer of a value or -1 */
+    int slotCount; /* power of two */
+} DataSetObserverIndex;
+
 struct sMmsMapping {
     IedModel* model;
     MmsDevice* mmsDevice;
@@ -302,6 +321,12 @@ struct sMmsMapping {
 #if (CONFIG_MMS_THREADLESS_STACK != 1)
     bool reportThreadRunning;
     Thread reportWorkerThread;
+
+    /* deadline scheduling of the event worker thread */
+    ThreadEvent eventWorkerWakeup;
+    Semaphore eventWorkerLock; /* protects nextEventTime and eventWorkerBusy */
+    uint64_t nextEventTime; /* time when the event worker has to run next */
+    bool eventWorkerBusy; /* event worker is running the periodic tasks */
 #endif
 
 #if (CONFIG_IEC61850_SERVICE_TRACKING == 1)
@@ -330,6 +355,26 @@ struct sMmsMapping {
     Semaphore isModelLockedMutex;
 #endif /* (CONFIG_MMS_THREADLESS_STACK != 1) */
 
+    /* reverse index from data set members to the RCBs, GoCBs and LCBs that use them */
+#if (CONFIG_IEC61850_REPORT_SERVICE == 1)
+    DataSetObserverIndex reportObservers;
+#endif
+
+#if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1)
+    DataSetObserverIndex gooseObservers;
+#endif
+
+#if (CONFIG_IEC61850_LOG_SERVICE == 1)
+    DataSetObserverIndex logObservers;
+#endif
+
+    /* set to false when the data set of a control block changed - the index is rebuilt on next use */
+    bool dataSetObserversValid;
+
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+    Semaphore dataSetObserversLock;
+#endif
+
     IedServer iedServer;
 
     IedConnectionIndicationHandler connectionIndicationHandler;
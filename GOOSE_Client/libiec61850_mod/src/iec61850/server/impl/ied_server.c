@@ -452,6 +452,14 @@ IedServer_createWithConfig(IedModel* dataModel, TLSConfiguration tlsConfiguratio
     if (self) {
         self->model = dataModel;
 
+        /* the index is used by MmsMapping_create and the control object initialization */
+        if ((serverConfiguration == NULL) || serverConfiguration->useModelIndex) {
+            if (dataModel->index == NULL) {
+                IedModel_buildIndex(dataModel);
+                self->ownsModelIndex = true;
+            }
+        }
+
         self->running = false;
         self->localIpAddress = NULL;
 
@@ -569,6 +577,9 @@ IedServer_createWithConfig(IedModel* dataModel, TLSConfiguration tlsConfiguratio
 		    }
 #endif
 
+            /* reverse index from data set members to the control blocks */
+            MmsMapping_buildDataSetObservers(self->mmsMapping);
+
             IedServer_setTimeQuality(self, true, false, false, 10);
         }
         else {
@@ -627,6 +638,9 @@ IedServer_destroy(IedServer self)
         if (self->mmsMapping)
             MmsMapping_destroy(self->mmsMapping);
 
+        if (self->ownsModelIndex)
+            IedModel_destroyIndex(self->model);
+
         LinkedList_destroyDeep(self->clientConnections, (LinkedListValueDeleteFunction) private_ClientConnection_destroy);
 
 #if (CONFIG_MMS_THREADLESS_STACK != 1)
@@ -52,6 +52,7 @@ IedServerConfig_create()
         self->maxDataSetEntries = CONFIG_MMS_MAX_NUMBER_OF_DATA_SET_MEMBERS;
         self->enableLogService = true;
         self->useIntegratedGoosePublisher = true;
+        self->useModelIndex = true;
         self->edition = IEC_61850_EDITION_2;
         self->maxMmsConnections = 5;
         self->enableEditSG = true;
@@ -241,6 +242,12 @@ IedServerConfig_useIntegratedGoosePublisher(IedServerConfig self, bool enable)
     self->useIntegratedGoosePublisher = enable;
 }
 
+void
+IedServerConfig_useModelIndex(IedServerConfig self, bool enable)
+{
+    self->useModelIndex = enable;
+}
+
 bool
 IedServerConfig_isLogServiceEnabled(IedServerConfig self)
 {
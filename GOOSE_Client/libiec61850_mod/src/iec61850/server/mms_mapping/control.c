@@ -423,6 +423,8 @@ updateNextControlTimeout(MmsMapping* self, uint64_t timeout)
 {
     if (timeout < self->nextControlTimeout)
         self->nextControlTimeout = timeout;
+
+    MmsMapping_scheduleEventWorker(self, timeout);
 }
 
 static void
@@ -525,6 +527,8 @@ unselectObject(ControlObject* self, SelectStateChangedReason reason, MmsMapping*
         /* trigger timeout check in next cycle to update the next timeout value */
         mmsMapping->nextControlTimeout = 0;
 
+        MmsMapping_wakeEventWorker(mmsMapping);
+
         if (self->selectStateChangedHandler) {
             self->selectStateChangedHandler((ControlAction) self,
                     self->selectStateChangedHandlerParameter,
@@ -1505,6 +1509,8 @@ Control_processControlActions(MmsMapping* self, uint64_t currentTimeInMs)
             element = LinkedList_getNext(element);
         }
     }
+
+    MmsMapping_scheduleEventWorker(self, self->nextControlTimeout);
 }
 
 ControlObject*
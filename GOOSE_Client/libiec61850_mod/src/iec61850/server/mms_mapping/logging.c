@@ -263,8 +263,11 @@ enableLogging(LogControl* self)
     if ((self->dataSet != NULL) && (self->logInstance != NULL)) {
         self->enabled = true;
 
-        if ((self->triggerOps & TRG_OPT_INTEGRITY) && (self->intgPd != 0))
+        if ((self->triggerOps & TRG_OPT_INTEGRITY) && (self->intgPd != 0)) {
             self->nextIntegrityScan = Hal_getTimeInMs();
+
+            MmsMapping_scheduleEventWorker(self->mmsMapping, self->nextIntegrityScan);
+        }
         else
             self->nextIntegrityScan = 0;
 
@@ -677,6 +680,9 @@ LIBIEC61850_LOG_SVC_writeAccessLogControlBlock(MmsMapping* self, MmsDomain* doma
         }
     }
 
+    if (updateValue && (strcmp(varName, "DatSet") == 0))
+        MmsMapping_invalidateDataSetObservers(self);
+
     if (updateValue) {
         MmsValue* element = MmsValue_getSubElement(logControl->mmsValue, logControl->mmsType, varName);
 
@@ -1034,6 +1040,8 @@ Logging_processIntegrityLogs(MmsMapping* self, uint64_t currentTimeInMs)
 
                     logControl->nextIntegrityScan += logControl->intgPd;
                 }
+
+                MmsMapping_scheduleEventWorker(self, logControl->nextIntegrityScan);
             }
         }
 
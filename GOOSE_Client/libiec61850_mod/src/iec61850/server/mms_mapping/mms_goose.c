@@ -438,6 +438,8 @@ MmsGooseControlBlock_enable(MmsGooseControlBlock self, MmsMapping* mmsMapping)
 
         }
 
+        MmsMapping_invalidateDataSetObservers(self->mmsMapping);
+
         if (self->dataSet != NULL) {
 
             int dataSetSize = calculateMaxDataSetSize(self->dataSet);
@@ -527,6 +529,9 @@ MmsGooseControlBlock_enable(MmsGooseControlBlock self, MmsMapping* mmsMapping)
 
                 retVal = true;
 
+                /* publish first message */
+                MmsMapping_wakeEventWorker(mmsMapping);
+
 #if (CONFIG_IEC61850_SERVICE_TRACKING == 1)
                 copyGCBValuesToTrackingObject(self);
                 updateGenericTrackingObjectValues(self, IEC61850_SERVICE_TYPE_SET_GOCB_VALUES, DATA_ACCESS_ERROR_SUCCESS);
@@ -628,6 +633,8 @@ MmsGooseControlBlock_checkAndPublish(MmsGooseControlBlock self, uint64_t current
         else if ((self->nextPublishTime - currentTime) > ((uint32_t) self->maxTime * 2)) {
             self->nextPublishTime = currentTime + self->minTime;
         }
+
+        MmsMapping_scheduleEventWorker(mapping, self->nextPublishTime);
     }
 }
 
@@ -670,6 +677,9 @@ MmsGooseControlBlock_publishNewState(MmsGooseControlBlock self)
 #if (CONFIG_MMS_THREADLESS_STACK != 1)
     Semaphore_post(self->publisherMutex);
 #endif
+
+    /* first retransmission */
+    MmsMapping_scheduleEventWorker(self->mmsMapping, self->nextPublishTime);
     }
 }
 
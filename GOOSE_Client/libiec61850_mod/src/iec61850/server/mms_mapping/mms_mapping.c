@@ -703,9 +703,12 @@ MmsMapping_checkForSettingGroupReservationTimeouts(MmsMapping* self, uint64_t cu
     while (settingGroupElement != NULL) {
         SettingGroup* settingGroup = (SettingGroup*) LinkedList_getData(settingGroupElement);
 
-        if (settingGroup->sgcb->editSG != 0)
+        if (settingGroup->sgcb->editSG != 0) {
             if (currentTime >= settingGroup->reservationTimeout)
                 unselectEditSettingGroup(settingGroup);
+            else
+                MmsMapping_scheduleEventWorker(self, settingGroup->reservationTimeout);
+        }
 
         settingGroupElement = LinkedList_getNext(settingGroupElement);
     }
@@ -1984,6 +1987,18 @@ createMmsModelFromIedModel(MmsMapping* self, IedModel* iedModel)
     return mmsDevice;
 }
 
+static void
+destroyDataSetObserverIndex(DataSetObserverIndex* index)
+{
+    if (index->observers != NULL)
+        GLOBAL_FREEMEM(index->observers);
+
+    if (index->slots != NULL)
+        GLOBAL_FREEMEM(index->slots);
+
+    memset(index, 0, sizeof(DataSetObserverIndex));
+}
+
 MmsMapping*
 MmsMapping_create(IedModel* model, IedServer iedServer)
 {
@@ -2029,6 +2044,10 @@ MmsMapping_create(IedModel* model, IedServer iedServer)
 
 #if (CONFIG_MMS_THREADLESS_STACK != 1)
     self->isModelLockedMutex = Semaphore_create(1);
+    self->dataSetObserversLock = Semaphore_create(1);
+
+    self->eventWorkerWakeup = ThreadEvent_create();
+    self->eventWorkerLock = Semaphore_create(1);
 #endif
 
     self->attributeAccessHandlers = LinkedList_create();
@@ -2069,6 +2088,7 @@ MmsMapping_destroy(MmsMapping* self)
 #if (CONFIG_MMS_THREADLESS_STACK != 1)
     if (self->reportWorkerThread) {
         self->reportThreadRunning = false;
+        ThreadEvent_signal(self->eventWorkerWakeup);
         Thread_destroy(self->reportWorkerThread);
     }
 #endif
@@ -2121,8 +2141,24 @@ MmsMapping_destroy(MmsMapping* self)
     if (self->locbTrk) GLOBAL_FREEMEM(self->locbTrk);
 #endif
 
+#if (CONFIG_IEC61850_REPORT_SERVICE == 1)
+    destroyDataSetObserverIndex(&(self->reportObservers));
+#endif
+
+#if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1)
+    destroyDataSetObserverIndex(&(self->gooseObservers));
+#endif
+
+#if (CONFIG_IEC61850_LOG_SERVICE == 1)
+    destroyDataSetObserverIndex(&(self->logObservers));
+#endif
+
 #if (CONFIG_MMS_THREADLESS_STACK != 1)
     Semaphore_destroy(self->isModelLockedMutex);
+    Semaphore_destroy(self->dataSetObserversLock);
+
+    ThreadEvent_destroy(self->eventWorkerWakeup);
+    Semaphore_destroy(self->eventWorkerLock);
 #endif
 
     LinkedList_destroy(self->attributeAccessHandlers);
@@ -2731,6 +2767,8 @@ mmsWriteHandler(void* parameter, MmsDomain* domain,
 
                                             sg->reservationTimeout = Hal_getTimeInMs() + (sg->sgcb->resvTms * 1000);
 
+                                            MmsMapping_scheduleEventWorker(self, sg->reservationTimeout);
+
                                             MmsValue* editSg = MmsValue_getElement(sg->sgcbMmsValues, 2);
 
                                             if (editSg)
@@ -3493,36 +3531,89 @@ MmsMapping_setConnectionIndicationHandler(MmsMapping* self, IedConnectionIndicat
     self->connectionIndicationHandlerParameter = parameter;
 }
 
+#define DATA_SET_OBSERVER_BUFFER_SIZE 8
+
+static int
+compareDataSetObservers(const void* a, const void* b)
+{
+    const DataSetObserver* observerA = (const DataSetObserver*) a;
+    const DataSetObserver* observerB = (const DataSetObserver*) b;
+
+    if (observerA->value != observerB->value)
+        return ((uintptr_t) observerA->value < (uintptr_t) observerB->value) ? -1 : 1;
+
+    if (observerA->order != observerB->order)
+        return observerA->order - observerB->order;
+
+    /* qsort is not stable - keep the first data set entry like DataSet_isMemberValue */
+    return observerA->entryIndex - observerB->entryIndex;
+}
+
+static unsigned int
+hashValuePointer(MmsValue* value)
+{
+    uintptr_t key = (uintptr_t) value;
+
+    return (unsigned int) ((key >> 4) * 2654435761u);
+}
+
 static bool
-isMemberValueRecursive(MmsValue* container, MmsValue* value)
+addDataSetObserver(DataSetObserverIndex* index, MmsValue* value, void* control, DataSet* dataSet,
+        DataSetEntry* dataSetEntry, int entryIndex, int order)
 {
-    bool isMemberValue = false;
+    if (index->observerCount == index->observerCapacity) {
+        int newCapacity = (index->observerCapacity > 0) ? (index->observerCapacity * 2) : 64;
 
-    if (container == value)
-        isMemberValue = true;
-    else {
-        if ((MmsValue_getType(container) == MMS_STRUCTURE) ||
-                (MmsValue_getType(container) == MMS_ARRAY))
-        {
+        DataSetObserver* observers = (DataSetObserver*)
+                GLOBAL_REALLOC(index->observers, newCapacity * sizeof(DataSetObserver));
 
-            int compCount = MmsValue_getArraySize(container);
-            int i;
-            for (i = 0; i < compCount; i++) {
-                if (isMemberValueRecursive(MmsValue_getElement(container, i), value)) {
-                    isMemberValue = true;
-                    break;
-                }
+        if (observers == NULL)
+            return false;
+
+        index->observers = observers;
+        index->observerCapacity = newCapacity;
+    }
+
+    DataSetObserver* observer = &(index->observers[index->observerCount++]);
+
+    observer->value = value;
+    observer->control = control;
+    observer->dataSet = dataSet;
+    observer->dataSetEntry = dataSetEntry;
+    observer->entryIndex = entryIndex;
+    observer->order = order;
+
+    return true;
+}
+
+/* add the value and all its children - an update of any of them is an update of the data set entry */
+static bool
+addDataSetObserverRecursive(DataSetObserverIndex* index, MmsValue* value, void* control, DataSet* dataSet,
+        DataSetEntry* dataSetEntry, int entryIndex, int order)
+{
+    if (addDataSetObserver(index, value, control, dataSet, dataSetEntry, entryIndex, order) == false)
+        return false;
+
+    if ((MmsValue_getType(value) == MMS_STRUCTURE) || (MmsValue_getType(value) == MMS_ARRAY)) {
+
+        int compCount = MmsValue_getArraySize(value);
+        int i;
+
+        for (i = 0; i < compCount; i++) {
+            MmsValue* element = MmsValue_getElement(value, i);
+
+            if (element != NULL) {
+                if (addDataSetObserverRecursive(index, element, control, dataSet, dataSetEntry, entryIndex, order) == false)
+                    return false;
             }
         }
     }
 
-    return isMemberValue;
+    return true;
 }
 
-#if ((CONFIG_IEC61850_REPORT_SERVICE == 1) || (CONFIG_INCLUDE_GOOSE_SUPPORT == 1))
-
 static bool
-DataSet_isMemberValue(DataSet* dataSet, MmsValue* value, int* index)
+addDataSetObservers(DataSetObserverIndex* index, void* control, DataSet* dataSet, int order)
 {
     int i = 0;
 
@@ -3530,15 +3621,9 @@ DataSet_isMemberValue(DataSet* dataSet, MmsValue* value, int* index)
 
     while (dataSetEntry != NULL) {
 
-        MmsValue* dataSetValue = dataSetEntry->value;
-
-        if (dataSetValue != NULL) { /* prevent invalid data set members */
-            if (isMemberValueRecursive(dataSetValue, value)) {
-                if (index != NULL)
-                    *index = i;
-
-                return true;
-            }
+        if (dataSetEntry->value != NULL) { /* prevent invalid data set members */
+            if (addDataSetObserverRecursive(index, dataSetEntry->value, control, dataSet, dataSetEntry, i, order) == false)
+                return false;
         }
 
         i++;
@@ -3546,52 +3631,248 @@ DataSet_isMemberValue(DataSet* dataSet, MmsValue* value, int* index)
         dataSetEntry = dataSetEntry->sibling;
     }
 
-    return false;
+    return true;
+}
+
+/* sort by value, keep only the first data set entry of a control for each value and build the hash table */
+static bool
+finishDataSetObserverIndex(DataSetObserverIndex* index)
+{
+    int i;
+    int count = 0;
+
+    if (index->observerCount > 1)
+        qsort(index->observers, index->observerCount, sizeof(DataSetObserver), compareDataSetObservers);
+
+    for (i = 0; i < index->observerCount; i++) {
+        if ((count > 0) && (index->observers[count - 1].value == index->observers[i].value) &&
+                (index->observers[count - 1].control == index->observers[i].control))
+            continue;
+
+        index->observers[count++] = index->observers[i];
+    }
+
+    index->observerCount = count;
+
+    int slotCount = 16;
+
+    while (slotCount < (count * 2))
+        slotCount *= 2;
+
+    if (slotCount != index->slotCount) {
+        if (index->slots != NULL)
+            GLOBAL_FREEMEM(index->slots);
+
+        index->slots = (int*) GLOBAL_MALLOC(slotCount * sizeof(int));
+
+        if (index->slots == NULL) {
+            index->slotCount = 0;
+            return false;
+        }
+
+        index->slotCount = slotCount;
+    }
+
+    for (i = 0; i < slotCount; i++)
+        index->slots[i] = -1;
+
+    for (i = 0; i < count; i++) {
+        if ((i > 0) && (index->observers[i - 1].value == index->observers[i].value))
+            continue;
+
+        unsigned int slot = hashValuePointer(index->observers[i].value) & (slotCount - 1);
+
+        while (index->slots[slot] != -1)
+            slot = (slot + 1) & (slotCount - 1);
+
+        index->slots[slot] = i;
+    }
+
+    return true;
 }
-#endif /* ((CONFIG_IEC61850_REPORT_SERVICE == 1) || (CONFIG_INCLUDE_GOOSE_SUPPORT)) */
+
+static void
+rebuildDataSetObservers(MmsMapping* self)
+{
+    bool success = true;
+    LinkedList element;
+    int order;
+
+    /* an invalidation during the rebuild triggers another rebuild */
+    self->dataSetObserversValid = true;
+
+#if (CONFIG_IEC61850_REPORT_SERVICE == 1)
+    self->reportObservers.observerCount = 0;
+    order = 0;
+
+    element = LinkedList_getNext(self->reportControls);
+
+    while (element) {
+        ReportControl* rc = (ReportControl*) LinkedList_getData(element);
+
+        if (rc->dataSet != NULL) {
+            if (addDataSetObservers(&(self->reportObservers), rc, rc->dataSet, order) == false)
+                success = false;
+        }
+
+        order++;
+        element = LinkedList_getNext(element);
+    }
+
+    if (finishDataSetObserverIndex(&(self->reportObservers)) == false)
+        success = false;
+#endif /* (CONFIG_IEC61850_REPORT_SERVICE == 1) */
+
+#if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1)
+    self->gooseObservers.observerCount = 0;
+    order = 0;
+
+    element = LinkedList_getNext(self->gseControls);
+
+    while (element) {
+        MmsGooseControlBlock gcb = (MmsGooseControlBlock) LinkedList_getData(element);
+        DataSet* dataSet = MmsGooseControlBlock_getDataSet(gcb);
+
+        if (dataSet != NULL) {
+            if (addDataSetObservers(&(self->gooseObservers), gcb, dataSet, order) == false)
+                success = false;
+        }
+
+        order++;
+        element = LinkedList_getNext(element);
+    }
+
+    if (finishDataSetObserverIndex(&(self->gooseObservers)) == false)
+        success = false;
+#endif /* (CONFIG_INCLUDE_GOOSE_SUPPORT == 1) */
 
 #if (CONFIG_IEC61850_LOG_SERVICE == 1)
+    self->logObservers.observerCount = 0;
+    order = 0;
 
-static bool
-DataSet_isMemberValueWithRef(DataSet* dataSet, MmsValue* value, char* dataRef, const char* iedName, int* index)
+    element = LinkedList_getNext(self->logControls);
+
+    while (element) {
+        LogControl* lc = (LogControl*) LinkedList_getData(element);
+
+        if (lc->dataSet != NULL) {
+            if (addDataSetObservers(&(self->logObservers), lc, lc->dataSet, order) == false)
+                success = false;
+        }
+
+        order++;
+        element = LinkedList_getNext(element);
+    }
+
+    if (finishDataSetObserverIndex(&(self->logObservers)) == false)
+        success = false;
+#endif /* (CONFIG_IEC61850_LOG_SERVICE == 1) */
+
+    (void) element;
+    (void) order;
+
+    if (success == false) {
+        if (DEBUG_IED_SERVER)
+            printf("IED_SERVER: failed to build data set observer index\n");
+
+        /* try again with the next update */
+        self->dataSetObserversValid = false;
+    }
+}
+
+void
+MmsMapping_buildDataSetObservers(MmsMapping* self)
 {
-    int i = 0;
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+    Semaphore_wait(self->dataSetObserversLock);
+#endif
 
-    DataSetEntry* dataSetEntry = dataSet->fcdas;
+    rebuildDataSetObservers(self);
 
-    while (dataSetEntry != NULL) {
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+    Semaphore_post(self->dataSetObserversLock);
+#endif
+}
 
-        MmsValue *dataSetValue = dataSetEntry->value;
+void
+MmsMapping_invalidateDataSetObservers(MmsMapping* self)
+{
+    self->dataSetObserversValid = false;
+}
+
+/*
+ * Get the observers of a value. The observers are copied so that the callbacks can be invoked
+ * without holding the index lock. Returns buffer or an allocated array the caller has to release.
+ */
+static DataSetObserver*
+getDataSetObservers(MmsMapping* self, DataSetObserverIndex* index, MmsValue* value, DataSetObserver* buffer,
+        int* observerCount)
+{
+    DataSetObserver* observers = buffer;
+    int count = 0;
+
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+    Semaphore_wait(self->dataSetObserversLock);
+#endif
 
-        if (dataSetValue != NULL) { /* prevent invalid data set members */
-            if (isMemberValueRecursive(dataSetValue, value)) {
-                if (dataRef != NULL)
-                    sprintf(dataRef, "%s%s/%s", iedName, dataSetEntry->logicalDeviceName, dataSetEntry->variableName);
+    if (self->dataSetObserversValid == false)
+        rebuildDataSetObservers(self);
 
-                if (index)
-                    *index = i;
+    if (index->slotCount > 0) {
+        unsigned int slot = hashValuePointer(value) & (index->slotCount - 1);
+        int first = -1;
 
-                return true;
+        while (index->slots[slot] != -1) {
+            if (index->observers[index->slots[slot]].value == value) {
+                first = index->slots[slot];
+                break;
             }
+
+            slot = (slot + 1) & (index->slotCount - 1);
         }
 
-        i++;
+        if (first != -1) {
+            while (((first + count) < index->observerCount) && (index->observers[first + count].value == value))
+                count++;
 
-        dataSetEntry = dataSetEntry->sibling;
+            if (count > DATA_SET_OBSERVER_BUFFER_SIZE) {
+                observers = (DataSetObserver*) GLOBAL_MALLOC(count * sizeof(DataSetObserver));
+
+                if (observers == NULL) {
+                    observers = buffer;
+                    count = DATA_SET_OBSERVER_BUFFER_SIZE;
+                }
+            }
+
+            memcpy(observers, &(index->observers[first]), count * sizeof(DataSetObserver));
+        }
     }
 
-    return false;
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+    Semaphore_post(self->dataSetObserversLock);
+#endif
+
+    *observerCount = count;
+
+    return observers;
 }
 
+#if (CONFIG_IEC61850_LOG_SERVICE == 1)
+
 void
 MmsMapping_triggerLogging(MmsMapping* self, MmsValue* value, LogInclusionFlag flag)
 {
-    LinkedList element = self->logControls;
+    DataSetObserver buffer[DATA_SET_OBSERVER_BUFFER_SIZE];
+    int observerCount;
+    int i;
 
-    while ((element = LinkedList_getNext(element)) != NULL) {
-        LogControl* lc = (LogControl*) element->data;
+    DataSetObserver* observers = getDataSetObservers(self, &(self->logObservers), value, buffer, &observerCount);
 
-        if ((lc->enabled) && (lc->dataSet != NULL)) {
+    for (i = 0; i < observerCount; i++) {
+        LogControl* lc = (LogControl*) observers[i].control;
+
+        /* skip observers of a data set that has been replaced after the index was built */
+        if ((lc->enabled) && (lc->dataSet != NULL) && (lc->dataSet == observers[i].dataSet)) {
 
             uint8_t reasonCode;
 
@@ -3626,44 +3907,24 @@ MmsMapping_triggerLogging(MmsMapping* self, MmsValue* value, LogInclusionFlag fl
                 continue;
             }
 
-            char dataRef[130];
-
-            int dsEntryIdx = 0;
-
-            if (DataSet_isMemberValueWithRef(lc->dataSet, value, dataRef, self->model->name, &dsEntryIdx)) {
-
-                if (lc->logInstance != NULL) {
-
-                    if (lc->dataSet) {
+            if (lc->logInstance != NULL) {
+                DataSetEntry* dsEntry = observers[i].dataSetEntry;
 
-                        DataSetEntry* dsEntry = lc->dataSet->fcdas;
+                char dataRef[130];
 
-                        while (dsEntry && (dsEntryIdx > 0)) {
-                            dsEntry = dsEntry->sibling;
-
-                            if (dsEntry == NULL)
-                                break;
-
-                            dsEntryIdx--;
-                        }
-
-                        if (dsEntry) {
-                            MmsValue* dsValue = dsEntry->value;
-
-                            LogInstance_logSingleData(lc->logInstance, dataRef, dsValue, reasonCode);
-                        }
+                sprintf(dataRef, "%s%s/%s", self->model->name, dsEntry->logicalDeviceName, dsEntry->variableName);
 
-                    }
-
-                }
-                else {
-                    if (DEBUG_IED_SERVER)
-                        printf("IED_SERVER: No log instance available!\n");
-                }
+                LogInstance_logSingleData(lc->logInstance, dataRef, dsEntry->value, reasonCode);
+            }
+            else {
+                if (DEBUG_IED_SERVER)
+                    printf("IED_SERVER: No log instance available!\n");
             }
-
         }
     }
+
+    if (observers != buffer)
+        GLOBAL_FREEMEM(observers);
 }
 
 #endif /* (CONFIG_IEC61850_LOG_SERVICE == 1) */
@@ -3672,7 +3933,11 @@ MmsMapping_triggerLogging(MmsMapping* self, MmsValue* value, LogInclusionFlag fl
 void
 MmsMapping_triggerReportObservers(MmsMapping* self, MmsValue* value, int flag)
 {
-    LinkedList element = self->reportControls;
+    DataSetObserver buffer[DATA_SET_OBSERVER_BUFFER_SIZE];
+    int observerCount;
+    int i;
+
+    DataSetObserver* observers = getDataSetObservers(self, &(self->reportObservers), value, buffer, &observerCount);
 
 #if (CONFIG_MMS_THREADLESS_STACK != 1)
     Semaphore_wait(self->isModelLockedMutex);
@@ -3680,11 +3945,14 @@ MmsMapping_triggerReportObservers(MmsMapping* self, MmsValue* value, int flag)
 
     bool modelLocked = self->isModelLocked;
 
-    while ((element = LinkedList_getNext(element)) != NULL) {
-        ReportControl* rc = (ReportControl*) element->data;
+    for (i = 0; i < observerCount; i++) {
+        ReportControl* rc = (ReportControl*) observers[i].control;
+
+        /* skip observers of a data set that has been replaced after the index was built */
+        if (rc->dataSet != observers[i].dataSet)
+            continue;
 
         if (rc->enabled || (rc->buffered && rc->dataSet != NULL)) {
-            int index;
 
             switch (flag) {
             case REPORT_CONTROL_VALUE_UPDATE:
@@ -3703,9 +3971,7 @@ MmsMapping_triggerReportObservers(MmsMapping* self, MmsValue* value, int flag)
                 continue;
             }
 
-            if (DataSet_isMemberValue(rc->dataSet, value, &index)) {
-                ReportControl_valueUpdated(rc, index, flag, modelLocked);
-            }
+            ReportControl_valueUpdated(rc, observers[i].entryIndex, flag, modelLocked);
         }
     }
 
@@ -3716,6 +3982,9 @@ MmsMapping_triggerReportObservers(MmsMapping* self, MmsValue* value, int flag)
 #if (CONFIG_MMS_THREADLESS_STACK != 1)
     Semaphore_post(self->isModelLockedMutex);
 #endif
+
+    if (observers != buffer)
+        GLOBAL_FREEMEM(observers);
 }
 
 #endif /* (CONFIG_IEC61850_REPORT_SERVICE == 1) */
@@ -3725,31 +3994,34 @@ MmsMapping_triggerReportObservers(MmsMapping* self, MmsValue* value, int flag)
 void
 MmsMapping_triggerGooseObservers(MmsMapping* self, MmsValue* value)
 {
-    LinkedList element = self->gseControls;
+    DataSetObserver buffer[DATA_SET_OBSERVER_BUFFER_SIZE];
+    int observerCount;
+    int i;
 
-    while ((element = LinkedList_getNext(element)) != NULL) {
-        MmsGooseControlBlock gcb = (MmsGooseControlBlock) element->data;
+    DataSetObserver* observers = getDataSetObservers(self, &(self->gooseObservers), value, buffer, &observerCount);
 
-        if (MmsGooseControlBlock_isEnabled(gcb)) {
-            DataSet* dataSet = MmsGooseControlBlock_getDataSet(gcb);
+    for (i = 0; i < observerCount; i++) {
+        MmsGooseControlBlock gcb = (MmsGooseControlBlock) observers[i].control;
 
-            if (DataSet_isMemberValue(dataSet, value, NULL)) {
-                MmsGooseControlBlock_setStateChangePending(gcb);
+        if (MmsGooseControlBlock_isEnabled(gcb) && (MmsGooseControlBlock_getDataSet(gcb) == observers[i].dataSet)) {
+            MmsGooseControlBlock_setStateChangePending(gcb);
 
 #if (CONFIG_MMS_THREADLESS_STACK != 1)
-                Semaphore_wait(self->isModelLockedMutex);
+            Semaphore_wait(self->isModelLockedMutex);
 #endif
 
-                if (self->isModelLocked == false) {
-                    MmsGooseControlBlock_publishNewState(gcb);
-                }
+            if (self->isModelLocked == false) {
+                MmsGooseControlBlock_publishNewState(gcb);
+            }
 
 #if (CONFIG_MMS_THREADLESS_STACK != 1)
-                Semaphore_post(self->isModelLockedMutex);
+            Semaphore_post(self->isModelLockedMutex);
 #endif
-            }
         }
     }
+
+    if (observers != buffer)
+        GLOBAL_FREEMEM(observers);
 }
 
 void
@@ -3882,7 +4154,10 @@ processPeriodicTasks(MmsMapping* self)
 #endif
 
     /* handle low priority MMS backgound tasks (like file upload...) */
-    MmsServer_handleBackgroundTasks(self->mmsServer);
+    if (MmsServer_handleBackgroundTasks(self->mmsServer)) {
+        /* file transfers are driven by client responses - keep polling while active */
+        MmsMapping_scheduleEventWorker(self, currentTimeInMs + 1);
+    }
 }
 
 void
@@ -3891,8 +4166,49 @@ IedServer_performPeriodicTasks(IedServer self)
     processPeriodicTasks(self->mmsMapping);
 }
 
+void
+MmsMapping_scheduleEventWorker(MmsMapping* self, uint64_t eventTime)
+{
+#if (CONFIG_MMS_THREADLESS_STACK != 1)
+    bool wakeup = false;
+
+    Semaphore_wait(self->eventWorkerLock);
+
+    if (eventTime < self->nextEventTime) {
+        self->nextEventTime = eventTime;
+
+        /* a busy worker picks up the new time after the current cycle */
+        if (self->eventWorkerBusy == false)
+            wakeup = true;
+    }
+
+    Semaphore_post(self->eventWorkerLock);
+
+    if (wakeup)
+        ThreadEvent_signal(self->eventWorkerWakeup);
+#else
+    (void)self;
+    (void)eventTime;
+#endif /* (CONFIG_MMS_THREADLESS_STACK != 1) */
+}
+
+void
+MmsMapping_wakeEventWorker(MmsMapping* self)
+{
+    MmsMapping_scheduleEventWorker(self, 0);
+}
+
 #if (CONFIG_MMS_THREADLESS_STACK != 1)
-/* single worker thread for all enabled GOOSE and report control blocks */
+
+/* upper limit of the sleep time - bounds the delay caused by system time changes */
+#define EVENT_WORKER_MAX_SLEEP_TIME_MS 1000
+
+/*
+ * single worker thread for all enabled GOOSE and report control blocks
+ *
+ * The periodic tasks report their next deadlines with MmsMapping_scheduleEventWorker. The worker
+ * sleeps until the earliest deadline or until another thread schedules an earlier one.
+ */
 static void*
 eventWorkerThread(MmsMapping* self)
 {
@@ -3900,9 +4216,26 @@ eventWorkerThread(MmsMapping* self)
 
     while (running) {
 
+        Semaphore_wait(self->eventWorkerLock);
+        self->eventWorkerBusy = true;
+        self->nextEventTime = Hal_getTimeInMs() + EVENT_WORKER_MAX_SLEEP_TIME_MS;
+        Semaphore_post(self->eventWorkerLock);
+
         processPeriodicTasks(self);
 
-        Thread_sleep(1); /* hand-over control to other threads */
+        Semaphore_wait(self->eventWorkerLock);
+        self->eventWorkerBusy = false;
+        uint64_t nextEventTime = self->nextEventTime;
+        Semaphore_post(self->eventWorkerLock);
+
+        uint64_t currentTime = Hal_getTimeInMs();
+
+        unsigned int sleepTime = 1; /* hand-over control to other threads */
+
+        if (nextEventTime > currentTime + sleepTime)
+            sleepTime = (unsigned int) (nextEventTime - currentTime);
+
+        ThreadEvent_waitTimeout(self->eventWorkerWakeup, sleepTime);
 
         running = self->reportThreadRunning;
     }
@@ -3913,11 +4246,25 @@ eventWorkerThread(MmsMapping* self)
     return NULL;
 }
 
+#if (MMS_OBTAIN_FILE_SERVICE == 1)
+static void
+backgroundTaskStarted(void* parameter, MmsServer server)
+{
+    (void)server;
+
+    MmsMapping_wakeEventWorker((MmsMapping*) parameter);
+}
+#endif /* (MMS_OBTAIN_FILE_SERVICE == 1) */
+
 void
 MmsMapping_startEventWorkerThread(MmsMapping* self)
 {
     self->reportThreadRunning = true;
 
+#if (MMS_OBTAIN_FILE_SERVICE == 1)
+    MmsServer_installBackgroundTaskHandler(self->mmsServer, backgroundTaskStarted, self);
+#endif
+
     Thread thread = Thread_create((ThreadExecutionFunction) eventWorkerThread, self, false);
     self->reportWorkerThread = thread;
     Thread_start(thread);
@@ -3930,6 +4277,8 @@ MmsMapping_stopEventWorkerThread(MmsMapping* self)
 
         self->reportThreadRunning = false;
 
+        ThreadEvent_signal(self->eventWorkerWakeup);
+
         if (self->reportWorkerThread) {
             Thread_destroy(self->reportWorkerThread);
             self->reportWorkerThread = NULL;
@@ -836,6 +836,8 @@ updateReportDataset(MmsMapping* mapping, ReportControl* rc, MmsValue* newDatSet,
 
 exit_function:
 
+    MmsMapping_invalidateDataSetObservers(mapping);
+
     return success;
 }
 
@@ -2528,6 +2530,9 @@ exit_function:
         updateGenericTrackingObjectValues(self, rc, IEC61850_SERVICE_TYPE_SET_URCB_VALUES, retVal);
 #endif /* (CONFIG_IEC61850_SERVICE_TRACKING == 1) */
 
+    /* enabled RCB, GI request or changed IntgPd/BufTm have to be handled by the event worker */
+    MmsMapping_wakeEventWorker(self);
+
     if (self->rcbEventHandler) {
         self->rcbEventHandler(self->rcbEventHandlerParameter, rc->rcb, clientConnection, RCB_EVENT_SET_PARAMETER, elementName, retVal);
     }
@@ -3918,6 +3923,20 @@ processEventsForReport(ReportControl* rc, uint64_t currentTimeInMs)
     }
 }
 
+/* report the next integrity period or buffer time expiry of the RCB to the event worker */
+static void
+scheduleNextReportEvent(MmsMapping* self, ReportControl* rc)
+{
+    if ((rc->enabled) || (rc->isBuffering)) {
+
+        if ((rc->triggerOps & TRG_OPT_INTEGRITY) && (rc->intgPd > 0))
+            MmsMapping_scheduleEventWorker(self, rc->nextIntgReportTime);
+
+        if (rc->triggered)
+            MmsMapping_scheduleEventWorker(self, rc->reportTime);
+    }
+}
+
 void
 Reporting_processReportEvents(MmsMapping* self, uint64_t currentTimeInMs)
 {
@@ -3936,9 +3955,15 @@ Reporting_processReportEvents(MmsMapping* self, uint64_t currentTimeInMs)
 
             processEventsForReport(rc, currentTimeInMs);
 
+            scheduleNextReportEvent(self, rc);
+
             ReportControl_unlockNotify(rc);
         }
     }
+    else {
+        /* retry when the data model is unlocked */
+        MmsMapping_scheduleEventWorker(self, currentTimeInMs + 1);
+    }
 
 #if (CONFIG_MMS_THREADLESS_STACK != 1)
     Semaphore_post(self->isModelLockedMutex);
@@ -4055,6 +4080,9 @@ ReportControl_valueUpdated(ReportControl* self, int dataSetEntryIndex, int flag,
         MmsValue_setBinaryTime(self->timeOfEntry, currentTime);
 
         self->reportTime = currentTime + self->bufTm;
+
+        /* send the report when the buffer time expired */
+        MmsMapping_scheduleEventWorker(self->server->mmsMapping, self->reportTime);
     }
 
     self->triggered = true;
@@ -860,6 +860,8 @@ void
 IedModel_destroy(IedModel* model)
 {
     if (model) {
+        IedModel_destroyIndex(model);
+
         /* delete all model nodes and dynamically created strings */
 
         /* delete all logical devices */
@@ -25,6 +25,14 @@
 
 #include "stack_config.h"
 #include "libiec61850_platform_includes.h"
+#include "string_map.h"
+
+/* lookup tables from references to model nodes - see IedModel_buildIndex */
+struct sIedModelIndex {
+    Map objectReferences; /* LD name or full object reference -> ModelNode */
+    Map dataSets; /* data set reference (e.g. ied1Inverter/LLN0$dataset1) -> DataSet */
+    Map mmsVariables; /* LogicalDevice -> map of MMS variable name (e.g. GGIO1$ST$Ind1$stVal) -> DataAttribute */
+};
 
 static void
 setAttributeValuesToNull(ModelNode* node)
@@ -91,8 +99,8 @@ IedModel_getLogicalDeviceCount(IedModel* self)
 	return ldCount;
 }
 
-DataSet*
-IedModel_lookupDataSet(IedModel* self, const char* dataSetReference  /* e.g. ied1Inverter/LLN0$dataset1 */)
+static DataSet*
+lookupDataSet(IedModel* self, const char* dataSetReference)
 {
 	DataSet* dataSet = self->dataSets;
 
@@ -130,8 +138,21 @@ IedModel_lookupDataSet(IedModel* self, const char* dataSetReference  /* e.g. ied
 	return NULL;
 }
 
-LogicalDevice*
-IedModel_getDevice(IedModel* self, const char* deviceName)
+DataSet*
+IedModel_lookupDataSet(IedModel* self, const char* dataSetReference  /* e.g. ied1Inverter/LLN0$dataset1 */)
+{
+    if (self->index) {
+        DataSet* dataSet = (DataSet*) Map_getEntry(self->index->dataSets, (void*) dataSetReference);
+
+        if (dataSet)
+            return dataSet;
+    }
+
+    return lookupDataSet(self, dataSetReference);
+}
+
+static LogicalDevice*
+getDevice(IedModel* self, const char* deviceName)
 {
     LogicalDevice* device = self->firstChild;
 
@@ -150,6 +171,20 @@ IedModel_getDevice(IedModel* self, const char* deviceName)
     return NULL;
 }
 
+LogicalDevice*
+IedModel_getDevice(IedModel* self, const char* deviceName)
+{
+    /* keys without separator are logical device names */
+    if (self->index && (strchr(deviceName, '/') == NULL)) {
+        LogicalDevice* device = (LogicalDevice*) Map_getEntry(self->index->objectReferences, (void*) deviceName);
+
+        if (device)
+            return device;
+    }
+
+    return getDevice(self, deviceName);
+}
+
 LogicalDevice*
 IedModel_getDeviceByInst(IedModel* self, const char* ldInst)
 {
@@ -294,6 +329,13 @@ IedModel_getModelNodeByObjectReference(IedModel* model, const char* objectRefere
 {
     assert(strlen(objectReference) < 129);
 
+    if (model->index) {
+        ModelNode* node = (ModelNode*) Map_getEntry(model->index->objectReferences, (void*) objectReference);
+
+        if (node)
+            return node;
+    }
+
     char objRef[130];
 
     StringUtils_copyStringMax(objRef, 130, objectReference);
@@ -351,6 +393,17 @@ IedModel_getModelNodeByShortObjectReference(IedModel* model, const char* objectR
     if (separator != NULL)
         *separator = 0;
 
+    if (model->index) {
+        char fullObjRef[130];
+
+        if (StringUtils_concatString(fullObjRef, 130, model->name, objectReference)) {
+            ModelNode* node = (ModelNode*) Map_getEntry(model->index->objectReferences, fullObjRef);
+
+            if (node)
+                return node;
+        }
+    }
+
     char ldName[65];
 
     if (StringUtils_concatString(ldName, 65, model->name, objRef))
@@ -471,8 +524,8 @@ LogicalDevice_getLogicalNodeCount(LogicalDevice* logicalDevice)
 	return lnCount;
 }
 
-ModelNode*
-LogicalDevice_getChildByMmsVariableName(LogicalDevice* logicalDevice, const char* mmsVariableName)
+static ModelNode*
+getChildByMmsVariableName(LogicalDevice* logicalDevice, const char* mmsVariableName)
 {
 	const char* separator = strchr(mmsVariableName,'$');
 
@@ -517,6 +570,25 @@ LogicalDevice_getChildByMmsVariableName(LogicalDevice* logicalDevice, const char
 	return NULL;
 }
 
+ModelNode*
+LogicalDevice_getChildByMmsVariableName(LogicalDevice* logicalDevice, const char* mmsVariableName)
+{
+    IedModel* model = (IedModel*) logicalDevice->parent;
+
+    if (model && model->index) {
+        Map mmsVariables = (Map) Map_getEntry(model->index->mmsVariables, logicalDevice);
+
+        if (mmsVariables) {
+            ModelNode* node = (ModelNode*) Map_getEntry(mmsVariables, (void*) mmsVariableName);
+
+            if (node)
+                return node;
+        }
+    }
+
+    return getChildByMmsVariableName(logicalDevice, mmsVariableName);
+}
+
 static int
 createObjectReference(ModelNode* node, char* objectReference, int bufSize, bool withoutIedName)
 {
@@ -794,3 +866,158 @@ LogicalDevice_getSettingGroupControlBlock(LogicalDevice* self)
 
     return NULL;
 }
+
+/*
+ * Add the node and all its children to the index. objRef contains the object reference of the
+ * parent node (objRefLen characters) and mmsPath the MMS name components below the logical
+ * node (e.g. "$Ind1$stVal"). A reference is only added when the node is the one the
+ * sequential lookup returns for it, so index and sequential lookup always give the same result.
+ */
+static void
+addModelNodeToIndex(IedModelIndex* index, Map mmsVariables, LogicalDevice* ld, LogicalNode* ln, ModelNode* node,
+        char* objRef, int objRefLen, char* mmsPath, int mmsPathLen)
+{
+    int nameLen = strlen(node->name);
+
+    /* object reference + separator + name has to fit into 129 characters */
+    if ((objRefLen + 1 + nameLen) > 129)
+        return;
+
+    objRef[objRefLen] = (ln == NULL) ? '/' : '.';
+    memcpy(objRef + objRefLen + 1, node->name, nameLen + 1);
+
+    int newObjRefLen = objRefLen + 1 + nameLen;
+
+    char* path = strchr(objRef, '/') + 1;
+
+    if (ModelNode_getChild((ModelNode*) ld, path) != node)
+        return;
+
+    Map_addEntryWithArenaKey(index->objectReferences,
+            Map_copyKeyToArena(index->objectReferences, objRef, newObjRefLen + 1), node);
+
+    int newMmsPathLen = mmsPathLen;
+
+    if (ln != NULL) {
+        if ((mmsPathLen + 1 + nameLen) > 129)
+            return;
+
+        mmsPath[mmsPathLen] = '$';
+        memcpy(mmsPath + mmsPathLen + 1, node->name, nameLen + 1);
+
+        newMmsPathLen = mmsPathLen + 1 + nameLen;
+
+        if (node->modelType == DataAttributeModelType) {
+            DataAttribute* da = (DataAttribute*) node;
+
+            char mmsVariableName[130];
+
+            int mmsNameLen = snprintf(mmsVariableName, 130, "%s$%s%s", ln->name,
+                    FunctionalConstraint_toString(da->fc), mmsPath);
+
+            if ((mmsNameLen < 130) && (getChildByMmsVariableName(ld, mmsVariableName) == node))
+                StringMap_addEntry(mmsVariables, mmsVariableName, node);
+        }
+    }
+    else {
+        ln = (LogicalNode*) node;
+    }
+
+    ModelNode* child = node->firstChild;
+
+    while (child) {
+        addModelNodeToIndex(index, mmsVariables, ld, ln, child, objRef, newObjRefLen, mmsPath, newMmsPathLen);
+
+        child = child->sibling;
+    }
+}
+
+void
+IedModel_buildIndex(IedModel* self)
+{
+    if (self->index)
+        IedModel_destroyIndex(self);
+
+    IedModelIndex* index = (IedModelIndex*) GLOBAL_CALLOC(1, sizeof(struct sIedModelIndex));
+
+    if (index == NULL)
+        return;
+
+    index->objectReferences = StringMap_create();
+    index->dataSets = StringMap_create();
+    index->mmsVariables = Map_create();
+
+    char objRef[130];
+    char mmsPath[130];
+
+    LogicalDevice* ld = self->firstChild;
+
+    while (ld) {
+        StringUtils_concatString(objRef, 130, self->name, ld->name);
+
+        if (getDevice(self, objRef) == ld) {
+            Map mmsVariables = StringMap_create();
+
+            Map_addEntry(index->mmsVariables, ld, mmsVariables);
+
+            StringMap_addEntry(index->objectReferences, objRef, ld);
+
+            int objRefLen = strlen(objRef);
+
+            ModelNode* ln = ld->firstChild;
+
+            while (ln) {
+                mmsPath[0] = 0;
+
+                addModelNodeToIndex(index, mmsVariables, ld, NULL, ln, objRef, objRefLen, mmsPath, 0);
+
+                ln = ln->sibling;
+            }
+        }
+
+        ld = (LogicalDevice*) ld->sibling;
+    }
+
+    DataSet* dataSet = self->dataSets;
+
+    while (dataSet) {
+        char dataSetRef[130];
+
+        StringUtils_concatString(dataSetRef, 130, self->name, dataSet->logicalDeviceName);
+        StringUtils_appendString(dataSetRef, 130, "/");
+        StringUtils_appendString(dataSetRef, 130, dataSet->name);
+
+        if (lookupDataSet(self, dataSetRef) == dataSet)
+            StringMap_addEntry(index->dataSets, dataSetRef, dataSet);
+
+        dataSet = dataSet->sibling;
+    }
+
+    if (DEBUG_IED_SERVER)
+        printf("IED_SERVER: model index with %i object references, %i data sets\n",
+                Map_size(index->objectReferences), Map_size(index->dataSets));
+
+    self->index = index;
+}
+
+static void
+deleteMmsVariablesMap(void* map)
+{
+    Map_deleteStatic((Map) map, false);
+}
+
+void
+IedModel_destroyIndex(IedModel* self)
+{
+    IedModelIndex* index = self->index;
+
+    if (index) {
+        self->index = NULL;
+
+        Map_deleteStatic(index->objectReferences, false);
+        Map_deleteStatic(index->dataSets, false);
+        Map_deleteDeep(index->mmsVariables, false, deleteMmsVariablesMap);
+
+        GLOBAL_FREEMEM(index);
+    }
+}
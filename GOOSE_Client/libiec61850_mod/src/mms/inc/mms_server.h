@@ -129,6 +129,28 @@ typedef void (*MmsGetFileCompleteHandler)(void* parameter, MmsServerConnection c
 LIB61850_INTERNAL void
 MmsServer_installGetFileCompleteHandler(MmsServer self, MmsGetFileCompleteHandler handler, void* parameter);
 
+/**
+ * \brief Background task callback handler
+ *
+ * This is invoked when a new background task (e.g. a file upload) has been started by a client request.
+ *
+ * \param parameter user provided parameter that is passed to the callback handler
+ * \param server the MmsServer instance
+ */
+typedef void (*MmsBackgroundTaskHandler)(void* parameter, MmsServer server);
+
+/**
+ * \brief Install callback handler that is invoked when a new background task has been started
+ *
+ * This handler can be used to wake up the thread that calls \ref MmsServer_handleBackgroundTasks.
+ *
+ * \param self the MmsServer instance
+ * \param handler the callback handler function
+ * \param parameter user provided parameter that is passed to the callback handler
+ */
+LIB61850_INTERNAL void
+MmsServer_installBackgroundTaskHandler(MmsServer self, MmsBackgroundTaskHandler handler, void* parameter);
+
 
 typedef  enum {
     MMS_FILE_ACCESS_TYPE_READ_DIRECTORY,
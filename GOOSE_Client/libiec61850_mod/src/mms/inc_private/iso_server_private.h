@@ -24,9 +24,18 @@
 #ifndef ISO_SERVER_PRIVATE_H_
 #define ISO_SERVER_PRIVATE_H_
 
+#include "stack_config.h"
 #include "tls_config.h"
 #include "hal_socket.h"
 
+/* the event loop replaces the connection threads of the multi-threaded server (Linux only) */
+#if (CONFIG_MMS_SERVER_EVENT_LOOP == 1)
+#if (CONFIG_MMS_SINGLE_THREADED == 1) || (CONFIG_MMS_THREADLESS_STACK == 1) || !defined(__linux__)
+#undef CONFIG_MMS_SERVER_EVENT_LOOP
+#define CONFIG_MMS_SERVER_EVENT_LOOP 0
+#endif
+#endif
+
 LIB61850_INTERNAL IsoConnection
 IsoConnection_create(Socket socket, IsoServer isoServer, bool isSingleThread);
 
@@ -42,6 +51,34 @@ IsoConnection_callTickHandler(IsoConnection self);
 LIB61850_INTERNAL void
 IsoConnection_handleTcpConnection(IsoConnection self, bool isSingleThread);
 
+#if (CONFIG_MMS_SERVER_EVENT_LOOP == 1)
+/**
+ * \brief Handle all messages that can be read from the socket (required for edge triggered events)
+ *
+ * \return true when the socket could not be read completely and the function has to be called again
+ */
+LIB61850_INTERNAL bool
+IsoConnection_handleAvailableMessages(IsoConnection self);
+
+/**
+ * \brief Check if the last call of IsoConnection_handleAvailableMessages did not read all data
+ */
+LIB61850_INTERNAL bool
+IsoConnection_isReceivePending(IsoConnection self);
+
+/**
+ * \brief Add the connection socket to the given SocketEventQueue instance
+ */
+LIB61850_INTERNAL bool
+IsoConnection_addToEventQueue(const IsoConnection self, SocketEventQueue eventQueue);
+
+/**
+ * \brief Remove the connection socket from the given SocketEventQueue instance
+ */
+LIB61850_INTERNAL void
+IsoConnection_removeFromEventQueue(const IsoConnection self, SocketEventQueue eventQueue);
+#endif /* (CONFIG_MMS_SERVER_EVENT_LOOP == 1) */
+
 #define ISO_CON_STATE_TERMINATED 2 /* connection has terminated and is ready to be destroyed */
 #define ISO_CON_STATE_RUNNING 1 /* connection is newly started */
 #define ISO_CON_STATE_STOPPED 0 /* connection is being stopped */
@@ -166,6 +166,9 @@ struct sMmsServer {
     MmsGetFileCompleteHandler getFileCompleteHandler;
     void* getFileCompleteHandlerParameter;
 
+    MmsBackgroundTaskHandler backgroundTaskHandler;
+    void* backgroundTaskHandlerParameter;
+
     struct sMmsObtainFileTask fileUploadTasks[CONFIG_MMS_SERVER_MAX_GET_FILE_TASKS];
 #endif
 
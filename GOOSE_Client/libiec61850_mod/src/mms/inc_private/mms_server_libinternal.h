@@ -171,8 +171,10 @@ MmsServer_handleIncomingMessages(MmsServer self);
  * \brief Handle MmsServer background task
  *
  * \param self the MmsServer instance to operate on
+ *
+ * \return true when background tasks are still active and have to be handled again, false otherwise
  */
-LIB61850_INTERNAL void
+LIB61850_INTERNAL bool
 MmsServer_handleBackgroundTasks(MmsServer self);
 
 /**
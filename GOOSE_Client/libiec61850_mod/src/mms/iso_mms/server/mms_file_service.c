@@ -794,6 +794,9 @@ mmsServer_handleObtainFileRequest(
 #if (CONFIG_MMS_THREADLESS_STACK != 1)
             Semaphore_post(task->taskLock);
 #endif
+
+            if (connection->server->backgroundTaskHandler)
+                connection->server->backgroundTaskHandler(connection->server->backgroundTaskHandlerParameter, connection->server);
         }
         else
             goto exit_unavailable;
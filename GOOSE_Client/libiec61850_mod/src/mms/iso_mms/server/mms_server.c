@@ -408,6 +408,13 @@ MmsServer_installGetFileCompleteHandler(MmsServer self, MmsGetFileCompleteHandle
     self->getFileCompleteHandler = handler;
     self->getFileCompleteHandlerParameter = parameter;
 }
+
+void
+MmsServer_installBackgroundTaskHandler(MmsServer self, MmsBackgroundTaskHandler handler, void* parameter)
+{
+    self->backgroundTaskHandler = handler;
+    self->backgroundTaskHandlerParameter = parameter;
+}
 #endif /* (MMS_OBTAIN_FILE_SERVICE == 1) */
 
 static void
@@ -725,9 +732,10 @@ MmsServer_handleIncomingMessages(MmsServer self)
     }
 }
 
-void
+bool
 MmsServer_handleBackgroundTasks(MmsServer self)
 {
+    bool tasksActive = false;
 
 #if (MMS_OBTAIN_FILE_SERVICE == 1)
 
@@ -746,10 +754,14 @@ MmsServer_handleBackgroundTasks(MmsServer self)
 
         if (taskState != 0) {
             mmsServer_fileUploadTask(self, &(self->fileUploadTasks[i]), taskState);
+
+            tasksActive = true;
         }
     }
 
 #endif /* (MMS_OBTAIN_FILE_SERVICE == 1) */
+
+    return tasksActive;
 }
 
 int
@@ -59,7 +59,7 @@ MmsValueCache_insertValue(MmsValueCache self, char* itemId, MmsValue* value)
 		cacheEntry->value = value;
 		cacheEntry->typeSpec = typeSpec;
 
-		Map_addEntry(self->map, StringUtils_copyString(itemId), cacheEntry);
+		StringMap_addEntry(self->map, itemId, cacheEntry);
 	}
 	else
 		if (DEBUG) printf("Cannot insert value into cache %s : no typeSpec found!\n", itemId);
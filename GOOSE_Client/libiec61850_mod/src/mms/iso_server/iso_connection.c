@@ -90,6 +90,10 @@ struct sIsoConnection
 #if (CONFIG_MMS_SINGLE_THREADED != 1) || (CONFIG_MMS_THREADLESS_STACK == 1)
     HandleSet handleSet;
 #endif
+
+#if (CONFIG_MMS_SERVER_EVENT_LOOP == 1)
+    bool receivePending; /* socket not completely read - no new event will be reported */
+#endif
 };
 
 static void
@@ -167,19 +171,10 @@ IsoConnection_callTickHandler(IsoConnection self)
     }
 }
 
-void
-IsoConnection_handleTcpConnection(IsoConnection self, bool isSingleThread)
+/* read from the socket and handle the message when a TPKT packet is complete */
+static TpktState
+handleTpktPacket(IsoConnection self)
 {
-#if (CONFIG_MMS_SINGLE_THREADED != 1)
-    if (isSingleThread == false) {
-
-        IsoConnection_callTickHandler(self);
-
-        if (Handleset_waitReady(self->handleSet, 10) < 1)
-            goto exit_function;
-    }
-#endif
-
     TpktState tpktState = CotpConnection_readToTpktBuffer(self->cotpConnection);
 
     if (tpktState == TPKT_ERROR)
@@ -463,8 +458,62 @@ IsoConnection_handleTcpConnection(IsoConnection self, bool isSingleThread)
     }
 
 exit_function:
-    return;
+    return tpktState;
+}
+
+void
+IsoConnection_handleTcpConnection(IsoConnection self, bool isSingleThread)
+{
+#if (CONFIG_MMS_SINGLE_THREADED != 1)
+    if (isSingleThread == false) {
+
+        IsoConnection_callTickHandler(self);
+
+        if (Handleset_waitReady(self->handleSet, 10) < 1)
+            return;
+    }
+#endif
+
+    handleTpktPacket(self);
+}
+
+#if (CONFIG_MMS_SERVER_EVENT_LOOP == 1)
+bool
+IsoConnection_handleAvailableMessages(IsoConnection self)
+{
+    /* handle all complete messages - with edge triggered events the socket has to be read until it is empty */
+    while (self->state == ISO_CON_STATE_RUNNING) {
+        if (handleTpktPacket(self) != TPKT_PACKET_COMPLETE)
+            break;
+    }
+
+    /* the socket is not read while the socket extension buffer contains unsent data */
+    if ((self->state == ISO_CON_STATE_RUNNING) && (self->cotpConnection->socketExtensionBufferFill > 0))
+        self->receivePending = true;
+    else
+        self->receivePending = false;
+
+    return self->receivePending;
+}
+
+bool
+IsoConnection_isReceivePending(IsoConnection self)
+{
+    return self->receivePending;
+}
+
+bool
+IsoConnection_addToEventQueue(const IsoConnection self, SocketEventQueue eventQueue)
+{
+    return SocketEventQueue_addSocket(eventQueue, self->socket, self);
+}
+
+void
+IsoConnection_removeFromEventQueue(const IsoConnection self, SocketEventQueue eventQueue)
+{
+    SocketEventQueue_removeSocket(eventQueue, self->socket);
 }
+#endif /* (CONFIG_MMS_SERVER_EVENT_LOOP == 1) */
 
 #if ((CONFIG_MMS_SINGLE_THREADED == 0) && (CONFIG_MMS_THREADLESS_STACK == 0))
 /* only for multi-thread mode */
@@ -36,6 +36,7 @@
 #include "mms_server_connection.h"
 
 #include "hal_thread.h"
+#include "hal_time.h"
 
 #include "iso_server.h"
 
@@ -49,6 +50,32 @@
 #define SECURE_TCP_PORT 3782
 #define BACKLOG 10
 
+#if (CONFIG_MMS_SERVER_EVENT_LOOP == 1)
+
+#ifndef CONFIG_MMS_SERVER_EVENT_LOOP_WORKERS
+#define CONFIG_MMS_SERVER_EVENT_LOOP_WORKERS 4
+#endif
+
+/* interval of the tick handler calls - same as the poll timeout of the connection threads */
+#define WORKER_TICK_INTERVAL_MS 10
+
+#define WORKER_MAX_EVENTS 32
+
+typedef struct sIsoServerWorker* IsoServerWorker;
+
+/* handles the connections assigned to it - a connection is always handled by the same worker */
+struct sIsoServerWorker {
+    IsoServer isoServer;
+    Thread thread;
+    bool running;
+    SocketEventQueue eventQueue;
+    LinkedList connections;
+    int connectionCount;
+    Semaphore connectionsLock; /* protects connections and connectionCount */
+};
+
+#endif /* (CONFIG_MMS_SERVER_EVENT_LOOP == 1) */
+
 struct sIsoServer {
     IsoServerState state;
 
@@ -90,6 +117,11 @@ struct sIsoServer {
 #endif
 
     int connectionCounter;
+
+#if (CONFIG_MMS_SERVER_EVENT_LOOP == 1)
+    bool useEventLoop;
+    struct sIsoServerWorker workers[CONFIG_MMS_SERVER_EVENT_LOOP_WORKERS];
+#endif
 };
 
 static void
@@ -455,6 +487,195 @@ exit_function:
     return success;
 }
 
+#if (CONFIG_MMS_SERVER_EVENT_LOOP == 1)
+
+/* close the connection and give it to the server thread for destruction (same as connection thread) */
+static void
+closeWorkerConnection(IsoServerWorker self, IsoConnection isoConnection)
+{
+    IsoConnection_removeFromEventQueue(isoConnection, self->eventQueue);
+
+    LinkedList_remove(self->connections, isoConnection);
+    self->connectionCount--;
+
+    IsoServer_closeConnection(self->isoServer, isoConnection);
+
+    IsoConnection_close(isoConnection);
+}
+
+static void
+handleWorkerTick(IsoServerWorker self)
+{
+    Semaphore_wait(self->connectionsLock);
+
+    LinkedList element = LinkedList_getNext(self->connections);
+
+    while (element) {
+        IsoConnection isoConnection = (IsoConnection) LinkedList_getData(element);
+
+        element = LinkedList_getNext(element);
+
+        if (IsoConnection_isRunning(isoConnection)) {
+            IsoConnection_callTickHandler(isoConnection);
+
+            /* the tick handler flushed pending data - continue reading */
+            if (IsoConnection_isReceivePending(isoConnection))
+                IsoConnection_handleAvailableMessages(isoConnection);
+        }
+
+        if (IsoConnection_getState(isoConnection) == ISO_CON_STATE_STOPPED)
+            closeWorkerConnection(self, isoConnection);
+    }
+
+    Semaphore_post(self->connectionsLock);
+}
+
+static void*
+isoServerWorkerThread(void* parameter)
+{
+    IsoServerWorker self = (IsoServerWorker) parameter;
+
+    void* readyConnections[WORKER_MAX_EVENTS];
+
+    uint64_t nextTick = Hal_getTimeInMs() + WORKER_TICK_INTERVAL_MS;
+
+    while (self->running) {
+        uint64_t currentTime = Hal_getTimeInMs();
+
+        unsigned int timeout = 0;
+
+        if (nextTick > currentTime)
+            timeout = (unsigned int) (nextTick - currentTime);
+
+        int readyCount = SocketEventQueue_waitReady(self->eventQueue, readyConnections, WORKER_MAX_EVENTS, timeout);
+
+        bool connectionStopped = false;
+
+        int i;
+
+        for (i = 0; i < readyCount; i++) {
+            IsoConnection isoConnection = (IsoConnection) readyConnections[i];
+
+            if (IsoConnection_isRunning(isoConnection))
+                IsoConnection_handleAvailableMessages(isoConnection);
+
+            if (IsoConnection_isRunning(isoConnection) == false)
+                connectionStopped = true;
+        }
+
+        currentTime = Hal_getTimeInMs();
+
+        if ((currentTime >= nextTick) || connectionStopped) {
+            handleWorkerTick(self);
+
+            if (currentTime >= nextTick)
+                nextTick = currentTime + WORKER_TICK_INTERVAL_MS;
+        }
+    }
+
+    /* close remaining connections - connection handler is called like in connection thread */
+    Semaphore_wait(self->connectionsLock);
+
+    LinkedList element;
+
+    while ((element = LinkedList_getNext(self->connections)) != NULL)
+        closeWorkerConnection(self, (IsoConnection) LinkedList_getData(element));
+
+    Semaphore_post(self->connectionsLock);
+
+    return NULL;
+}
+
+static void
+assignConnectionToWorker(IsoServer self, IsoConnection isoConnection)
+{
+    IsoServerWorker worker = &(self->workers[0]);
+
+    int i;
+
+    /* use the worker with the lowest number of connections */
+    for (i = 1; i < CONFIG_MMS_SERVER_EVENT_LOOP_WORKERS; i++) {
+        if (self->workers[i].connectionCount < worker->connectionCount)
+            worker = &(self->workers[i]);
+    }
+
+    Semaphore_wait(worker->connectionsLock);
+
+    LinkedList_add(worker->connections, isoConnection);
+    worker->connectionCount++;
+
+    if (IsoConnection_addToEventQueue(isoConnection, worker->eventQueue) == false) {
+        if (DEBUG_ISO_SERVER)
+            printf("ISO_SERVER: failed to add connection to event queue -> close connection\n");
+
+        /* unlink before the server thread destroys the closed connection */
+        closeWorkerConnection(worker, isoConnection);
+    }
+
+    /* NOTE: adding a socket that is already readable creates an event */
+
+    Semaphore_post(worker->connectionsLock);
+}
+
+static void
+startWorkers(IsoServer self)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_MMS_SERVER_EVENT_LOOP_WORKERS; i++) {
+        IsoServerWorker worker = &(self->workers[i]);
+
+        worker->eventQueue = SocketEventQueue_create();
+
+        if (worker->eventQueue == NULL) {
+            if (DEBUG_ISO_SERVER)
+                printf("ISO_SERVER: failed to create event queue -> use connection threads\n");
+
+            self->useEventLoop = false;
+            break;
+        }
+
+        worker->isoServer = self;
+        worker->connections = LinkedList_create();
+        worker->connectionCount = 0;
+        worker->connectionsLock = Semaphore_create(1);
+        worker->running = true;
+        worker->thread = Thread_create((ThreadExecutionFunction) isoServerWorkerThread, worker, false);
+
+        Thread_start(worker->thread);
+    }
+}
+
+static void
+stopWorkers(IsoServer self)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_MMS_SERVER_EVENT_LOOP_WORKERS; i++) {
+        IsoServerWorker worker = &(self->workers[i]);
+
+        if (worker->thread) {
+            worker->running = false;
+
+            Thread_destroy(worker->thread);
+            worker->thread = NULL;
+
+            LinkedList_destroyStatic(worker->connections);
+            worker->connections = NULL;
+
+            Semaphore_destroy(worker->connectionsLock);
+            worker->connectionsLock = NULL;
+        }
+
+        if (worker->eventQueue) {
+            SocketEventQueue_destroy(worker->eventQueue);
+            worker->eventQueue = NULL;
+        }
+    }
+}
+
+#endif /* (CONFIG_MMS_SERVER_EVENT_LOOP == 1) */
+
 /** used by single and multi-threaded versions
  *
  * \param isSingleThread when true server is running in single thread or non-thread mode
@@ -504,6 +725,27 @@ handleIsoConnections(IsoServer self, bool isSingleThread)
         }
 #endif
 
+#if (CONFIG_MMS_SERVER_EVENT_LOOP == 1)
+        if (self->useEventLoop) {
+            /* the connection is handled by a worker thread - no connection thread is required */
+            IsoConnection isoConnection = IsoConnection_create(connectionSocket, self, true);
+
+            if (isoConnection) {
+                addClientConnection(self, isoConnection);
+
+                self->connectionHandler(ISO_CONNECTION_OPENED, self->connectionHandlerParameter,
+                        isoConnection);
+
+                assignConnectionToWorker(self, isoConnection);
+            }
+            else {
+                Socket_destroy(connectionSocket);
+            }
+
+            return;
+        }
+#endif /* (CONFIG_MMS_SERVER_EVENT_LOOP == 1) */
+
         IsoConnection isoConnection = IsoConnection_create(connectionSocket, self, isSingleThread);
 
         if (isoConnection) {
@@ -676,6 +918,14 @@ IsoServer_startListening(IsoServer self)
         self->openClientConnections = LinkedList_create();
 #endif
 
+#if (CONFIG_MMS_SERVER_EVENT_LOOP == 1)
+    /* TLS sockets can buffer received data - edge triggered events are not reliable */
+    self->useEventLoop = (self->tlsConfiguration == NULL);
+
+    if (self->useEventLoop)
+        startWorkers(self);
+#endif
+
     self->serverThread = Thread_create((ThreadExecutionFunction) isoServerThread, self, false);
 
     Thread_start(self->serverThread);
@@ -778,6 +1028,11 @@ IsoServer_stopListening(IsoServer self)
     if (self->serverThread != NULL)
         Thread_destroy(self->serverThread);
 
+#if (CONFIG_MMS_SERVER_EVENT_LOOP == 1)
+    /* workers close their connections before they terminate */
+    stopWorkers(self);
+#endif
+
     if (self->serverSocket != NULL) {
         ServerSocket_destroy((ServerSocket) self->serverSocket);
         self->serverSocket = NULL;
@@ -42,6 +42,14 @@
 
 #define SV_MAX_MESSAGE_SIZE 1518
 
+#ifndef CONFIG_ETHERNET_USE_PACKET_MMAP
+#define CONFIG_ETHERNET_USE_PACKET_MMAP 0
+#endif
+
+#ifndef CONFIG_ETHERNET_TX_RING_FRAME_COUNT
+#define CONFIG_ETHERNET_TX_RING_FRAME_COUNT 64
+#endif
+
 struct sSVPublisher_ASDU {
     const char* svID;
     const char* datset;
@@ -126,6 +134,11 @@ preparePacketBuffer(SVPublisher self, CommParameters* parameters, const char* in
         return false;
     }
 
+#if (CONFIG_ETHERNET_USE_PACKET_MMAP == 1)
+    if ((Ethernet_setupSendRing(self->ethernetSocket, CONFIG_ETHERNET_TX_RING_FRAME_COUNT) == false) && DEBUG_SV_PUBLISHER)
+        printf("SV_PUBLISHER: no send ring - use socket send\n");
+#endif
+
     self->buffer = (uint8_t*) GLOBAL_MALLOC(SV_MAX_MESSAGE_SIZE);
 
     if (self->buffer) {
@@ -31,9 +31,21 @@
 #include "hal_thread.h"
 #include "ber_decode.h"
 #include "ber_encoder.h"
+#include "rcu_snapshot.h"
 
 #include "sv_subscriber.h"
 
+#ifndef CONFIG_SV_USE_SIMD
+#define CONFIG_SV_USE_SIMD 1
+#endif
+
+#if (CONFIG_SV_USE_SIMD == 1) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SV_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define SV_X86_SIMD 0
+#endif
+
 #ifndef DEBUG_SV_SUBSCRIBER
 #define DEBUG_SV_SUBSCRIBER 1
 #endif
@@ -42,21 +54,72 @@
 
 #define ETH_P_SV 0x88ba
 
+#ifndef CONFIG_ETHERNET_RECEIVE_BATCH_SIZE
+#define CONFIG_ETHERNET_RECEIVE_BATCH_SIZE 32
+#endif
+
+#ifndef CONFIG_ETHERNET_USE_PACKET_MMAP
+#define CONFIG_ETHERNET_USE_PACKET_MMAP 0
+#endif
+
+#ifndef CONFIG_ETHERNET_RX_RING_BLOCK_SIZE
+#define CONFIG_ETHERNET_RX_RING_BLOCK_SIZE 65536
+#endif
+
+#ifndef CONFIG_ETHERNET_RX_RING_BLOCK_COUNT
+#define CONFIG_ETHERNET_RX_RING_BLOCK_COUNT 8
+#endif
+
+#ifndef CONFIG_ETHERNET_RX_RING_BLOCK_TIMEOUT
+#define CONFIG_ETHERNET_RX_RING_BLOCK_TIMEOUT 2
+#endif
+
+#ifndef CONFIG_ETHERNET_MAX_RECEIVE_WORKERS
+#define CONFIG_ETHERNET_MAX_RECEIVE_WORKERS 8
+#endif
+
+typedef struct sSVReceiverWorker* SVReceiverWorker;
+
+/* socket with its receive thread - worker 0 is also used by the threadless API */
+struct sSVReceiverWorker {
+    SVReceiver receiver;
+    int id; /* reader index of the subscriber array */
+    EthernetSocket ethSocket;
+    bool rxRing; /* frames are parsed in place in the receive ring of the socket */
+    bool stopped;
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    /* frames read by the worker thread with one call of Ethernet_receivePackets */
+    uint8_t* batchBuffer;
+    uint8_t* batchFrames[CONFIG_ETHERNET_RECEIVE_BATCH_SIZE];
+    int batchSizes[CONFIG_ETHERNET_RECEIVE_BATCH_SIZE];
+#endif
+};
+
 struct sSVReceiver {
     bool running;
-    bool stopped;
 
     bool checkDestAddr; /* option: check destination address (additionally to AppID) to identify application */
 
     char* interfaceId;
 
     uint8_t* buffer;
-    EthernetSocket ethSocket;
 
     LinkedList subscriberList;
 
+    /* NULL terminated array of the subscribers - read by the workers without lock */
+    RcuSnapshot subscribers;
+
+    struct sSVReceiverWorker workers[CONFIG_ETHERNET_MAX_RECEIVE_WORKERS];
+    int workerCount; /* number of workers with open socket */
+
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
-    Semaphore subscriberListLock;
+    Semaphore subscriberListLock; /* serializes changes of the subscriber list and the worker sockets */
+
+    /* parameters of SVReceiver_setWorkers */
+    int requestedWorkers;
+    EthernetFanoutMode fanoutMode;
+    int workerCpus[CONFIG_ETHERNET_MAX_RECEIVE_WORKERS];
 #endif
 
 };
@@ -93,12 +156,26 @@ SVReceiver_create(void)
 
     if (self != NULL) {
         self->subscriberList = LinkedList_create();
+        self->subscribers = RcuSnapshot_create(CONFIG_ETHERNET_MAX_RECEIVE_WORKERS);
         self->buffer = (uint8_t*) GLOBAL_MALLOC(ETH_BUFFER_LENGTH);
 
         self->checkDestAddr = false;
 
+        int i;
+
+        for (i = 0; i < CONFIG_ETHERNET_MAX_RECEIVE_WORKERS; i++) {
+            self->workers[i].receiver = self;
+            self->workers[i].id = i;
+            self->workers[i].stopped = true;
+        }
+
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
         self->subscriberListLock = Semaphore_create(1);
+        self->requestedWorkers = 1;
+        self->fanoutMode = ETHERNET_FANOUT_APPID;
+
+        for (i = 0; i < CONFIG_ETHERNET_MAX_RECEIVE_WORKERS; i++)
+            self->workerCpus[i] = -1;
 #endif
     }
 
@@ -126,6 +203,95 @@ SVReceiver_enableDestAddrCheck(SVReceiver self)
     self->checkDestAddr = true;
 }
 
+/* only pass frames with APPID (and destination address) of a subscriber to user space - call with subscriberListLock */
+static void
+setupFrameFilter(SVReceiver self, EthernetSocket ethSocket)
+{
+    int subscriberCount = LinkedList_size(self->subscriberList);
+
+    uint16_t* appIds = (uint16_t*) GLOBAL_MALLOC(sizeof(uint16_t) * (subscriberCount + 1));
+    uint8_t* addresses = (uint8_t*) GLOBAL_MALLOC(6 * (subscriberCount + 1));
+
+    int appIdCount = 0;
+    int addressCount = 0;
+
+    if (appIds && addresses) {
+        LinkedList element = LinkedList_getNext(self->subscriberList);
+
+        while (element) {
+            SVSubscriber subscriber = (SVSubscriber) LinkedList_getData(element);
+
+            int i;
+
+            for (i = 0; i < appIdCount; i++) {
+                if (appIds[i] == subscriber->appId)
+                    break;
+            }
+
+            if (i == appIdCount)
+                appIds[appIdCount++] = subscriber->appId;
+
+            for (i = 0; i < addressCount; i++) {
+                if (memcmp(addresses + (i * 6), subscriber->ethAddr, 6) == 0)
+                    break;
+            }
+
+            if (i == addressCount) {
+                memcpy(addresses + (addressCount * 6), subscriber->ethAddr, 6);
+                addressCount++;
+            }
+
+            element = LinkedList_getNext(element);
+        }
+    }
+
+    if (self->checkDestAddr == false)
+        addressCount = 0;
+
+    if (Ethernet_setFrameFilter(ethSocket, ETH_P_SV, (appIdCount > 0) ? appIds : NULL, appIdCount,
+            (addressCount > 0) ? addresses : NULL, addressCount) == false)
+    {
+        if (DEBUG_SV_SUBSCRIBER)
+            printf("SV_SUBSCRIBER: no APPID/DST-MAC filter - only ether type is filtered\n");
+    }
+
+    if (appIds)
+        GLOBAL_FREEMEM(appIds);
+
+    if (addresses)
+        GLOBAL_FREEMEM(addresses);
+}
+
+/* replace the subscriber array used by the receiver - call with subscriberListLock */
+static void
+publishSubscribers(SVReceiver self)
+{
+    int subscriberCount = LinkedList_size(self->subscriberList);
+
+    SVSubscriber* subscribers = (SVSubscriber*) RcuSnapshot_allocate(sizeof(SVSubscriber) * (subscriberCount + 1));
+
+    if (subscribers) {
+        int i = 0;
+
+        LinkedList element = LinkedList_getNext(self->subscriberList);
+
+        while (element) {
+            subscribers[i++] = (SVSubscriber) LinkedList_getData(element);
+
+            element = LinkedList_getNext(element);
+        }
+
+        subscribers[i] = NULL;
+    }
+    else {
+        /* never keep a removed subscriber in the old array */
+        if (DEBUG_SV_SUBSCRIBER)
+            printf("SV_SUBSCRIBER: no memory for subscriber array - messages are ignored\n");
+    }
+
+    RcuSnapshot_publish(self->subscribers, subscribers);
+}
+
 void
 SVReceiver_addSubscriber(SVReceiver self, SVSubscriber subscriber)
 {
@@ -135,11 +301,35 @@ SVReceiver_addSubscriber(SVReceiver self, SVSubscriber subscriber)
 
     LinkedList_add(self->subscriberList, (void*) subscriber);
 
+    publishSubscribers(self);
+
+    int i;
+
+    for (i = 0; i < self->workerCount; i++)
+        setupFrameFilter(self, self->workers[i].ethSocket);
+
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
     Semaphore_post(self->subscriberListLock);
 #endif
 }
 
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+/* wait until the worker threads passed a quiescent state - call without subscriberListLock */
+static void
+waitForWorkers(SVReceiver self, uint32_t epoch)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_ETHERNET_MAX_RECEIVE_WORKERS; i++) {
+        SVReceiverWorker worker = &(self->workers[i]);
+
+        /* with the threadless API the caller is the reader */
+        while ((worker->stopped == false) && (RcuSnapshot_hasReaderPassed(self->subscribers, worker->id, epoch) == false))
+            Thread_sleep(1);
+    }
+}
+#endif
+
 void
 SVReceiver_removeSubscriber(SVReceiver self, SVSubscriber subscriber)
 {
@@ -149,21 +339,113 @@ SVReceiver_removeSubscriber(SVReceiver self, SVSubscriber subscriber)
 
     LinkedList_remove(self->subscriberList, (void*) subscriber);
 
+    publishSubscribers(self);
+
+    int i;
+
+    for (i = 0; i < self->workerCount; i++)
+        setupFrameFilter(self, self->workers[i].ethSocket);
+
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
+    uint32_t epoch = RcuSnapshot_getEpoch(self->subscribers);
+
+    Semaphore_post(self->subscriberListLock);
+
+    /* a worker can still process a message for the subscriber with the old array */
+    waitForWorkers(self, epoch);
+
+    Semaphore_wait(self->subscriberListLock);
+    RcuSnapshot_reclaim(self->subscribers);
     Semaphore_post(self->subscriberListLock);
 #endif
 }
 
+static void
+parseSVMessage(SVReceiver self, uint8_t* buffer, int numbytes);
+
+static void
+handleFrame(void* parameter, uint8_t* frame, int frameSize)
+{
+    parseSVMessage((SVReceiver) parameter, frame, frameSize);
+}
+
+/* receive a single frame - the receive buffer of the receiver is only used by worker 0 */
+static bool
+receiveFrame(SVReceiverWorker worker)
+{
+    SVReceiver self = worker->receiver;
+
+    if (worker->rxRing)
+        return (Ethernet_receiveFrames(worker->ethSocket, handleFrame, self, 1) > 0);
+
+    int packetSize = Ethernet_receivePacket(worker->ethSocket, self->buffer, ETH_BUFFER_LENGTH);
+
+    if (packetSize > 0) {
+        parseSVMessage(self, self->buffer, packetSize);
+        return true;
+    }
+    else
+        return false;
+}
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+static void
+receiveFrameBatch(SVReceiverWorker worker)
+{
+    SVReceiver self = worker->receiver;
+
+    int received;
+
+    if (worker->rxRing) {
+        while (Ethernet_receiveFrames(worker->ethSocket, handleFrame, self, CONFIG_ETHERNET_RECEIVE_BATCH_SIZE)
+                == CONFIG_ETHERNET_RECEIVE_BATCH_SIZE);
+
+        return;
+    }
+
+    /* a full batch means that more frames may be queued */
+    do {
+        received = Ethernet_receivePackets(worker->ethSocket, worker->batchFrames, ETH_BUFFER_LENGTH,
+                worker->batchSizes, CONFIG_ETHERNET_RECEIVE_BATCH_SIZE);
+
+        int i;
+
+        for (i = 0; i < received; i++)
+            parseSVMessage(self, worker->batchFrames[i], worker->batchSizes[i]);
+    } while (received == CONFIG_ETHERNET_RECEIVE_BATCH_SIZE);
+}
+
+static bool
+allocateFrameBatch(SVReceiverWorker worker)
+{
+    if (worker->batchBuffer == NULL) {
+        worker->batchBuffer = (uint8_t*) GLOBAL_MALLOC(CONFIG_ETHERNET_RECEIVE_BATCH_SIZE * ETH_BUFFER_LENGTH);
+
+        if (worker->batchBuffer == NULL)
+            return false;
+
+        int i;
+
+        for (i = 0; i < CONFIG_ETHERNET_RECEIVE_BATCH_SIZE; i++)
+            worker->batchFrames[i] = worker->batchBuffer + (i * ETH_BUFFER_LENGTH);
+    }
+
+    return true;
+}
+#endif
+
 static void*
 svReceiverLoop(void* threadParameter)
 {
-    SVReceiver self = (SVReceiver) threadParameter;
-    EthernetHandleSet handleSet = EthernetHandleSet_new();
-    EthernetHandleSet_addSocket(handleSet, self->ethSocket);
+    SVReceiverWorker worker = (SVReceiverWorker) threadParameter;
+    SVReceiver self = worker->receiver;
 
-    self->stopped = false;
+    EthernetHandleSet handleSet = EthernetHandleSet_new();
+    EthernetHandleSet_addSocket(handleSet, worker->ethSocket);
 
     while (self->running) {
+            RcuSnapshot_quiescent(self->subscribers, worker->id);
+
             switch (EthernetHandleSet_waitReady(handleSet, 100))
             {
             case -1:
@@ -173,18 +455,143 @@ svReceiverLoop(void* threadParameter)
             case 0:
                 break;
             default:
-                SVReceiver_tick(self);
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+                if (worker->rxRing || worker->batchBuffer)
+                    receiveFrameBatch(worker);
+                else
+#endif
+                    receiveFrame(worker);
             }
 
     }
 
-    self->stopped = true;
-
     EthernetHandleSet_destroy(handleSet);
 
+    worker->stopped = true;
+
     return NULL;
 }
 
+/* open a socket for the messages of all subscribers */
+static bool
+openWorkerSocket(SVReceiverWorker worker)
+{
+    SVReceiver self = worker->receiver;
+
+    EthernetSocket ethSocket;
+
+    if (self->interfaceId == NULL)
+        ethSocket = Ethernet_createSocket(CONFIG_ETHERNET_INTERFACE_ID, NULL);
+    else
+        ethSocket = Ethernet_createSocket(self->interfaceId, NULL);
+
+    if (ethSocket == NULL)
+        return false;
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    Semaphore_wait(self->subscriberListLock);
+#endif
+
+    setupFrameFilter(self, ethSocket);
+
+    /* from now on the filter is updated by SVReceiver_addSubscriber/removeSubscriber */
+    worker->ethSocket = ethSocket;
+    worker->rxRing = false;
+    self->workerCount = worker->id + 1;
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    Semaphore_post(self->subscriberListLock);
+#endif
+
+#if (CONFIG_ETHERNET_USE_PACKET_MMAP == 1)
+    worker->rxRing = Ethernet_setupReceiveRing(ethSocket, CONFIG_ETHERNET_RX_RING_BLOCK_SIZE,
+            CONFIG_ETHERNET_RX_RING_BLOCK_COUNT, CONFIG_ETHERNET_RX_RING_BLOCK_TIMEOUT);
+
+    if ((worker->rxRing == false) && DEBUG_SV_SUBSCRIBER)
+        printf("SV_SUBSCRIBER: no receive ring - use socket receive\n");
+#endif
+
+    return true;
+}
+
+static void
+closeWorkerSocket(SVReceiverWorker worker)
+{
+    SVReceiver self = worker->receiver;
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    Semaphore_wait(self->subscriberListLock);
+#endif
+
+    self->workerCount = worker->id;
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    Semaphore_post(self->subscriberListLock);
+#endif
+
+    Ethernet_destroySocket(worker->ethSocket);
+
+    worker->ethSocket = NULL;
+    worker->rxRing = false;
+
+    RcuSnapshot_setReaderOnline(self->subscribers, worker->id, false);
+}
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+static void
+discardFrame(void* parameter, uint8_t* frame, int frameSize)
+{
+    (void) parameter;
+    (void) frame;
+    (void) frameSize;
+}
+
+/* open the sockets of the additional workers - a fanout group distributes the frames */
+static void
+openWorkerSockets(SVReceiver self)
+{
+    if (self->requestedWorkers < 2)
+        return;
+
+    int groupId = Ethernet_joinFanoutGroup(self->workers[0].ethSocket, -1, self->fanoutMode);
+
+    if (groupId == -1) {
+        if (DEBUG_SV_SUBSCRIBER)
+            printf("SV_SUBSCRIBER: no fanout group - use a single receive thread\n");
+
+        return;
+    }
+
+    int i;
+
+    for (i = 1; i < self->requestedWorkers; i++) {
+        SVReceiverWorker worker = &(self->workers[i]);
+
+        if (openWorkerSocket(worker) == false)
+            break;
+
+        /* only worker 0 can fall back to the receive buffer of the receiver */
+        if (((worker->rxRing == false) && (allocateFrameBatch(worker) == false)) ||
+                (Ethernet_joinFanoutGroup(worker->ethSocket, groupId, self->fanoutMode) == -1))
+        {
+            closeWorkerSocket(worker);
+            break;
+        }
+
+        /* frames queued before joining the group are also received by the other workers */
+        if (worker->rxRing)
+            while (Ethernet_receiveFrames(worker->ethSocket, discardFrame, NULL, CONFIG_ETHERNET_RECEIVE_BATCH_SIZE) > 0);
+        else
+            while (Ethernet_receivePacket(worker->ethSocket, worker->batchFrames[0], ETH_BUFFER_LENGTH) > 0);
+
+        RcuSnapshot_setReaderOnline(self->subscribers, worker->id, true);
+    }
+
+    if (DEBUG_SV_SUBSCRIBER)
+        printf("SV_SUBSCRIBER: %i receive threads in fanout group %i\n", self->workerCount, groupId);
+}
+#endif
+
 void
 SVReceiver_start(SVReceiver self)
 {
@@ -193,14 +600,40 @@ SVReceiver_start(SVReceiver self)
         if (DEBUG_SV_SUBSCRIBER)
             printf("SV_SUBSCRIBER: SV receiver started for interface %s\n", self->interfaceId);
 
-        Thread thread = Thread_create((ThreadExecutionFunction) svReceiverLoop, (void*) self, true);
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+        openWorkerSockets(self);
+#endif
+
+        int i;
 
-        if (thread) {
-            Thread_start(thread);
-        }
-        else {
-            if (DEBUG_SV_SUBSCRIBER)
-                printf("SV_SUBSCRIBER: Failed to start thread\n");
+        for (i = 0; i < self->workerCount; i++) {
+            SVReceiverWorker worker = &(self->workers[i]);
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+            if ((worker->rxRing == false) && (allocateFrameBatch(worker) == false)) {
+                if (DEBUG_SV_SUBSCRIBER)
+                    printf("SV_SUBSCRIBER: no memory for receive batch - receive single frames\n");
+            }
+#endif
+
+            Thread thread = Thread_create((ThreadExecutionFunction) svReceiverLoop, (void*) worker, true);
+
+            if (thread) {
+                worker->stopped = false;
+
+                Thread_start(thread);
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+                if ((self->workerCpus[i] != -1) && (Thread_setCpuAffinity(thread, self->workerCpus[i]) == false)) {
+                    if (DEBUG_SV_SUBSCRIBER)
+                        printf("SV_SUBSCRIBER: failed to bind receive thread to CPU %i\n", self->workerCpus[i]);
+                }
+#endif
+            }
+            else {
+                if (DEBUG_SV_SUBSCRIBER)
+                    printf("SV_SUBSCRIBER: Failed to start thread\n");
+            }
         }
     }
     else {
@@ -209,6 +642,29 @@ SVReceiver_start(SVReceiver self)
     }
 }
 
+void
+SVReceiver_setWorkers(SVReceiver self, int count, EthernetFanoutMode mode, const int* cpus)
+{
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+    if (count < 1)
+        count = 1;
+    else if (count > CONFIG_ETHERNET_MAX_RECEIVE_WORKERS)
+        count = CONFIG_ETHERNET_MAX_RECEIVE_WORKERS;
+
+    self->requestedWorkers = count;
+    self->fanoutMode = mode;
+
+    int i;
+
+    for (i = 0; i < CONFIG_ETHERNET_MAX_RECEIVE_WORKERS; i++) {
+        if (cpus && (i < count))
+            self->workerCpus[i] = cpus[i];
+        else
+            self->workerCpus[i] = -1;
+    }
+#endif
+}
+
 bool
 SVReceiver_isRunning(SVReceiver self)
 {
@@ -220,16 +676,25 @@ void
 SVReceiver_stop(SVReceiver self)
 {
     if (self->running) {
-        SVReceiver_stopThreadless(self);
+        self->running = false;
 
-        while (self->stopped == false)
-            Thread_sleep(1);
+        /* the receiver threads have to leave before the sockets are closed */
+        int i;
+
+        for (i = 0; i < self->workerCount; i++) {
+            while (self->workers[i].stopped == false)
+                Thread_sleep(1);
+        }
+
+        SVReceiver_stopThreadless(self);
     }
 }
 
 void
 SVReceiver_destroy(SVReceiver self)
 {
+    RcuSnapshot_destroy(self->subscribers);
+
     LinkedList_destroyDeep(self->subscriberList,
             (LinkedListValueDeleteFunction) SVSubscriber_destroy);
 
@@ -238,6 +703,13 @@ SVReceiver_destroy(SVReceiver self)
 
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
         Semaphore_destroy(self->subscriberListLock);
+
+        int i;
+
+        for (i = 0; i < CONFIG_ETHERNET_MAX_RECEIVE_WORKERS; i++) {
+            if (self->workers[i].batchBuffer)
+                GLOBAL_FREEMEM(self->workers[i].batchBuffer);
+        }
 #endif
 
     GLOBAL_FREEMEM(self->buffer);
@@ -247,26 +719,22 @@ SVReceiver_destroy(SVReceiver self)
 EthernetSocket
 SVReceiver_startThreadless(SVReceiver self)
 {
-    if (self->interfaceId == NULL)
-        self->ethSocket = Ethernet_createSocket(CONFIG_ETHERNET_INTERFACE_ID, NULL);
-    else
-        self->ethSocket = Ethernet_createSocket(self->interfaceId, NULL);
+    SVReceiverWorker worker = &(self->workers[0]);
 
-    if (self->ethSocket) {
-
-        Ethernet_setProtocolFilter(self->ethSocket, ETH_P_SV);
+    if (openWorkerSocket(worker)) {
+        RcuSnapshot_setReaderOnline(self->subscribers, worker->id, true);
 
         self->running = true;
     }
     
-    return self->ethSocket;
+    return worker->ethSocket;
 }
 
 void
 SVReceiver_stopThreadless(SVReceiver self)
 {
-    if (self->ethSocket)
-        Ethernet_destroySocket(self->ethSocket);
+    while (self->workerCount > 0)
+        closeWorkerSocket(&(self->workers[self->workerCount - 1]));
 
     self->running = false;
 }
@@ -459,10 +927,9 @@ exit_error:
 }
 
 static void
-parseSVMessage(SVReceiver self, int numbytes)
+parseSVMessage(SVReceiver self, uint8_t* buffer, int numbytes)
 {
     int bufPos;
-    uint8_t* buffer = self->buffer;
 
     if (numbytes < 22) return;
 
@@ -515,16 +982,12 @@ parseSVMessage(SVReceiver self, int numbytes)
 
     /* check if there is a matching subscriber */
 
-#if (CONFIG_MMS_THREADLESS_STACK == 0)
-    Semaphore_wait(self->subscriberListLock);
-#endif
-
     SVSubscriber subscriber = NULL;
 
-    LinkedList element = LinkedList_getNext(self->subscriberList);
+    SVSubscriber* subscribers = (SVSubscriber*) RcuSnapshot_get(self->subscribers);
 
-    while (element != NULL) {
-        SVSubscriber subscriberElem = (SVSubscriber) LinkedList_getData(element);
+    while (subscribers && *subscribers) {
+        SVSubscriber subscriberElem = *subscribers;
 
         if (subscriberElem->appId == appId) {
 
@@ -544,13 +1007,9 @@ parseSVMessage(SVReceiver self, int numbytes)
 
         }
 
-        element = LinkedList_getNext(element);
+        subscribers++;
     }
 
-#if (CONFIG_MMS_THREADLESS_STACK == 0)
-    Semaphore_post(self->subscriberListLock);
-#endif
-
     if (subscriber)
         parseSVPayload(self, subscriber, buffer + bufPos, apduLength);
     else {
@@ -562,14 +1021,9 @@ parseSVMessage(SVReceiver self, int numbytes)
 bool
 SVReceiver_tick(SVReceiver self)
 {
-    int packetSize = Ethernet_receivePacket(self->ethSocket, self->buffer, ETH_BUFFER_LENGTH);
+    RcuSnapshot_quiescent(self->subscribers, 0);
 
-    if (packetSize > 0) {
-        parseSVMessage(self, packetSize);
-        return true;
-    }
-    else
-        return false;
+    return receiveFrame(&(self->workers[0]));
 }
 
 SVSubscriber
@@ -915,6 +1369,157 @@ SVSubscriber_ASDU_getDataSize(SVSubscriber_ASDU self)
     return self->dataBufferLength;
 }
 
+/*
+ * Decode count channels of 8 byte (4 byte value + 4 byte quality, big endian) into
+ * native 32 bit values and qualities (qualities can be NULL).
+ */
+static void
+decodeChannelsScalar(const uint8_t* buffer, int count, uint8_t* values, Quality* qualities)
+{
+    int i;
+
+    for (i = 0; i < count; i++) {
+        const uint8_t* channel = buffer + (i * 8);
+
+        uint32_t value = ((uint32_t) channel[0] << 24) | ((uint32_t) channel[1] << 16) |
+                ((uint32_t) channel[2] << 8) | channel[3];
+
+        memcpy(values + (i * 4), &value, sizeof(uint32_t));
+
+        if (qualities)
+            qualities[i] = (Quality) ((channel[6] * 0x100) + channel[7]);
+    }
+}
+
+#if (SV_X86_SIMD == 1) && (ORDER_LITTLE_ENDIAN == 1)
+
+/* 16 byte = 2 channels -> byte swapped values in the lower 8 byte */
+#define SV_SHUFFLE_VALUES 3, 2, 1, 0, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1, -1, -1
+/* 16 byte = 2 channels -> byte swapped qualities in the lower 4 byte */
+#define SV_SHUFFLE_QUALITIES 7, 6, 15, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+
+__attribute__((target("ssse3"))) static int
+decodeChannelsSsse3(const uint8_t* buffer, int count, uint8_t* values, Quality* qualities)
+{
+    const __m128i shuffleValues = _mm_setr_epi8(SV_SHUFFLE_VALUES);
+    const __m128i shuffleQualities = _mm_setr_epi8(SV_SHUFFLE_QUALITIES);
+
+    int i;
+
+    /* 4 channels per iteration */
+    for (i = 0; i + 4 <= count; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*) (buffer + (i * 8)));
+        __m128i b = _mm_loadu_si128((const __m128i*) (buffer + (i * 8) + 16));
+
+        __m128i v = _mm_unpacklo_epi64(_mm_shuffle_epi8(a, shuffleValues), _mm_shuffle_epi8(b, shuffleValues));
+
+        _mm_storeu_si128((__m128i*) (values + (i * 4)), v);
+
+        if (qualities) {
+            __m128i q = _mm_unpacklo_epi32(_mm_shuffle_epi8(a, shuffleQualities), _mm_shuffle_epi8(b, shuffleQualities));
+
+            _mm_storel_epi64((__m128i*) (qualities + i), q);
+        }
+    }
+
+    return i;
+}
+
+__attribute__((target("avx2"))) static int
+decodeChannelsAvx2(const uint8_t* buffer, int count, uint8_t* values, Quality* qualities)
+{
+    /* the shuffle works within the 128 bit lanes, each lane holds 2 channels */
+    const __m256i shuffleValues = _mm256_setr_epi8(SV_SHUFFLE_VALUES, SV_SHUFFLE_VALUES);
+    const __m256i shuffleQualities = _mm256_setr_epi8(SV_SHUFFLE_QUALITIES, SV_SHUFFLE_QUALITIES);
+    const __m256i qualityOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    int i;
+
+    /* 8 channels per iteration */
+    for (i = 0; i + 8 <= count; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*) (buffer + (i * 8)));
+        __m256i b = _mm256_loadu_si256((const __m256i*) (buffer + (i * 8) + 32));
+
+        /* lanes: [v0 v1 v4 v5 | v2 v3 v6 v7] */
+        __m256i v = _mm256_unpacklo_epi64(_mm256_shuffle_epi8(a, shuffleValues), _mm256_shuffle_epi8(b, shuffleValues));
+
+        _mm256_storeu_si256((__m256i*) (values + (i * 4)), _mm256_permute4x64_epi64(v, 0xd8));
+
+        if (qualities) {
+            /* lanes: [q01 q45 - - | q23 q67 - -] */
+            __m256i q = _mm256_unpacklo_epi32(_mm256_shuffle_epi8(a, shuffleQualities), _mm256_shuffle_epi8(b, shuffleQualities));
+
+            q = _mm256_permutevar8x32_epi32(q, qualityOrder);
+
+            _mm_storeu_si128((__m128i*) (qualities + i), _mm256_castsi256_si128(q));
+        }
+    }
+
+    return i;
+}
+
+typedef int (*DecodeChannelsFunction)(const uint8_t* buffer, int count, uint8_t* values, Quality* qualities);
+
+static DecodeChannelsFunction
+getDecodeChannelsFunction(void)
+{
+    static DecodeChannelsFunction decodeChannels = NULL;
+
+    if (decodeChannels == NULL) {
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2"))
+            decodeChannels = decodeChannelsAvx2;
+        else if (__builtin_cpu_supports("ssse3"))
+            decodeChannels = decodeChannelsSsse3;
+    }
+
+    return decodeChannels;
+}
+
+#endif /* (SV_X86_SIMD == 1) && (ORDER_LITTLE_ENDIAN == 1) */
+
+static int
+decodeChannels(SVSubscriber_ASDU self, int index, uint8_t* values, Quality* qualities, int maxCount)
+{
+    if ((index < 0) || (index > self->dataBufferLength) || (maxCount < 1))
+        return 0;
+
+    int count = (self->dataBufferLength - index) / 8;
+
+    if (count > maxCount)
+        count = maxCount;
+
+    const uint8_t* buffer = self->dataBuffer + index;
+
+    int decoded = 0;
+
+#if (SV_X86_SIMD == 1) && (ORDER_LITTLE_ENDIAN == 1)
+    DecodeChannelsFunction decodeChannelsSimd = getDecodeChannelsFunction();
+
+    if (decodeChannelsSimd)
+        decoded = decodeChannelsSimd(buffer, count, values, qualities);
+#endif
+
+    /* remaining channels */
+    decodeChannelsScalar(buffer + (decoded * 8), count - decoded, values + (decoded * 4),
+            qualities ? (qualities + decoded) : NULL);
+
+    return count;
+}
+
+int
+SVSubscriber_ASDU_getINT32Channels(SVSubscriber_ASDU self, int index, int32_t* values, Quality* qualities, int maxCount)
+{
+    return decodeChannels(self, index, (uint8_t*) values, qualities, maxCount);
+}
+
+int
+SVSubscriber_ASDU_getFLOAT32Channels(SVSubscriber_ASDU self, int index, float* values, Quality* qualities, int maxCount)
+{
+    return decodeChannels(self, index, (uint8_t*) values, qualities, maxCount);
+}
+
 uint16_t
 SVClientASDU_getSmpCnt(SVSubscriber_ASDU self)
 {
@@ -180,6 +180,11 @@ SVReceiver_addSubscriber(SVReceiver self, SVSubscriber subscriber);
 /**
  * \brief Disconnect subscriber and receiver
  *
+ * The function can be called while the receiver is running. It waits until the receive threads
+ * finished the messages they are processing, so the subscriber can be destroyed when the function
+ * returns. It must not be called from a listener. With the threadless API it has to be called by
+ * the thread that receives the messages.
+ *
  * \param self the receiver instance reference
  * \param subscriber the subscriber instance to disconnect
  */
@@ -196,6 +201,25 @@ SVReceiver_removeSubscriber(SVReceiver self, SVSubscriber subscriber);
 LIB61850_API void
 SVReceiver_start(SVReceiver self);
 
+/**
+ * \brief Use multiple receive threads (workers), each with its own socket
+ *
+ * The frames are distributed over the sockets by the kernel (Linux PACKET_FANOUT). With
+ * \ref ETHERNET_FANOUT_APPID all messages with the same APPID are handled by the same worker,
+ * so the samples of a stream are reported in order. Listeners of different subscribers can be
+ * called concurrently.
+ *
+ * When the platform does not support fanout groups a single worker is used.
+ * NOTE: This function has to be called before calling SVReceiver_start.
+ *
+ * \param self the receiver instance reference
+ * \param count number of workers (1 to CONFIG_ETHERNET_MAX_RECEIVE_WORKERS)
+ * \param mode how the frames are distributed over the workers
+ * \param cpus CPU for each worker thread or NULL (the value -1 means no CPU affinity)
+ */
+LIB61850_API void
+SVReceiver_setWorkers(SVReceiver self, int count, EthernetFanoutMode mode, const int* cpus);
+
 /**
  * \brief Receiver stops listening for SV messages
  *
@@ -539,6 +563,40 @@ SVSubscriber_ASDU_getQuality(SVSubscriber_ASDU self, int index);
 LIB61850_API int
 SVSubscriber_ASDU_getDataSize(SVSubscriber_ASDU self);
 
+/**
+ * \brief Get the values and qualities of consecutive INT32 channels in the data part of the ASDU
+ *
+ * Decodes channels made of an INT32 value followed by a quality (8 byte per channel, as used
+ * by IEC 61850-9-2LE) with a single bounds check. On x86 the decoding uses SSSE3 or AVX2
+ * when supported by the CPU.
+ *
+ * \param self ASDU object instance
+ * \param index the index (byte position of the start) of the first channel in the data part
+ * \param values array for the values of at least maxCount elements
+ * \param qualities array for the qualities of at least maxCount elements (can be NULL)
+ * \param maxCount the maximum number of channels to decode
+ *
+ * \return the number of decoded channels
+ */
+LIB61850_API int
+SVSubscriber_ASDU_getINT32Channels(SVSubscriber_ASDU self, int index, int32_t* values, Quality* qualities, int maxCount);
+
+/**
+ * \brief Get the values and qualities of consecutive FLOAT32 channels in the data part of the ASDU
+ *
+ * Same as SVSubscriber_ASDU_getINT32Channels for channels made of a FLOAT32 value followed by a quality.
+ *
+ * \param self ASDU object instance
+ * \param index the index (byte position of the start) of the first channel in the data part
+ * \param values array for the values of at least maxCount elements
+ * \param qualities array for the qualities of at least maxCount elements (can be NULL)
+ * \param maxCount the maximum number of channels to decode
+ *
+ * \return the number of decoded channels
+ */
+LIB61850_API int
+SVSubscriber_ASDU_getFLOAT32Channels(SVSubscriber_ASDU self, int index, float* values, Quality* qualities, int maxCount);
+
 /**
  * \brief return the SmpSynch value included in the SV ASDU
  *